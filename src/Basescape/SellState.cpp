@@ -150,7 +150,7 @@ SellState::SellState(Game *game, Base *base) : State(game), _base(base), _qtys()
 	}
 	for (std::vector<Craft*>::iterator i = _base->getCrafts()->begin(); i != _base->getCrafts()->end(); ++i)
 	{
-		if ((*i)->getStatus() != "STR_OUT")
+		if ((*i)->getStatus() != Craft::STATUS_OUT)
 		{
 			_qtys.push_back(0);
 			_crafts.push_back(*i);
@@ -254,7 +254,7 @@ void SellState::btnOkClick(Action *)
 				}
 
 				// Remove items from craft
-				for (std::map<std::string, int>::iterator it = craft->getItems()->getContents()->begin(); it != craft->getItems()->getContents()->end(); ++it)
+				for (ItemContainer::Contents::iterator it = craft->getItems()->getContents()->begin(); it != craft->getItems()->getContents()->end(); ++it)
 				{
 					_base->getItems()->addItem(it->first, it->second);
 				}
@@ -143,7 +143,7 @@ TransferItemsState::TransferItemsState(Game *game, Base *baseFrom, Base *baseTo)
 	}
 	for (std::vector<Craft*>::iterator i = _baseFrom->getCrafts()->begin(); i != _baseFrom->getCrafts()->end(); ++i)
 	{
-		if ((*i)->getStatus() != "STR_OUT" || (_canTransferCraftsWhileAirborne && (*i)->getFuel() >= (*i)->getFuelLimit(_baseTo)))
+		if ((*i)->getStatus() != Craft::STATUS_OUT || (_canTransferCraftsWhileAirborne && (*i)->getFuel() >= (*i)->getFuelLimit(_baseTo)))
 		{
 			_qtys.push_back(0);
 			_crafts.push_back(*i);
@@ -269,7 +269,7 @@ void TransferItemsState::completeTransfer()
 					if ((*s)->getCraft() == craft)
 					{
 						if ((*s)->isInPsiTraining()) (*s)->setPsiTraining();
-						if (craft->getStatus() == "STR_OUT") _baseTo->getSoldiers()->push_back(*s);
+						if (craft->getStatus() == Craft::STATUS_OUT) _baseTo->getSoldiers()->push_back(*s);
 						else
 						{
 							Transfer *t = new Transfer(time);
@@ -289,7 +289,7 @@ void TransferItemsState::completeTransfer()
 				{
 					if (*c == craft)
 					{
-						if (craft->getStatus() == "STR_OUT")
+						if (craft->getStatus() == Craft::STATUS_OUT)
 						{
 							bool returning = (craft->getDestination() == (Target*)craft->getBase());
 							_baseTo->getCrafts()->push_back(craft);
@@ -583,7 +583,7 @@ void TransferItemsState::increaseByValue(int change)
 		_cQty++;
 		_pQty += craft->getNumSoldiers();
 		_qtys[_sel]++;
-		if (!_canTransferCraftsWhileAirborne || craft->getStatus() != "STR_OUT") _total += getCost();
+		if (!_canTransferCraftsWhileAirborne || craft->getStatus() != Craft::STATUS_OUT) _total += getCost();
 	}
 	// Item count
 	else if (_sel >= _soldiers.size() + _crafts.size() + _sOffset + _eOffset && _sel < _soldiers.size() + _crafts.size() + _sOffset + _eOffset + _aOffset)
@@ -648,7 +648,7 @@ void TransferItemsState::decreaseByValue(int change)
 	else if (_sel >= _soldiers.size() + _crafts.size() + _sOffset + _eOffset + _aOffset)
 		_aQty -= change;
 	_qtys[_sel] -= change;
-	if (!_canTransferCraftsWhileAirborne || 0 == craft || craft->getStatus() != "STR_OUT")
+	if (!_canTransferCraftsWhileAirborne || 0 == craft || craft->getStatus() != Craft::STATUS_OUT)
 		_total -= getCost() * change;
 	updateItemStrings();
 }
@@ -649,7 +649,30 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 		if (tu < 0) tu = 0;
 	}
 
-	std::vector<int> reachable = _game->getPathfinding()->findReachable(_unit, tu);
+	_game->getPathfinding()->findReachable(_unit, tu);
+
+	// the systematic part of the search below always looks at the same tiles, so survey
+	// the reachable ones all at once on the worker threads and let the search find them done
+	std::vector<Tile*> candidates;
+	Position searchOrigin = _unit->getPosition() + runOffset;
+	if (!_game->getTile(searchOrigin))
+	{
+		searchOrigin = _unit->getPosition();
+	}
+	if ((tile = _game->getTile(_unit->lastCover)) && _game->getPathfinding()->getReachableCost(_unit, tile->getPosition()) != -1)
+	{
+		candidates.push_back(tile);
+	}
+	for (int i = civ ? 9 : 0; i < 121; i += civ ? 10 : 1)
+	{
+		Position pos = searchOrigin + Position(_randomTileSearch[i].x, _randomTileSearch[i].y, 0);
+		if (pos != _unit->getPosition() && (tile = _game->getTile(pos)) && _game->getPathfinding()->getReachableCost(_unit, pos) != -1)
+		{
+			candidates.push_back(tile);
+		}
+	}
+	_game->getTileEngine()->surveyXComThreatToTiles(candidates, _unit);
+	tile = 0;
 
 	while (tries < 150 && !coverFound)
 	{
@@ -725,37 +748,37 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 		}
 		else
 		{
-			if (std::find(reachable.begin(), reachable.end(), _game->getTileIndex(tile->getPosition()))  == reachable.end()) continue; // just ignore unreachable tiles
+			if (_game->getPathfinding()->getReachableCost(_unit, tile->getPosition()) == -1) continue; // just ignore unreachable tiles
 
 			_game->getTileEngine()->surveyXComThreatToTile(tile, action->target, _unit);
 						
-			if (tile->soldiersVisible == Tile::NOT_CALCULATED) continue; // you can't go there.
+			if (tile->getThreat()->soldiersVisible == Tile::NOT_CALCULATED) continue; // you can't go there.
 						
-			if (tile->soldiersVisible && tile->closestSoldierDSqr <= SOLDIER_PROXIMITY_BASE_PENALTY && tile->closestSoldierDSqr > 0) 
+			if (tile->getThreat()->soldiersVisible && tile->getThreat()->closestSoldierDSqr <= SOLDIER_PROXIMITY_BASE_PENALTY && tile->getThreat()->closestSoldierDSqr > 0) 
 			{
-				score -= (SOLDIER_PROXIMITY_BASE_PENALTY/tile->closestSoldierDSqr);
+				score -= (SOLDIER_PROXIMITY_BASE_PENALTY/tile->getThreat()->closestSoldierDSqr);
 			}
 						
-			if (tile->soldiersVisible && tile->meanSoldierDSqr <= (SOLDIER_PROXIMITY_BASE_PENALTY/2) && tile->meanSoldierDSqr > 0) 
+			if (tile->getThreat()->soldiersVisible && tile->getThreat()->meanSoldierDSqr <= (SOLDIER_PROXIMITY_BASE_PENALTY/2) && tile->getThreat()->meanSoldierDSqr > 0) 
 			{
-				score -= ((SOLDIER_PROXIMITY_BASE_PENALTY/2)/tile->meanSoldierDSqr); // less important than above
+				score -= ((SOLDIER_PROXIMITY_BASE_PENALTY/2)/tile->getThreat()->meanSoldierDSqr); // less important than above
 			}
 
 			//score += (dist-_game->getTileEngine()->distance(_aggroTarget->getPosition(), action->target)); // get away from aggrotarget, modest priority
 						
-			if (!tile->soldiersVisible)
+			if (!tile->getThreat()->soldiersVisible)
 			{
 				// yay.
 			} else
 			{						
-				// score -= tile->soldiersVisible * EXPOSURE_PENALTY;
+				// score -= tile->getThreat()->soldiersVisible * EXPOSURE_PENALTY;
 				score -= EXPOSURE_PENALTY; // that's for giving away our position
-				score -= tile->totalExposure / (100 / EXPOSURE_PENALTY); // this is for how easy it'd be to shoot at us
+				score -= tile->getThreat()->totalExposure / (100 / EXPOSURE_PENALTY); // this is for how easy it'd be to shoot at us
 			}
 						
 			// strength in numbers but not in "grenade us!" huddles:
-			if (tile->closestAlienDSqr < MAX_ALLY_DISTANCE && tile->closestAlienDSqr > MIN_ALLY_DISTANCE) score += ALLY_BONUS;
-			if (tile->closestAlienDSqr <= MIN_ALLY_DISTANCE) score -= ALLY_BONUS;
+			if (tile->getThreat()->closestAlienDSqr < MAX_ALLY_DISTANCE && tile->getThreat()->closestAlienDSqr > MIN_ALLY_DISTANCE) score += ALLY_BONUS;
+			if (tile->getThreat()->closestAlienDSqr <= MIN_ALLY_DISTANCE) score -= ALLY_BONUS;
 										
 			if (tile->getFire()) score -= FIRE_PENALTY; // maybe stop, drop, and roll?
 						
@@ -770,11 +793,11 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 
 		if (tile && score > bestTileScore)
 		{
-			// calculate TUs to tile; we could be getting this from findReachable() somehow but that would break something for sure...
+			// calculate TUs to tile; this comes straight from findReachable() above
 			_game->getPathfinding()->calculate(_unit, action->target);
 			int TUBonus = (_unit->getTimeUnits() - (_game->getPathfinding()->getTotalTUCost()+4));
 			TUBonus = TUBonus > (EXPOSURE_PENALTY - 1) ? (EXPOSURE_PENALTY - 1) : TUBonus;
-			if (tile->soldiersVisible == 0 && action->number > 2) score += TUBonus;
+			if (tile->getThreat()->soldiersVisible == 0 && action->number > 2) score += TUBonus;
 			if (score > bestTileScore && _game->getPathfinding()->getStartDirection() != -1)
 			{
 				bestTileScore = score;
@@ -789,7 +812,7 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 	_unit->lastCover = bestTile;
 	if (_traceAI)
 	{
-		Log(LOG_INFO) << _unit->getId() << " Taking cover with score " << bestTileScore << " after " << tries << " tries, with total exposure " << ((tile=_game->getTile(bestTile)) ? tile->totalExposure : -9999) << ", " << _game->getTileEngine()->distance(_unit->getPosition(), bestTile) << " squares or so away. Time: " << (SDL_GetTicks() - start) << " Action #" << action->number;
+		Log(LOG_INFO) << _unit->getId() << " Taking cover with score " << bestTileScore << " after " << tries << " tries, with total exposure " << ((tile=_game->getTile(bestTile)) ? tile->getThreat()->totalExposure : -9999) << ", " << _game->getTileEngine()->distance(_unit->getPosition(), bestTile) << " squares or so away. Time: " << (SDL_GetTicks() - start) << " Action #" << action->number;
 		// Log(LOG_INFO) << "Walking " << _game->getTileEngine()->distance(_unit->getPosition(), bestTile) << " squares or so.";
 		_game->getTile(action->target)->setMarkerColor(13);
 	}
@@ -197,6 +197,9 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		}
 	}
 
+	_save->getPathfinding()->resetReachable(); // units have moved since the last one thought
+	_save->getTileEngine()->updateXComThreat();
+
     _save->getTileEngine()->calculateFOV(unit); // might need this populate _visibleUnit for a newly-created alien
         // it might also help chryssalids realize they've zombified someone and need to move on
         // it's also for good luck
@@ -216,7 +219,7 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 	if(_AIActionCounter == 1)
 	{
 		unit->_hidingForTurn = 0;
-		if (Options::getBool("traceAI")) { Log(LOG_INFO) << "#" << unit->getId() << "--" << unit->getType(); }
+		if (_save->getTraceSetting()) { Log(LOG_INFO) << "#" << unit->getId() << "--" << unit->getType(); }
 	}
 	AggroBAIState *aggro = dynamic_cast<AggroBAIState*>(ai); // this cast only works when ai was already AggroBAIState at heart
 	
@@ -283,16 +286,16 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 
         if (unit->_hidingForTurn && _AIActionCounter > 2)
         {
-            if (_save->getTile(action.target) && _save->getTile(action.target)->soldiersVisible > 0)
+            if (_save->getTile(action.target) && _save->getTile(action.target)->getThreat()->soldiersVisible > 0)
             {
-                finalFacing = _save->getTile(action.target)->closestSoldierPos; // be ready for the nearest spotting unit for our destination
+                finalFacing = _save->getTile(action.target)->getThreat()->closestSoldierPos; // be ready for the nearest spotting unit for our destination
                 usePathfinding = false;
-				if (Options::getBool("traceAI")) { Log(LOG_INFO) << "setting final facing direction for closest soldier, " << finalFacing.x << "," << finalFacing.y << "," << finalFacing.z; }
+				if (_save->getTraceSetting()) { Log(LOG_INFO) << "setting final facing direction for closest soldier, " << finalFacing.x << "," << finalFacing.y << "," << finalFacing.z; }
             } else if (aggro != 0)
             {
                 finalFacing = aggro->getLastKnownPosition(); // or else be ready for our aggro target
                 usePathfinding = true;
-				if (Options::getBool("traceAI")) { Log(LOG_INFO) << "setting final facing direction for aggro target via pathfinding, " << finalFacing.x << "," << finalFacing.y << "," << finalFacing.z; }
+				if (_save->getTraceSetting()) { Log(LOG_INFO) << "setting final facing direction for aggro target via pathfinding, " << finalFacing.x << "," << finalFacing.y << "," << finalFacing.z; }
             }
         }
 
@@ -847,7 +850,7 @@ void BattlescapeGame::statePushBack(BattleState *bs)
  */
 void BattlescapeGame::popState()
 {
-	if (Options::getBool("traceAI"))
+	if (_save->getTraceSetting())
 	{
 		Log(LOG_INFO) << "BattlescapeGame::popState() #" << _AIActionCounter << " with " << (_save->getSelectedUnit() ? _save->getSelectedUnit()->getTimeUnits() : -9999) << " TU";
 	}
@@ -1078,12 +1081,12 @@ bool BattlescapeGame::handlePanickingUnit(BattleUnit *unit)
 	case STATUS_PANICKING: // 1/2 chance to freeze and 1/2 chance try to flee
 		if (flee <= 50)
 		{
-			BattleItem *item = unit->getItem("STR_RIGHT_HAND");
+			BattleItem *item = unit->getItem(RuleInventory::RIGHT_HAND);
 			if (item)
 			{
 				dropItem(unit->getPosition(), item, false, true);
 			}
-			item = unit->getItem("STR_LEFT_HAND");
+			item = unit->getItem(RuleInventory::LEFT_HAND);
 			if (item)
 			{
 				dropItem(unit->getPosition(), item, false, true);
@@ -1622,16 +1625,15 @@ void BattlescapeGame::resetSituationForAI()
 
     // Log(LOG_INFO) << w*h*l << " tiles!";
 
-	if (Options::getBool("traceAI"))
+	if (_save->getTraceSetting())
 	{
-		for (int i = 0; i < w * l * h; ++i) if (tiles[i]->soldiersVisible != -1) { tiles[i]->setMarkerColor(0); } // clear old tile markers
+		for (int i = 0; i < w * l * h; ++i) if (tiles[i]->getThreat()->soldiersVisible != -1) { tiles[i]->setMarkerColor(0); } // clear old tile markers
 	}
 
-    for (int i = 0; i < w * l * h; ++i)
-    {
-		tiles[i]->soldiersVisible = Tile::NOT_CALCULATED;    // -1 for "not calculated"; actual calculations will take place as needed
-		tiles[i]->closestSoldierDSqr = Tile::NOT_CALCULATED; // for most of the tiles most of the time, this data is not needed
-    }
+	// -1 for "not calculated"; actual calculations will take place as needed
+	// for most of the tiles most of the time, this data is not needed
+	// during the turn, the threat field is only updated where units moved (see TileEngine::updateXComThreat)
+	_save->getTileEngine()->resetXComThreat();
 
 }
 
@@ -1686,7 +1688,7 @@ BattleItem *BattlescapeGame::surveyItems(BattleAction *action)
 	// first fill a vector with items on the ground that were dropped on the alien turn, and have an attraction value.
 	for (std::vector<BattleItem*>::iterator i = _save->getItems()->begin(); i != _save->getItems()->end(); ++i)
 	{
-		if ((*i)->getSlot() && (*i)->getSlot()->getId() == "STR_GROUND" && (*i)->getTile() && (*i)->getTurnFlag() && (*i)->getRules()->getAttraction())
+		if ((*i)->getSlot() && (*i)->getSlot()->getId() == RuleInventory::GROUND && (*i)->getTile() && (*i)->getTurnFlag() && (*i)->getRules()->getAttraction())
 		{
 			droppedItems.push_back(*i);
 		}
@@ -1873,9 +1875,9 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 	{
 	case BT_AMMO:
 		// find equipped weapons that can be loaded with this ammo
-		if (action->actor->getItem("STR_RIGHT_HAND") && action->actor->getItem("STR_RIGHT_HAND")->getAmmoItem() == 0)
+		if (action->actor->getItem(RuleInventory::RIGHT_HAND) && action->actor->getItem(RuleInventory::RIGHT_HAND)->getAmmoItem() == 0)
 		{
-			if (action->actor->getItem("STR_RIGHT_HAND")->setAmmoItem(item) == 0)
+			if (action->actor->getItem(RuleInventory::RIGHT_HAND)->setAmmoItem(item) == 0)
 			{
 				placed = true;
 			}
@@ -1884,7 +1886,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 		{
 			for (int i = 0; i != 4; ++i)
 			{
-				if (!action->actor->getItem("STR_BELT", i))
+				if (!action->actor->getItem(RuleInventory::BELT, i))
 				{
 					item->moveToOwner(action->actor);
 					item->setSlot(rules->getInventory("STR_BELT"));
@@ -1899,7 +1901,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 	case BT_PROXIMITYGRENADE:
 		for (int i = 0; i != 4; ++i)
 		{
-			if (!action->actor->getItem("STR_BELT", i))
+			if (!action->actor->getItem(RuleInventory::BELT, i))
 			{
 				item->moveToOwner(action->actor);
 				item->setSlot(rules->getInventory("STR_BELT"));
@@ -1911,7 +1913,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 		break;
 	case BT_FIREARM:
 	case BT_MELEE:
-		if (!action->actor->getItem("STR_RIGHT_HAND"))
+		if (!action->actor->getItem(RuleInventory::RIGHT_HAND))
 		{
 			item->moveToOwner(action->actor);
 			item->setSlot(rules->getInventory("STR_RIGHT_HAND"));
@@ -1920,7 +1922,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 		break;
 	case BT_MEDIKIT:
 	case BT_SCANNER:
-		if (!action->actor->getItem("STR_BACK_PACK"))
+		if (!action->actor->getItem(RuleInventory::BACK_PACK))
 		{
 			item->moveToOwner(action->actor);
 			item->setSlot(rules->getInventory("STR_BACK_PACK"));
@@ -1928,7 +1930,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 		}
 		break;
 	case BT_MINDPROBE:
-		if (!action->actor->getItem("STR_LEFT_HAND"))
+		if (!action->actor->getItem(RuleInventory::LEFT_HAND))
 		{
 			item->moveToOwner(action->actor);
 			item->setSlot(rules->getInventory("STR_LEFT_HAND"));
@@ -47,6 +47,7 @@
 #include "../Ruleset/AlienRace.h"
 #include "../Ruleset/AlienDeployment.h"
 #include "../Ruleset/RuleBaseFacility.h"
+#include "../Ruleset/RuleInventory.h"
 #include "../Resource/XcomResourcePack.h"
 #include "../Engine/Game.h"
 #include "../Engine/Language.h"
@@ -384,7 +385,7 @@ void BattlescapeGenerator::run()
 		for (std::vector<Soldier*>::iterator i = _base->getSoldiers()->begin(); i != _base->getSoldiers()->end(); ++i)
 		{
 			if ((_craft != 0 && (*i)->getCraft() == _craft) ||
-				(_craft == 0 && (*i)->getWoundRecovery() == 0 && ((*i)->getCraft() == 0 || (*i)->getCraft()->getStatus() != "STR_OUT")))
+				(_craft == 0 && (*i)->getWoundRecovery() == 0 && ((*i)->getCraft() == 0 || (*i)->getCraft()->getStatus() != Craft::STATUS_OUT)))
 			{
 				unit = addXCOMUnit(new BattleUnit(*i, FACTION_PLAYER));
 				if (!_save->getSelectedUnit())
@@ -406,11 +407,12 @@ void BattlescapeGenerator::run()
 		if (_craft != 0)
 		{
 			// add items that are in the craft
-			for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+			std::vector<Atom> items = _craft->getItems()->getSortedItems();
+			for (std::vector<Atom>::iterator i = items.begin(); i != items.end(); ++i)
 			{
-				for (int count=0; count < i->second; count++)
+				for (int count=0; count < _craft->getItems()->getItem(*i); count++)
 				{
-					_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()),
+					_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(*i), _save->getCurrentItemId()),
 						_game->getRuleset()->getInventory("STR_GROUND"));
 				}
 			}
@@ -418,36 +420,33 @@ void BattlescapeGenerator::run()
 		else
 		{
 			// add items that are in the base
-			for (std::map<std::string, int>::iterator i = _base->getItems()->getContents()->begin(); i != _base->getItems()->getContents()->end();)
+			std::vector<Atom> items = _base->getItems()->getSortedItems();
+			for (std::vector<Atom>::iterator i = items.begin(); i != items.end(); ++i)
 			{
 				// only put items in the battlescape that make sense (when the item got a sprite, it's probably ok)
-				RuleItem *rule = _game->getRuleset()->getItem(i->first);
+				RuleItem *rule = _game->getRuleset()->getItem(*i);
 				if (rule->getBigSprite() > -1 && rule->getBattleType() != BT_NONE && rule->getBattleType() != BT_CORPSE && !rule->isFixed() && _game->getSavedGame()->isResearched(rule->getRequirements()))
 				{
-					for (int count=0; count < i->second; count++)
+					int qty = _base->getItems()->getItem(*i);
+					for (int count=0; count < qty; count++)
 					{
-						_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()),
+						_craftInventoryTile->addItem(new BattleItem(rule, _save->getCurrentItemId()),
 							_game->getRuleset()->getInventory("STR_GROUND"));
 					}
-					std::map<std::string, int>::iterator tmp = i;
-					++i;
-					_base->getItems()->removeItem(tmp->first, tmp->second);
-				}
-				else
-				{
-					++i;
+					_base->getItems()->removeItem(*i, qty);
 				}
 			}
 			// add items from crafts in base
 			for (std::vector<Craft*>::iterator c = _base->getCrafts()->begin(); c != _base->getCrafts()->end(); ++c)
 			{
-				if ((*c)->getStatus() == "STR_OUT")
+				if ((*c)->getStatus() == Craft::STATUS_OUT)
 					continue;
-				for (std::map<std::string, int>::iterator i = (*c)->getItems()->getContents()->begin(); i != (*c)->getItems()->getContents()->end(); ++i)
+				std::vector<Atom> craftItems = (*c)->getItems()->getSortedItems();
+				for (std::vector<Atom>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 				{
-					for (int count=0; count < i->second; count++)
+					for (int count=0; count < (*c)->getItems()->getItem(*i); count++)
 					{
-						_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()),
+						_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(*i), _save->getCurrentItemId()),
 							_game->getRuleset()->getInventory("STR_GROUND"));
 					}
 				}
@@ -840,7 +839,7 @@ BattleItem* BattlescapeGenerator::addItem(BattleItem *item, bool secondPass)
 						{
 							if (*it == item->getRules()->getType())
 							{
-								if (!(*bu)->getItem("STR_BELT", 1) && item->getRules()->getInventoryHeight() == 1)
+								if (!(*bu)->getItem(RuleInventory::BELT, 1) && item->getRules()->getInventoryHeight() == 1)
 								{
 									item->moveToOwner((*bu));
 									item->setSlot(_game->getRuleset()->getInventory("STR_BELT"));
@@ -864,7 +863,7 @@ BattleItem* BattlescapeGenerator::addItem(BattleItem *item, bool secondPass)
 				if ((*i)->getArmor()->getSize() > 1 || 0 == (*i)->getGeoscapeSoldier()) continue;
 				if (!((*i)->getGeoscapeSoldier()->getEquipmentLayout()->empty())) continue;
 
-				if (!(*i)->getItem("STR_BELT"))
+				if (!(*i)->getItem(RuleInventory::BELT))
 				{
 					// at this point we are assuming (1,0) is not occupied already (with eg. a grenade)
 					// (this is relevant in the case of HIGH EXPLOSIVE which occupies two slot)
@@ -899,7 +898,7 @@ BattleItem* BattlescapeGenerator::addItem(BattleItem *item, bool secondPass)
 					if ((*i)->getArmor()->getSize() > 1 || 0 == (*i)->getGeoscapeSoldier()) continue;
 					if (!((*i)->getGeoscapeSoldier()->getEquipmentLayout()->empty())) continue;
 
-					if (!(*i)->getItem("STR_RIGHT_HAND"))
+					if (!(*i)->getItem(RuleInventory::RIGHT_HAND))
 					{
 						item->moveToOwner((*i));
 						item->setSlot(righthand);
@@ -916,7 +915,7 @@ BattleItem* BattlescapeGenerator::addItem(BattleItem *item, bool secondPass)
 				if ((*i)->getArmor()->getSize() > 1 || 0 == (*i)->getGeoscapeSoldier()) continue;
 				if (!((*i)->getGeoscapeSoldier()->getEquipmentLayout()->empty())) continue;
 
-				if (!(*i)->getItem("STR_BELT",3,0))
+				if (!(*i)->getItem(RuleInventory::BELT,3,0))
 				{
 					// at this point we are assuming (3,1) is not occupied already (with eg. a grenade)
 					item->moveToOwner((*i));
@@ -955,9 +954,9 @@ BattleItem* BattlescapeGenerator::addItem(RuleItem *item, BattleUnit *unit)
 	{
 	case BT_AMMO:
 		// find equipped weapons that can be loaded with this ammo
-		if (unit->getItem("STR_RIGHT_HAND") && unit->getItem("STR_RIGHT_HAND")->getAmmoItem() == 0)
+		if (unit->getItem(RuleInventory::RIGHT_HAND) && unit->getItem(RuleInventory::RIGHT_HAND)->getAmmoItem() == 0)
 		{
-			if (unit->getItem("STR_RIGHT_HAND")->setAmmoItem(bi) == 0)
+			if (unit->getItem(RuleInventory::RIGHT_HAND)->setAmmoItem(bi) == 0)
 			{
 				placed = true;
 			}
@@ -966,7 +965,7 @@ BattleItem* BattlescapeGenerator::addItem(RuleItem *item, BattleUnit *unit)
 		{	
 			for (int i = 0; i != 4; ++i)
 			{
-				if (!unit->getItem("STR_BELT", i))
+				if (!unit->getItem(RuleInventory::BELT, i))
 				{
 					bi->moveToOwner(unit);
 					bi->setSlot(_game->getRuleset()->getInventory("STR_BELT"));
@@ -981,7 +980,7 @@ BattleItem* BattlescapeGenerator::addItem(RuleItem *item, BattleUnit *unit)
 	case BT_PROXIMITYGRENADE:
 		for (int i = 0; i != 4; ++i)
 		{
-			if (!unit->getItem("STR_BELT", i))
+			if (!unit->getItem(RuleInventory::BELT, i))
 			{
 				bi->moveToOwner(unit);
 				bi->setSlot(_game->getRuleset()->getInventory("STR_BELT"));
@@ -993,7 +992,7 @@ BattleItem* BattlescapeGenerator::addItem(RuleItem *item, BattleUnit *unit)
 		break;
 	case BT_FIREARM:
 	case BT_MELEE:
-		if (!unit->getItem("STR_RIGHT_HAND"))
+		if (!unit->getItem(RuleInventory::RIGHT_HAND))
 		{
 			bi->moveToOwner(unit);
 			bi->setSlot(_game->getRuleset()->getInventory("STR_RIGHT_HAND"));
@@ -1002,7 +1001,7 @@ BattleItem* BattlescapeGenerator::addItem(RuleItem *item, BattleUnit *unit)
 		break;
 	case BT_MEDIKIT:
 	case BT_SCANNER:
-		if (!unit->getItem("STR_BACK_PACK"))
+		if (!unit->getItem(RuleInventory::BACK_PACK))
 		{
 			bi->moveToOwner(unit);
 			bi->setSlot(_game->getRuleset()->getInventory("STR_BACK_PACK"));
@@ -1010,7 +1009,7 @@ BattleItem* BattlescapeGenerator::addItem(RuleItem *item, BattleUnit *unit)
 		}
 		break;
 	case BT_MINDPROBE:
-		if (!unit->getItem("STR_LEFT_HAND"))
+		if (!unit->getItem(RuleInventory::LEFT_HAND))
 		{
 			bi->moveToOwner(unit);
 			bi->setSlot(_game->getRuleset()->getInventory("STR_LEFT_HAND"));
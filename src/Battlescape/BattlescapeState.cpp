@@ -65,7 +65,9 @@
 #include "../Savegame/BattleItem.h"
 #include "../Ruleset/Ruleset.h"
 #include "../Ruleset/RuleItem.h"
+#include "../Ruleset/RuleInventory.h"
 #include "../Ruleset/Armor.h"
+#include "../Ruleset/MapDataSet.h"
 #include "../Engine/Timer.h"
 #include "../Engine/Options.h"
 #include "WarningMessage.h"
@@ -843,10 +845,10 @@ void BattlescapeState::btnLeftHandItemClick(Action *)
 	if (_battleGame->getCurrentAction()->type != BA_NONE) return;
 	if (playableUnitSelected())
 	{
-		_save->getSelectedUnit()->setActiveHand("STR_LEFT_HAND");
+		_save->getSelectedUnit()->setActiveHand(RuleInventory::LEFT_HAND);
 		_map->cacheUnits();
 		_map->draw();
-		BattleItem *leftHandItem = _save->getSelectedUnit()->getItem("STR_LEFT_HAND");
+		BattleItem *leftHandItem = _save->getSelectedUnit()->getItem(RuleInventory::LEFT_HAND);
 		handleItemClick(leftHandItem);
 	}
 }
@@ -860,10 +862,10 @@ void BattlescapeState::btnRightHandItemClick(Action *)
 	if (_battleGame->getCurrentAction()->type != BA_NONE) return;
 	if (playableUnitSelected())
 	{
-		_save->getSelectedUnit()->setActiveHand("STR_RIGHT_HAND");
+		_save->getSelectedUnit()->setActiveHand(RuleInventory::RIGHT_HAND);
 		_map->cacheUnits();
 		_map->draw();
-		BattleItem *rightHandItem = _save->getSelectedUnit()->getItem("STR_RIGHT_HAND");
+		BattleItem *rightHandItem = _save->getSelectedUnit()->getItem(RuleInventory::RIGHT_HAND);
 		handleItemClick(rightHandItem);
 	}
 }
@@ -1033,7 +1035,7 @@ void BattlescapeState::updateSoldierInfo()
 	_barMorale->setMax(100);
 	_barMorale->setValue(battleUnit->getMorale());
 
-	BattleItem *leftHandItem = battleUnit->getItem("STR_LEFT_HAND");
+	BattleItem *leftHandItem = battleUnit->getItem(RuleInventory::LEFT_HAND);
 	_btnLeftHandItem->clear();
 	_numAmmoLeft->setVisible(false);
 	if (leftHandItem)
@@ -1048,7 +1050,7 @@ void BattlescapeState::updateSoldierInfo()
 				_numAmmoLeft->setValue(0);
 		}
 	}
-	BattleItem *rightHandItem = battleUnit->getItem("STR_RIGHT_HAND");
+	BattleItem *rightHandItem = battleUnit->getItem(RuleInventory::RIGHT_HAND);
 	_btnRightHandItem->clear();
 	_numAmmoRight->setVisible(false);
 	if (rightHandItem)
@@ -1244,6 +1246,16 @@ inline void BattlescapeState::handle(Action *action)
 				{
 					SaveAIMap();
 				}
+				// "ctrl-p" - pathfinding benchmark
+				else if (action->getDetails()->key.keysym.sym == SDLK_p && (SDL_GetModState() & KMOD_CTRL) != 0 && _save->getDebugMode())
+				{
+					BenchmarkPathfinding();
+				}
+				// f7 - shading benchmark
+				else if (action->getDetails()->key.keysym.sym == SDLK_F7 && _save->getDebugMode())
+				{
+					BenchmarkShading();
+				}
 			}
 		}
 	}
@@ -1282,7 +1294,7 @@ void BattlescapeState::SaveAIMap()
 			if (!t) continue;
 			if (!t->isDiscovered(2)) continue;
 			
-			if (_save->getTileEngine()->surveyXComThreatToTile(t, tilePos, unit) && t->totalExposure > expMax) expMax = t->totalExposure;
+			if (_save->getTileEngine()->surveyXComThreatToTile(t, tilePos, unit) && t->getThreat()->totalExposure > expMax) expMax = t->getThreat()->totalExposure;
 		}
 	}
 	
@@ -1302,11 +1314,11 @@ void BattlescapeState::SaveAIMap()
 			r.x = x * r.w;
 			r.y = y * r.h;
 
-			if (t->getTUCost(MapData::O_FLOOR, MT_FLY) != 255 && t->getTUCost(MapData::O_OBJECT, MT_FLY) != 255 && _save->getTileEngine()->surveyXComThreatToTile(t, tilePos, unit) && t->soldiersVisible != Tile::NOT_CALCULATED)
+			if (t->getTUCost(MapData::O_FLOOR, MT_FLY) != 255 && t->getTUCost(MapData::O_OBJECT, MT_FLY) != 255 && _save->getTileEngine()->surveyXComThreatToTile(t, tilePos, unit) && t->getThreat()->soldiersVisible != Tile::NOT_CALCULATED)
 			{
-				int e = (t->totalExposure * 255) / expMax;
+				int e = (t->getThreat()->totalExposure * 255) / expMax;
 				SDL_FillRect(img, &r, SDL_MapRGB(img->format, e, 255-e, 0x20));
-				characterRGBA(img, r.x, r.y, t->soldiersVisible > 9 ? '*' : ('0'+t->soldiersVisible), 0x7f, 0x7f, 0x7f, 0x7f);
+				characterRGBA(img, r.x, r.y, t->getThreat()->soldiersVisible > 9 ? '*' : ('0'+t->getThreat()->soldiersVisible), 0x7f, 0x7f, 0x7f, 0x7f);
 			} else
 			{
 				if (!t->getUnit()) SDL_FillRect(img, &r, SDL_MapRGB(img->format, 0x50, 0x50, 0x50)); // gray for blocked tile
@@ -1377,6 +1389,70 @@ void BattlescapeState::SaveAIMap()
 	Log(LOG_INFO) << "SaveAIMap() completed in " << SDL_GetTicks() - start << "ms.";
 }
 
+/**
+ * Runs the pathfinding of the selected unit over and over on the current map,
+ * the way the AI uses it, and logs how long it took. Load a saved battle to
+ * compare different versions of the pathfinding on the same map.
+ */
+void BattlescapeState::BenchmarkPathfinding()
+{
+	BattleUnit *unit = _save->getSelectedUnit();
+	if (!unit) return;
+
+	Pathfinding *pathfinding = _save->getPathfinding();
+	const int reachableRuns = 50;
+	Uint32 start = SDL_GetTicks();
+	size_t reachable = 0;
+	for (int i = 0; i < reachableRuns; ++i)
+	{
+		reachable = pathfinding->findReachable(unit, unit->getStats()->tu).size();
+	}
+	Uint32 reachableTime = SDL_GetTicks() - start;
+
+	// paths to every fourth tile of every level
+	start = SDL_GetTicks();
+	int paths = 0, found = 0;
+	for (int z = 0; z < _save->getMapSizeZ(); ++z)
+	{
+		for (int y = 0; y < _save->getMapSizeY(); y += 2)
+		{
+			for (int x = 0; x < _save->getMapSizeX(); x += 2)
+			{
+				pathfinding->calculate(unit, Position(x, y, z));
+				if (pathfinding->getStartDirection() != -1)
+				{
+					++found;
+				}
+				pathfinding->abortPath();
+				++paths;
+			}
+		}
+	}
+	Uint32 pathTime = SDL_GetTicks() - start;
+
+	Log(LOG_INFO) << "BenchmarkPathfinding() unit " << unit->getId() << " on a " << _save->getMapSizeX() << "x" << _save->getMapSizeY() << "x" << _save->getMapSizeZ() << " map:";
+	Log(LOG_INFO) << "  findReachable: " << reachableRuns << " runs, " << reachable << " tiles, " << reachableTime << "ms";
+	Log(LOG_INFO) << "  calculate: " << paths << " paths, " << found << " found, " << pathTime << "ms";
+}
+
+/**
+ * Blits all the terrain sprites of the current battle in every shade,
+ * with and without the vectorized shading, and logs how long it took.
+ */
+void BattlescapeState::BenchmarkShading()
+{
+	std::vector<Surface*> sprites;
+	for (std::vector<MapDataSet*>::iterator i = _save->getMapDataSets()->begin(); i != _save->getMapDataSets()->end(); ++i)
+	{
+		SurfaceSet *set = (*i)->getSurfaceset();
+		for (int j = 0; j < set->getTotalFrames(); ++j)
+		{
+			sprites.push_back(set->getFrame(j));
+		}
+	}
+	Surface::benchmarkShading(sprites, _map->getWidth(), _map->getHeight());
+}
+
 
 void BattlescapeState::SaveVoxelView()
 {
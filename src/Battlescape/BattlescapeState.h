@@ -183,6 +183,10 @@ public:
 	/// returns a pointer to the battlegame, in case we need it's functions.
 	BattlescapeGame *getBattleGame();
 	void SaveAIMap();
+	/// Times the pathfinding of the selected unit on the current map.
+	void BenchmarkPathfinding();
+	/// Times the vectorized terrain shading against the plain one.
+	void BenchmarkShading();
 	void SaveVoxelMap();
 	void SaveVoxelView();
 
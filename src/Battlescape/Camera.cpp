@@ -140,11 +140,13 @@ void Camera::mouseOver(Action *action, State *)
 		return;
 	}
 
-	if (Options::getInt("battleScrollType") == SCROLL_AUTO || _scrollTrigger)
+	static const int &battleScrollType = Options::watchInt("battleScrollType");
+	static const int &battleScrollSpeed = Options::watchInt("battleScrollSpeed");
+	if (battleScrollType == SCROLL_AUTO || _scrollTrigger)
 	{
 		int posX = action->getXMouse();
 		int posY = action->getYMouse();
-		int scrollSpeed = Options::getInt("battleScrollSpeed");
+		int scrollSpeed = battleScrollSpeed;
 
 		//left scroll
 		if (posX < (SCROLL_BORDER * action->getXScale()) && posX >= 0)
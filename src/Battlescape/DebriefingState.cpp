@@ -575,7 +575,7 @@ void DebriefingState::prepareDebriefing()
 					{ // non soldier player = tank
 						base->getItems()->addItem(type);
 						RuleItem *tankRule = _game->getRuleset()->getItem(type);
-						BattleItem *ammoItem = (*j)->getItem("STR_RIGHT_HAND")->getAmmoItem();
+						BattleItem *ammoItem = (*j)->getItem(RuleInventory::RIGHT_HAND)->getAmmoItem();
 						if (tankRule->getClipSize() != -1 && 0 != ammoItem && 0 < ammoItem->getAmmoQuantity())
 							base->getItems()->addItem(tankRule->getCompatibleAmmo()->front(), ammoItem->getAmmoQuantity());
 					}
@@ -807,7 +807,7 @@ void DebriefingState::prepareDebriefing()
 	{
 		for (std::vector<Craft*>::iterator c = base->getCrafts()->begin(); c != base->getCrafts()->end(); ++c)
 		{
-			if ((*c)->getStatus() != "STR_OUT")
+			if ((*c)->getStatus() != Craft::STATUS_OUT)
 				reequipCraft(base, *c, false);
 		}
 		// Clearing base->getVehicles() objects, they don't needed anymore.
@@ -856,20 +856,22 @@ void DebriefingState::prepareDebriefing()
 
 void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCanBeDestroyed)
 {
-	std::map<std::string, int> craftItems = *craft->getItems()->getContents();
-	for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
+	ItemContainer craftItems = *craft->getItems();
+	std::vector<Atom> items = craftItems.getSortedItems();
+	for (std::vector<Atom>::iterator i = items.begin(); i != items.end(); ++i)
 	{
-		int qty = base->getItems()->getItem(i->first);
-		if (qty >= i->second)
+		int needed = craftItems.getItem(*i);
+		int qty = base->getItems()->getItem(*i);
+		if (qty >= needed)
 		{
-			base->getItems()->removeItem(i->first, i->second);
+			base->getItems()->removeItem(*i, needed);
 		}
 		else
 		{
-			int missing = i->second - qty;
-			base->getItems()->removeItem(i->first, qty);
-			craft->getItems()->removeItem(i->first, missing);
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage())};
+			int missing = needed - qty;
+			base->getItems()->removeItem(*i, qty);
+			craft->getItems()->removeItem(*i, missing);
+			ReequipStat stat = {*i, missing, craft->getName(_game->getLanguage())};
 			_missingItems.push_back(stat);
 		}
 	}
@@ -885,30 +887,32 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			delete (*i);
 	craft->getVehicles()->clear();
 	// Ok, now readd those vehicles
-	for (std::map<std::string, int>::iterator i = craftVehicles.getContents()->begin(); i != craftVehicles.getContents()->end(); ++i)
+	std::vector<Atom> vehicles = craftVehicles.getSortedItems();
+	for (std::vector<Atom>::iterator i = vehicles.begin(); i != vehicles.end(); ++i)
 	{
-		int qty = base->getItems()->getItem(i->first);
-		RuleItem *tankRule = _game->getRuleset()->getItem(i->first);
-		int canBeAdded = std::min(qty, i->second);
-		if (qty < i->second)
+		int needed = craftVehicles.getItem(*i);
+		int qty = base->getItems()->getItem(*i);
+		RuleItem *tankRule = _game->getRuleset()->getItem(*i);
+		int canBeAdded = std::min(qty, needed);
+		if (qty < needed)
 		{ // missing tanks
-			int missing = i->second - qty;
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage())};
+			int missing = needed - qty;
+			ReequipStat stat = {*i, missing, craft->getName(_game->getLanguage())};
 			_missingItems.push_back(stat);
 		}
 		if (tankRule->getClipSize() == -1)
 		{ // so this tank does NOT require ammo
 			for (int j = 0; j < canBeAdded; ++j)
 				craft->getVehicles()->push_back(new Vehicle(tankRule, 255));
-			base->getItems()->removeItem(i->first, canBeAdded);
+			base->getItems()->removeItem(*i, canBeAdded);
 		}
 		else
 		{ // so this tank requires ammo
 			RuleItem *ammo = _game->getRuleset()->getItem(tankRule->getCompatibleAmmo()->front());
 			int baqty = base->getItems()->getItem(ammo->getType()); // Ammo Quantity for this vehicle-type on the base
-			if (baqty < i->second * ammo->getClipSize())
+			if (baqty < needed * ammo->getClipSize())
 			{ // missing ammo
-				int missing = (i->second * ammo->getClipSize()) - baqty;
+				int missing = (needed * ammo->getClipSize()) - baqty;
 				ReequipStat stat = {ammo->getType(), missing, craft->getName(_game->getLanguage())};
 				_missingItems.push_back(stat);
 			}
@@ -926,7 +930,7 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 					craft->getVehicles()->push_back(new Vehicle(tankRule, newAmmo));
 					base->getItems()->removeItem(ammo->getType(), newAmmo);
 				}
-				base->getItems()->removeItem(i->first, canBeAdded);
+				base->getItems()->removeItem(*i, canBeAdded);
 			}
 		}
 	}
@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <fstream>
+#include <algorithm>
 #include "Map.h"
 #include "Camera.h"
 #include "UnitSprite.h"
@@ -42,11 +43,13 @@
 #include "../Ruleset/MapDataSet.h"
 #include "../Ruleset/MapData.h"
 #include "../Ruleset/Armor.h"
+#include "../Ruleset/RuleInventory.h"
 #include "BattlescapeMessage.h"
 #include "../Savegame/SavedGame.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Options.h"
 #include "../Interface/NumberText.h"
+#include "../Engine/ThreadPool.h"
 
 
 /*
@@ -74,7 +77,7 @@ namespace OpenXcom
  * @param y Y position in pixels.
  * @param visibleMapHeight Current visible map height.
  */
-Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight) : InteractiveSurface(width, height, x, y), _game(game), _arrow(0), _selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0), _launch(false), _visibleMapHeight(visibleMapHeight), _unitDying(false)
+Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight) : InteractiveSurface(width, height, x, y), _game(game), _arrow(0), _selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0), _launch(false), _visibleMapHeight(visibleMapHeight), _unitDying(false), _drawnEndZ(-1), _redrawAll(true), _recording(false)
 {
 	_res = _game->getResourcePack();
 	_spriteWidth = _res->getSurfaceSet("BLANKS.PCK")->getFrame(0)->getWidth();
@@ -155,7 +158,8 @@ void Map::think()
  */
 void Map::draw()
 {
-	Surface::draw();
+	// the terrain is drawn over what's already there, see drawTerrain()
+	_redraw = false;
 	Tile *t;
 	
 	projectileInFOV = _save->getDebugMode();
@@ -184,7 +188,9 @@ void Map::draw()
 	}
 	else
 	{
+		Surface::draw();
 		_message->blit(this);
+		_redrawAll = true;
 	}
 }
 
@@ -205,17 +211,32 @@ void Map::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 	_message->setBackground(_res->getSurface("TAC00.SCR"));
 	_message->setFonts(_res->getFont("Big.fnt"), _res->getFont("Small.fnt"));
 	_message->setText(_game->getLanguage()->getString("STR_HIDDEN_MOVEMENT"));
+	_redrawAll = true;
 }
 
+/**
+ * Everything the band drawing jobs need to know.
+ */
+struct MapBandJob
+{
+	Map *map;
+	Surface *surface;
+	SDL_Rect rect;
+	Position bulletLow, bulletHigh;
+};
+
 /**
 * Draw the terrain.
-* Keep this function as optimised as possible. It's big to minimise overhead of function calls.
+* The map surface keeps what was drawn on it last time, so only the parts of it that changed
+* are drawn again: every tile first records what it would draw (without drawing it), and the
+* areas of the tiles whose sprites, shades or positions differ from last time are redrawn,
+* clipped to those areas, in the usual back to front order. This picks up walking units,
+* doors, explosions and light changes alike, and when nothing moves nothing is drawn at all.
+* The changed areas are drawn in horizontal bands on the worker threads.
 * @param surface The surface to draw on.
 */
 void Map::drawTerrain(Surface *surface)
 {
-	int frameNumber = 0;
-	Surface *tmpSurface;
 	Tile *tile;
 	int beginX = 0, endX = _save->getMapSizeX() - 1;
 	int beginY = 0, endY = _save->getMapSizeY() - 1;
@@ -223,12 +244,7 @@ void Map::drawTerrain(Surface *surface)
 	Position mapPosition, screenPosition, bulletPositionScreen;
 	int bulletLowX=16000, bulletLowY=16000, bulletLowZ=16000, bulletHighX=0, bulletHighY=0, bulletHighZ=0;
 	int dummy;
-	BattleUnit *unit = 0;
-	bool invalid;
-	int tileShade, wallShade, tileColor;
 
-	NumberText *_numWaypid = 0;
-	
 	// if we got bullet, get the highest x and y tiles to draw it on
 	if (_projectile /* && !_projectile->getItem()*/) //thrown items also need to be sen by level
 	{
@@ -329,15 +345,32 @@ void Map::drawTerrain(Surface *surface)
 	if (beginY < 0)
 		beginY = 0;
 
-	if (!_waypoints.empty())
+	Position bulletLow(bulletLowX, bulletLowY, bulletLowZ), bulletHigh(bulletHighX, bulletHighY, bulletHighZ);
+
+	// the waypoint numbers are drawn up front, so the bands can share them
+	for (size_t i = 0; i < _waypoints.size(); ++i)
 	{
-		_numWaypid = new NumberText(15, 15, 20, 30);
-		_numWaypid->setPalette(getPalette());
-		_numWaypid->setColor(Palette::blockOffset(1));
+		NumberText *number = new NumberText(15, 15, 20, 30);
+		number->setPalette(getPalette());
+		number->setColor(Palette::blockOffset(1));
+		number->setValue(i + 1);
+		number->draw();
+		_waypointNumbers.push_back(number);
 	}
 
-	surface->lock();
+	// scrolling or changing levels moves everything
+	if (_camera->getMapOffset() != _drawnOffset || endZ != _drawnEndZ || (int)_drawnTiles.size() != _save->getMapSizeXYZ())
+	{
+		_redrawAll = true;
+		_drawnOffset = _camera->getMapOffset();
+		_drawnEndZ = endZ;
+		_drawnTiles.assign(_save->getMapSizeXYZ(), DrawnArea());
+	}
 
+	// record what every tile on screen would draw and compare it to last time
+	std::vector<SDL_Rect> dirty;
+	_screenTiles.clear();
+	_recording = true;
 	for (int itZ = beginZ; itZ <= endZ; itZ++)
 	{
 		for (int itX = beginX; itX <= endX; itX++)
@@ -356,315 +389,428 @@ void Map::drawTerrain(Surface *surface)
 
 					if (!tile) continue;
 
-					if (tile->isDiscovered(2))
-					{
-						tileShade = tile->getShade();
-					}
-					else
+					_screenTiles.push_back(std::make_pair(tile, screenPosition));
+					_recorded.clear();
+					drawTile(surface, 0, tile, screenPosition, bulletLow, bulletHigh);
+					DrawnArea &drawn = _drawnTiles[_save->getTileIndex(mapPosition)];
+					if (drawn.changed(_recorded))
 					{
-						tileShade = 16;
-						unit = 0;
+						if (!_redrawAll)
+						{
+							addDirtyRect(&dirty, drawn.bounds);
+							addDirtyRect(&dirty, _recorded.bounds);
+						}
+						drawn = _recorded;
 					}
+				}
+			}
+		}
+	}
+	_recorded.clear();
+	drawOverlays(surface, 0);
+	if (_drawnOverlays.changed(_recorded))
+	{
+		addDirtyRect(&dirty, _drawnOverlays.bounds);
+		addDirtyRect(&dirty, _recorded.bounds);
+		_drawnOverlays = _recorded;
+	}
+	_recording = false;
 
-					tileColor = tile->getMarkerColor();
+	int dirtyArea = 0;
+	for (std::vector<SDL_Rect>::const_iterator i = dirty.begin(); i != dirty.end(); ++i)
+	{
+		dirtyArea += i->w * i->h;
+	}
+	// when most of the screen changed, one big rectangle is cheaper than many small ones
+	if (_redrawAll || dirtyArea > surface->getWidth() * surface->getHeight() / 2)
+	{
+		SDL_Rect all = {0, 0, (Uint16)surface->getWidth(), (Uint16)surface->getHeight()};
+		dirty.clear();
+		dirty.push_back(all);
+		_redrawAll = false;
+	}
 
-					// Draw floor
-					tmpSurface = tile->getSprite(MapData::O_FLOOR);
-					if (tmpSurface)
-						tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_FLOOR)->getYOffset(), tileShade, false, tileColor);
-					unit = tile->getUnit();
+	// every rectangle is drawn in horizontal bands, in parallel: the painter's order
+	// within a band is all that matters, and bands never touch each other's pixels
+	MapBandJob job;
+	job.map = this;
+	job.surface = surface;
+	job.bulletLow = bulletLow;
+	job.bulletHigh = bulletHigh;
+	for (std::vector<SDL_Rect>::iterator i = dirty.begin(); i != dirty.end(); ++i)
+	{
+		surface->drawRect(&(*i), 0);
+		surface->lock();
+		job.rect = *i;
+		ThreadPool::getInstance()->runBands(drawBand, &job, i->y, i->y + i->h);
+		surface->unlock();
+	}
 
-					// Draw cursor back
-					if (_cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && _game->getCursor()->getY() < 144)
-					{
-						if (_camera->getViewLevel() == itZ)
-						{
-							if (_cursorType != CT_AIM)
-							{
-								if (unit && (unit->getVisible() || _save->getDebugMode()))
-									frameNumber = (_animFrame % 2); // yellow box
-								else
-									frameNumber = 0; // red box
-							}else
-							{
-								if (unit && (unit->getVisible() || _save->getDebugMode()))
-									frameNumber = 7 + (_animFrame / 2); // yellow animated crosshairs
-								else
-									frameNumber = 6; // red static crosshairs
-							}
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-						}
-						else if (_camera->getViewLevel() > itZ)
-						{
-							frameNumber = 2; // blue box
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-						}
-					}
+	for (std::vector<NumberText*>::iterator i = _waypointNumbers.begin(); i != _waypointNumbers.end(); ++i)
+	{
+		delete *i;
+	}
+	_waypointNumbers.clear();
+}
 
-					// Draw walls
-					if (!tile->isVoid())
-					{
-						// Draw west wall
-						tmpSurface = tile->getSprite(MapData::O_WESTWALL);
-						if (tmpSurface)
-						{
-							if ((tile->getMapData(MapData::O_WESTWALL)->isDoor() || tile->getMapData(MapData::O_WESTWALL)->isUFODoor())
-								 && tile->isDiscovered(0))
-								wallShade = tile->getShade();
-							else
-								wallShade = tileShade;
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_WESTWALL)->getYOffset(), wallShade, false);
-						}
-						// Draw north wall
-						tmpSurface = tile->getSprite(MapData::O_NORTHWALL);
-						if (tmpSurface)
-						{
-							if ((tile->getMapData(MapData::O_NORTHWALL)->isDoor() || tile->getMapData(MapData::O_NORTHWALL)->isUFODoor())
-								 && tile->isDiscovered(1))
-								wallShade = tile->getShade();
-							else
-								wallShade = tileShade;
-							if (tile->getMapData(MapData::O_WESTWALL))
-							{
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, true);
-							}
-							else
-							{
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, false);
-							}
-						}
-						// Draw object
-						if (tile->getMapData(MapData::O_OBJECT))
-						{
-							tmpSurface = tile->getSprite(MapData::O_OBJECT);
-							if (tmpSurface)
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_OBJECT)->getYOffset(), tileShade, false, tileColor);
-						}
-						// draw an item on top of the floor (if any)
-						int sprite = tile->getTopItemSprite();
-						if (sprite != -1)
-						{
-							tmpSurface = _res->getSurfaceSet("FLOOROB.PCK")->getFrame(sprite);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), tileShade, false);
-						}
-						
-					}
+/**
+ * Thread pool entry point for redrawing one band of a changed rectangle:
+ * all the tiles reaching into it, back to front, and the overlays.
+ * @param data Pointer to the MapBandJob.
+ * @param begin First row of the band.
+ * @param end Row after the last one of the band.
+ */
+void Map::drawBand(void *data, int begin, int end)
+{
+	MapBandJob *job = (MapBandJob*)data;
+	Map *map = job->map;
+	SDL_Rect clip = job->rect;
+	clip.y = begin;
+	clip.h = end - begin;
+	for (std::vector<std::pair<Tile*, Position> >::const_iterator i = map->_screenTiles.begin(); i != map->_screenTiles.end(); ++i)
+	{
+		if (intersects(map->_drawnTiles[map->_save->getTileIndex(i->first->getPosition())].bounds, clip))
+		{
+			map->drawTile(job->surface, &clip, i->first, i->second, job->bulletLow, job->bulletHigh);
+		}
+	}
+	map->drawOverlays(job->surface, &clip);
+}
 
-					// check if we got bullet && it is in Field Of View
-					if (_projectile && projectileInFOV)
-					{
-						tmpSurface = 0;
-						if (_projectile->getItem())
-						{
-							tmpSurface = _projectile->getSprite();
-
-							Position voxelPos = _projectile->getPosition();
-							// draw shadow on the floor
-							voxelPos.z = _save->getTileEngine()->castedShade(voxelPos);
-							if (voxelPos.x / 16 >= itX &&
-								voxelPos.y / 16 >= itY &&
-								voxelPos.x / 16 <= itX+1 &&
-								voxelPos.y / 16 <= itY+1 &&
-								voxelPos.z / 24 == itZ &&
-								_save->getTileEngine()->isVoxelVisible(voxelPos))
-							{
-								_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
-								tmpSurface->blitNShade(surface, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 16);
-							}
-
-							voxelPos = _projectile->getPosition();
-							// draw thrown object
-							if (voxelPos.x / 16 >= itX &&
-								voxelPos.y / 16 >= itY &&
-								voxelPos.x / 16 <= itX+1 &&
-								voxelPos.y / 16 <= itY+1 &&
-								voxelPos.z / 24 == itZ &&
-								_save->getTileEngine()->isVoxelVisible(voxelPos))
-							{
-								_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
-								tmpSurface->blitNShade(surface, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 0);
-							}
+/**
+ * Draws everything on one tile: terrain, items, units, bullets, cursor, waypoints, smoke and fire.
+ * @param surface The surface to draw on.
+ * @param clip Only draw inside this rectangle of the surface (0 for everywhere).
+ * @param tile The tile to draw.
+ * @param screenPosition The position of the tile on the surface.
+ * @param bulletLow The lowest tile position the bullet particles are on.
+ * @param bulletHigh The highest tile position the bullet particles are on.
+ */
+void Map::drawTile(Surface *surface, const SDL_Rect *clip, Tile *tile, const Position &screenPosition, const Position &bulletLow, const Position &bulletHigh)
+{
+	const Position &mapPosition = tile->getPosition();
+	int itX = mapPosition.x, itY = mapPosition.y, itZ = mapPosition.z;
+	int frameNumber = 0;
+	Surface *tmpSurface;
+	Position bulletPositionScreen;
+	BattleUnit *unit = 0;
+	bool invalid;
+	int tileShade, wallShade, tileColor;
 
-						}
-						else
-						{
-							// draw bullet on the correct tile
-							if (itX >= bulletLowX && itX <= bulletHighX && itY >= bulletLowY && itY <= bulletHighY)
-							{
-								for (int i = 1; i <= _projectile->getParticle(0); ++i)
-								{
-									if (_projectile->getParticle(i) != 0xFF)
-									{
-										Position voxelPos = _projectile->getPosition(1-i);
-										// draw shadow on the floor
-										voxelPos.z = _save->getTileEngine()->castedShade(voxelPos);
-										if (voxelPos.x / 16 == itX &&
-											voxelPos.y / 16 == itY &&
-											voxelPos.z / 24 == itZ &&
-											_save->getTileEngine()->isVoxelVisible(voxelPos))
-										{
-											_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
-											_bullet[_projectile->getParticle(i)]->blitNShade(surface, bulletPositionScreen.x, bulletPositionScreen.y, 16);
-										}
-										// draw bullet itself
-										voxelPos = _projectile->getPosition(1-i);
-										if (voxelPos.x / 16 == itX &&
-											voxelPos.y / 16 == itY &&
-											voxelPos.z / 24 == itZ &&
-											_save->getTileEngine()->isVoxelVisible(voxelPos))
-										{
-											_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
-											_bullet[_projectile->getParticle(i)]->blitNShade(surface, bulletPositionScreen.x, bulletPositionScreen.y, 0);
-										}
-
-									}
-								}
-							}
-						}
-					}
+	if (tile->isDiscovered(2))
+	{
+		tileShade = tile->getShade();
+	}
+	else
+	{
+		tileShade = 16;
+		unit = 0;
+	}
 
-			        unit = tile->getUnit();
-					// Draw soldier
-					if (unit && (unit->getVisible() || _save->getDebugMode()))
-					{
-						// the part is 0 for small units, large units have parts 1,2 & 3 depending on the relative x/y position of this tile vs the actual unit position.
-						int part = 0;
-						part += tile->getPosition().x - unit->getPosition().x;
-						part += (tile->getPosition().y - unit->getPosition().y)*2;
-						tmpSurface = unit->getCache(&invalid, part);
-						if (tmpSurface)
-						{
-							Position offset;
-							calculateWalkingOffset(unit, &offset);
-							tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, tileShade);
-							if (unit->getFire() > 0)
-							{
-								frameNumber = 4 + (_animFrame / 2);
-								tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-								tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
-							}
-						}
-					}
-					// if we can see through the floor, draw the soldier below it if it is on stairs
-					Tile *tileBelow = _save->getTile(mapPosition + Position(0, 0, -1));
-					if (itZ > 0 && tile->hasNoFloor(tileBelow))
-					{
-						BattleUnit *tunit = _save->selectUnit(Position(itX, itY, itZ-1));
-						Tile *ttile = _save->getTile(Position(itX, itY, itZ-1));
-						if (tunit && tunit->getVisible() && ttile->getTerrainLevel() < 0 && ttile->isDiscovered(2))
-						{
-							// the part is 0 for small units, large units have parts 1,2 & 3 depending on the relative x/y position of this tile vs the actual unit position.
-							int part = 0;
-							part += ttile->getPosition().x - tunit->getPosition().x;
-							part += (ttile->getPosition().y - tunit->getPosition().y)*2;
-							tmpSurface = tunit->getCache(&invalid, part);
-							if (tmpSurface)
-							{
-								Position offset;
-								calculateWalkingOffset(tunit, &offset);
-								offset.y += 24;
-								tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, ttile->getShade());
-								if (tunit->getArmor()->getSize() > 1)
-								{
-									offset.y += 4;
-								}
-								if (tunit->getFire() > 0)
-								{
-									frameNumber = 4 + (_animFrame / 2);
-									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-									tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
-								}
-							}
-						}
-					}
+	tileColor = tile->getMarkerColor();
 
-					// Draw cursor front
-					if (_cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && _game->getCursor()->getY() < 144)
-					{
-						if (_camera->getViewLevel() == itZ)
-						{
-							if (_cursorType != CT_AIM)
-							{
-								if (unit && (unit->getVisible() || _save->getDebugMode()))
-									frameNumber = 3 + (_animFrame % 2); // yellow box
-								else
-									frameNumber = 3; // red box
-							}else
-							{
-								if (unit && (unit->getVisible() || _save->getDebugMode()))
-									frameNumber = 7 + (_animFrame / 2); // yellow animated crosshairs
-								else
-									frameNumber = 6; // red static crosshairs
-							}
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-						}
-						else if (_camera->getViewLevel() > itZ)
-						{
-							frameNumber = 5; // blue box
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-						}
-						if (_cursorType > 2 && _camera->getViewLevel() == itZ)
-						{
-							int frame[6] = {0, 0, 0, 11, 13, 15};
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frame[_cursorType] + (_animFrame / 4));
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-						}
-					}
+	// Draw floor
+	if (tile->getSprite(MapData::O_FLOOR))
+		blitTerrain(tile, MapData::O_FLOOR, surface, clip, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_FLOOR)->getYOffset(), tileShade, false, tileColor);
+	unit = tile->getUnit();
 
-					// Draw waypoints if any on this tile
-					int waypid = 1;
-					for (std::vector<Position>::const_iterator i = _waypoints.begin(); i != _waypoints.end(); ++i)
-					{
-						if ((*i) == mapPosition)
-						{
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(7);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-							_numWaypid->setValue(waypid);
-							_numWaypid->draw();
-							_numWaypid->blitNShade(surface, screenPosition.x+2, screenPosition.y+2, 0);
-						}
-						waypid++;
-					}
+	// Draw cursor back
+	if (_cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && _game->getCursor()->getY() < 144)
+	{
+		if (_camera->getViewLevel() == itZ)
+		{
+			if (_cursorType != CT_AIM)
+			{
+				if (unit && (unit->getVisible() || _save->getDebugMode()))
+					frameNumber = (_animFrame % 2); // yellow box
+				else
+					frameNumber = 0; // red box
+			}else
+			{
+				if (unit && (unit->getVisible() || _save->getDebugMode()))
+					frameNumber = 7 + (_animFrame / 2); // yellow animated crosshairs
+				else
+					frameNumber = 6; // red static crosshairs
+			}
+			tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+			blitSprite(tmpSurface, SPRITES_CURSOR, frameNumber, surface, clip, screenPosition.x, screenPosition.y, 0);
+		}
+		else if (_camera->getViewLevel() > itZ)
+		{
+			frameNumber = 2; // blue box
+			tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+			blitSprite(tmpSurface, SPRITES_CURSOR, frameNumber, surface, clip, screenPosition.x, screenPosition.y, 0);
+		}
+	}
+
+	// Draw walls
+	if (!tile->isVoid())
+	{
+		// Draw west wall
+		if (tile->getSprite(MapData::O_WESTWALL))
+		{
+			if ((tile->getMapData(MapData::O_WESTWALL)->isDoor() || tile->getMapData(MapData::O_WESTWALL)->isUFODoor())
+				 && tile->isDiscovered(0))
+				wallShade = tile->getShade();
+			else
+				wallShade = tileShade;
+			blitTerrain(tile, MapData::O_WESTWALL, surface, clip, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_WESTWALL)->getYOffset(), wallShade, false);
+		}
+		// Draw north wall
+		if (tile->getSprite(MapData::O_NORTHWALL))
+		{
+			if ((tile->getMapData(MapData::O_NORTHWALL)->isDoor() || tile->getMapData(MapData::O_NORTHWALL)->isUFODoor())
+				 && tile->isDiscovered(1))
+				wallShade = tile->getShade();
+			else
+				wallShade = tileShade;
+			if (tile->getMapData(MapData::O_WESTWALL))
+			{
+				blitTerrain(tile, MapData::O_NORTHWALL, surface, clip, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, true);
+			}
+			else
+			{
+				blitTerrain(tile, MapData::O_NORTHWALL, surface, clip, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, false);
+			}
+		}
+		// Draw object
+		if (tile->getMapData(MapData::O_OBJECT))
+		{
+			if (tile->getSprite(MapData::O_OBJECT))
+				blitTerrain(tile, MapData::O_OBJECT, surface, clip, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_OBJECT)->getYOffset(), tileShade, false, tileColor);
+		}
+		// draw an item on top of the floor (if any)
+		int sprite = tile->getTopItemSprite();
+		if (sprite != -1)
+		{
+			tmpSurface = _res->getSurfaceSet("FLOOROB.PCK")->getFrame(sprite);
+			blitSprite(tmpSurface, SPRITES_FLOOROB, sprite, surface, clip, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), tileShade, false);
+		}
+		
+	}
 
+	// check if we got bullet && it is in Field Of View
+	if (_projectile && projectileInFOV)
+	{
+		tmpSurface = 0;
+		if (_projectile->getItem())
+		{
+			tmpSurface = _projectile->getSprite();
+
+			Position voxelPos = _projectile->getPosition();
+			// draw shadow on the floor
+			voxelPos.z = _save->getTileEngine()->castedShade(voxelPos);
+			if (voxelPos.x / 16 >= itX &&
+				voxelPos.y / 16 >= itY &&
+				voxelPos.x / 16 <= itX+1 &&
+				voxelPos.y / 16 <= itY+1 &&
+				voxelPos.z / 24 == itZ &&
+				_save->getTileEngine()->isVoxelVisible(voxelPos))
+			{
+				_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+				blitSprite(tmpSurface, SPRITES_FLOOROB, _projectile->getItem()->getRules()->getFloorSprite(), surface, clip, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 16);
+			}
+
+			voxelPos = _projectile->getPosition();
+			// draw thrown object
+			if (voxelPos.x / 16 >= itX &&
+				voxelPos.y / 16 >= itY &&
+				voxelPos.x / 16 <= itX+1 &&
+				voxelPos.y / 16 <= itY+1 &&
+				voxelPos.z / 24 == itZ &&
+				_save->getTileEngine()->isVoxelVisible(voxelPos))
+			{
+				_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+				blitSprite(tmpSurface, SPRITES_FLOOROB, _projectile->getItem()->getRules()->getFloorSprite(), surface, clip, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 0);
+			}
 
-					// Draw smoke/fire
-					if (tile->getFire() && tile->isDiscovered(2))
+		}
+		else
+		{
+			// draw bullet on the correct tile
+			if (itX >= bulletLow.x && itX <= bulletHigh.x && itY >= bulletLow.y && itY <= bulletHigh.y)
+			{
+				for (int i = 1; i <= _projectile->getParticle(0); ++i)
+				{
+					if (_projectile->getParticle(i) != 0xFF)
 					{
-						frameNumber = 0; // see http://www.ufopaedia.org/images/c/cb/Smoke.gif
-						if ((_animFrame / 2) + tile->getAnimationOffset() > 3)
+						Position voxelPos = _projectile->getPosition(1-i);
+						// draw shadow on the floor
+						voxelPos.z = _save->getTileEngine()->castedShade(voxelPos);
+						if (voxelPos.x / 16 == itX &&
+							voxelPos.y / 16 == itY &&
+							voxelPos.z / 24 == itZ &&
+							_save->getTileEngine()->isVoxelVisible(voxelPos))
 						{
-							frameNumber += ((_animFrame / 2) + tile->getAnimationOffset() - 4);
+							_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+							blitSprite(_bullet[_projectile->getParticle(i)], SPRITES_BULLET, _projectile->getParticle(i), surface, clip, bulletPositionScreen.x, bulletPositionScreen.y, 16);
 						}
-						else
+						// draw bullet itself
+						voxelPos = _projectile->getPosition(1-i);
+						if (voxelPos.x / 16 == itX &&
+							voxelPos.y / 16 == itY &&
+							voxelPos.z / 24 == itZ &&
+							_save->getTileEngine()->isVoxelVisible(voxelPos))
 						{
-							frameNumber += (_animFrame / 2) + tile->getAnimationOffset();
+							_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+							blitSprite(_bullet[_projectile->getParticle(i)], SPRITES_BULLET, _projectile->getParticle(i), surface, clip, bulletPositionScreen.x, bulletPositionScreen.y, 0);
 						}
-						tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-						tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
-					}
-					if (tile->getSmoke() && tile->isDiscovered(2))
-					{
-						frameNumber = 8 + int(floor((tile->getSmoke() / 6.0) - 0.1)); // see http://www.ufopaedia.org/images/c/cb/Smoke.gif
 
-						if ((_animFrame / 2) + tile->getAnimationOffset() > 3)
-						{
-							frameNumber += ((_animFrame / 2) + tile->getAnimationOffset() - 4);
-						}
-						else
-						{
-							frameNumber += (_animFrame / 2) + tile->getAnimationOffset();
-						}
-						tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-						tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 					}
 				}
 			}
 		}
 	}
+
+	unit = tile->getUnit();
+	// Draw soldier
+	if (unit && (unit->getVisible() || _save->getDebugMode()))
+	{
+		// the part is 0 for small units, large units have parts 1,2 & 3 depending on the relative x/y position of this tile vs the actual unit position.
+		int part = 0;
+		part += tile->getPosition().x - unit->getPosition().x;
+		part += (tile->getPosition().y - unit->getPosition().y)*2;
+		tmpSurface = unit->getCache(&invalid, part);
+		if (tmpSurface)
+		{
+			if (_recording) recordValue(_unitSprites[unit]);
+			Position offset;
+			calculateWalkingOffset(unit, &offset);
+			blitSprite(tmpSurface, SPRITES_UNIT, unit->getId() * 4 + part, surface, clip, screenPosition.x + offset.x, screenPosition.y + offset.y, tileShade);
+			if (unit->getFire() > 0)
+			{
+				frameNumber = 4 + (_animFrame / 2);
+				tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+				blitSprite(tmpSurface, SPRITES_SMOKE, frameNumber, surface, clip, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
+			}
+		}
+	}
+	// if we can see through the floor, draw the soldier below it if it is on stairs
+	Tile *tileBelow = _save->getTile(mapPosition + Position(0, 0, -1));
+	if (itZ > 0 && tile->hasNoFloor(tileBelow))
+	{
+		BattleUnit *tunit = _save->selectUnit(Position(itX, itY, itZ-1));
+		Tile *ttile = _save->getTile(Position(itX, itY, itZ-1));
+		if (tunit && tunit->getVisible() && ttile->getTerrainLevel() < 0 && ttile->isDiscovered(2))
+		{
+			// the part is 0 for small units, large units have parts 1,2 & 3 depending on the relative x/y position of this tile vs the actual unit position.
+			int part = 0;
+			part += ttile->getPosition().x - tunit->getPosition().x;
+			part += (ttile->getPosition().y - tunit->getPosition().y)*2;
+			tmpSurface = tunit->getCache(&invalid, part);
+			if (tmpSurface)
+			{
+				if (_recording) recordValue(_unitSprites[tunit]);
+				Position offset;
+				calculateWalkingOffset(tunit, &offset);
+				offset.y += 24;
+				blitSprite(tmpSurface, SPRITES_UNIT, tunit->getId() * 4 + part, surface, clip, screenPosition.x + offset.x, screenPosition.y + offset.y, ttile->getShade());
+				if (tunit->getArmor()->getSize() > 1)
+				{
+					offset.y += 4;
+				}
+				if (tunit->getFire() > 0)
+				{
+					frameNumber = 4 + (_animFrame / 2);
+					tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+					blitSprite(tmpSurface, SPRITES_SMOKE, frameNumber, surface, clip, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
+				}
+			}
+		}
+	}
+
+	// Draw cursor front
+	if (_cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && _game->getCursor()->getY() < 144)
+	{
+		if (_camera->getViewLevel() == itZ)
+		{
+			if (_cursorType != CT_AIM)
+			{
+				if (unit && (unit->getVisible() || _save->getDebugMode()))
+					frameNumber = 3 + (_animFrame % 2); // yellow box
+				else
+					frameNumber = 3; // red box
+			}else
+			{
+				if (unit && (unit->getVisible() || _save->getDebugMode()))
+					frameNumber = 7 + (_animFrame / 2); // yellow animated crosshairs
+				else
+					frameNumber = 6; // red static crosshairs
+			}
+			tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+			blitSprite(tmpSurface, SPRITES_CURSOR, frameNumber, surface, clip, screenPosition.x, screenPosition.y, 0);
+		}
+		else if (_camera->getViewLevel() > itZ)
+		{
+			frameNumber = 5; // blue box
+			tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+			blitSprite(tmpSurface, SPRITES_CURSOR, frameNumber, surface, clip, screenPosition.x, screenPosition.y, 0);
+		}
+		if (_cursorType > 2 && _camera->getViewLevel() == itZ)
+		{
+			int frame[6] = {0, 0, 0, 11, 13, 15};
+			tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frame[_cursorType] + (_animFrame / 4));
+			blitSprite(tmpSurface, SPRITES_CURSOR, frame[_cursorType] + (_animFrame / 4), surface, clip, screenPosition.x, screenPosition.y, 0);
+		}
+	}
+
+	// Draw waypoints if any on this tile
+	int waypid = 1;
+	for (std::vector<Position>::const_iterator i = _waypoints.begin(); i != _waypoints.end(); ++i)
+	{
+		if ((*i) == mapPosition)
+		{
+			tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(7);
+			blitSprite(tmpSurface, SPRITES_CURSOR, 7, surface, clip, screenPosition.x, screenPosition.y, 0);
+			blitSprite(_waypointNumbers[waypid - 1], SPRITES_WAYPOINT, waypid - 1, surface, clip, screenPosition.x+2, screenPosition.y+2, 0);
+		}
+		waypid++;
+	}
+
+
+	// Draw smoke/fire
+	if (tile->getFire() && tile->isDiscovered(2))
+	{
+		frameNumber = 0; // see http://www.ufopaedia.org/images/c/cb/Smoke.gif
+		if ((_animFrame / 2) + tile->getAnimationOffset() > 3)
+		{
+			frameNumber += ((_animFrame / 2) + tile->getAnimationOffset() - 4);
+		}
+		else
+		{
+			frameNumber += (_animFrame / 2) + tile->getAnimationOffset();
+		}
+		tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+		blitSprite(tmpSurface, SPRITES_SMOKE, frameNumber, surface, clip, screenPosition.x, screenPosition.y, 0);
+	}
+	if (tile->getSmoke() && tile->isDiscovered(2))
+	{
+		frameNumber = 8 + int(floor((tile->getSmoke() / 6.0) - 0.1)); // see http://www.ufopaedia.org/images/c/cb/Smoke.gif
+
+		if ((_animFrame / 2) + tile->getAnimationOffset() > 3)
+		{
+			frameNumber += ((_animFrame / 2) + tile->getAnimationOffset() - 4);
+		}
+		else
+		{
+			frameNumber += (_animFrame / 2) + tile->getAnimationOffset();
+		}
+		tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+		blitSprite(tmpSurface, SPRITES_SMOKE, frameNumber, surface, clip, screenPosition.x, screenPosition.y, 0);
+	}
+}
+
+/**
+ * Draws the things that go on top of all the tiles: the selected unit's arrow and the explosions.
+ * @param surface The surface to draw on.
+ * @param clip Only draw inside this rectangle of the surface (0 for everywhere).
+ */
+void Map::drawOverlays(Surface *surface, const SDL_Rect *clip)
+{
+	Surface *tmpSurface;
+	Position screenPosition, bulletPositionScreen;
+	BattleUnit *unit;
+
 	unit = (BattleUnit*)_save->getSelectedUnit();
 	if (unit && (_save->getSide() == FACTION_PLAYER || _save->getDebugMode()) && unit->getPosition().z <= _camera->getViewLevel())
 	{
@@ -676,9 +822,8 @@ void Map::drawTerrain(Surface *surface)
 		{
 			offset.y += 4;
 		}
-		_arrow->blitNShade(surface, screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2), screenPosition.y + offset.y - _arrow->getHeight() + _animFrame, 0);
+		blitSprite(_arrow, SPRITES_ARROW, 0, surface, clip, screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2), screenPosition.y + offset.y - _arrow->getHeight() + _animFrame, 0);
 	}
-	delete _numWaypid;
 
 	// check if we got big explosions
 	if (explosionInFOV)
@@ -690,25 +835,146 @@ void Map::drawTerrain(Surface *surface)
 				Position voxelPos = (*i)->getPosition();
 				_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 				tmpSurface = _res->getSurfaceSet("X1.PCK")->getFrame((*i)->getCurrentFrame());
-				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 64, bulletPositionScreen.y - 64, 0);
+				blitSprite(tmpSurface, SPRITES_X1, (*i)->getCurrentFrame(), surface, clip, bulletPositionScreen.x - 64, bulletPositionScreen.y - 64, 0);
 			}
 			else if ((*i)->isHit())
 			{
 				Position voxelPos = (*i)->getPosition();
 				_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 				tmpSurface = _res->getSurfaceSet("HIT.PCK")->getFrame((*i)->getCurrentFrame());
-				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
+				blitSprite(tmpSurface, SPRITES_HIT, (*i)->getCurrentFrame(), surface, clip, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
 			}
 			else
 			{
 				Position voxelPos = (*i)->getPosition();
 				_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 				tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame((*i)->getCurrentFrame());
-				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
+				blitSprite(tmpSurface, SPRITES_SMOKE, (*i)->getCurrentFrame(), surface, clip, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
 			}
 		}
 	}
-	surface->unlock();
+}
+
+/**
+ * Draws a sprite on the map, or when recording, only remembers that it would be drawn.
+ * @param sprite The sprite to draw.
+ * @param set The set the sprite comes from.
+ * @param frame The sprite's frame number in its set.
+ * @param surface The surface to draw on.
+ * @param clip Only draw inside this rectangle of the surface (0 for everywhere).
+ * @param x X position on the surface.
+ * @param y Y position on the surface.
+ * @param off Shade offset.
+ * @param half Only draw the right half of the sprite.
+ * @param newBaseColor New base color, plus one (0 keeps the colors).
+ */
+void Map::blitSprite(Surface *sprite, int set, int frame, Surface *surface, const SDL_Rect *clip, int x, int y, int off, bool half, int newBaseColor)
+{
+	if (!_recording)
+	{
+		sprite->blitNShade(surface, x, y, off, half, newBaseColor, clip);
+		return;
+	}
+	recordValue(set);
+	recordValue(frame);
+	recordValue(x);
+	recordValue(y);
+	recordValue(off);
+	recordValue(half);
+	recordValue(newBaseColor);
+	SDL_Rect rect = {(Sint16)(x - surface->getX()), (Sint16)(y - surface->getY()), (Uint16)sprite->getWidth(), (Uint16)sprite->getHeight()};
+	if (_recorded.bounds.w == 0)
+	{
+		_recorded.bounds = rect;
+	}
+	else
+	{
+		_recorded.bounds = unite(_recorded.bounds, rect);
+	}
+}
+
+/**
+ * Draws a part of a tile, recorded by its terrain and frame number.
+ * @param tile The tile.
+ * @param part The part of the tile.
+ * @param surface The surface to draw on.
+ * @param clip Only draw inside this rectangle of the surface (0 for everywhere).
+ * @param x X position on the surface.
+ * @param y Y position on the surface.
+ * @param off Shade offset.
+ * @param half Only draw the right half of the sprite.
+ * @param newBaseColor New base color, plus one (0 keeps the colors).
+ */
+void Map::blitTerrain(Tile *tile, int part, Surface *surface, const SDL_Rect *clip, int x, int y, int off, bool half, int newBaseColor)
+{
+	int mapDataID, mapDataSetID;
+	tile->getMapData(&mapDataID, &mapDataSetID, part);
+	blitSprite(tile->getSprite(part), SPRITES_TERRAIN + mapDataSetID, tile->getSpriteFrame(part), surface, clip, x, y, off, half, newBaseColor);
+}
+
+/**
+ * Adds a value to what is being recorded, for things
+ * that change without changing the sprites that are drawn.
+ * @param value The value.
+ */
+void Map::recordValue(int value)
+{
+	if (_recording)
+	{
+		_recorded.values.push_back(value);
+	}
+}
+
+/**
+ * Adds an area to the list of areas to redraw, merging it with the ones it overlaps.
+ * @param dirty The list of areas.
+ * @param rect The area to add.
+ */
+void Map::addDirtyRect(std::vector<SDL_Rect> *dirty, SDL_Rect rect)
+{
+	if (rect.w == 0 || rect.h == 0)
+		return;
+	bool merged;
+	do
+	{
+		merged = false;
+		for (std::vector<SDL_Rect>::iterator i = dirty->begin(); i != dirty->end(); ++i)
+		{
+			if (intersects(*i, rect))
+			{
+				rect = unite(*i, rect);
+				dirty->erase(i);
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+	dirty->push_back(rect);
+}
+
+/**
+ * Checks if two rectangles overlap.
+ * @param a The first rectangle.
+ * @param b The second rectangle.
+ * @return True if they overlap.
+ */
+bool Map::intersects(const SDL_Rect &a, const SDL_Rect &b)
+{
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+/**
+ * Gets the smallest rectangle that holds two others.
+ * @param a The first rectangle.
+ * @param b The second rectangle.
+ * @return The bounding rectangle.
+ */
+SDL_Rect Map::unite(const SDL_Rect &a, const SDL_Rect &b)
+{
+	int x1 = std::min(a.x, b.x), y1 = std::min(a.y, b.y);
+	int x2 = std::max(a.x + a.w, b.x + b.w), y2 = std::max(a.y + a.h, b.y + b.h);
+	SDL_Rect rect = {(Sint16)x1, (Sint16)y1, (Uint16)(x2 - x1), (Uint16)(y2 - y1)};
+	return rect;
 }
 
 /**
@@ -987,6 +1253,7 @@ void Map::cacheUnit(BattleUnit *unit)
 	unit->getCache(&invalid);
 	if (invalid)
 	{
+		++_unitSprites[unit]; // same surfaces, new pictures
 		// 1 or 4 iterations, depending on unit size
 		for (int i = 0; i < numOfParts; i++)
 		{
@@ -998,8 +1265,8 @@ void Map::cacheUnit(BattleUnit *unit)
 			}
 			unitSprite->setBattleUnit(unit, i);
 
-			BattleItem *rhandItem = unit->getItem("STR_RIGHT_HAND");
-			BattleItem *lhandItem = unit->getItem("STR_LEFT_HAND");
+			BattleItem *rhandItem = unit->getItem(RuleInventory::RIGHT_HAND);
+			BattleItem *lhandItem = unit->getItem(RuleInventory::LEFT_HAND);
 			if (rhandItem)
 			{
 				unitSprite->setBattleItem(rhandItem);
@@ -21,7 +21,9 @@
 
 #include "../Engine/InteractiveSurface.h"
 #include <set>
+#include <map>
 #include <vector>
+#include "Position.h"
 
 namespace OpenXcom
 {
@@ -30,7 +32,6 @@ class ResourcePack;
 class SavedBattleGame;
 class Surface;
 class MapData;
-class Position;
 class Tile;
 class BattleUnit;
 class BulletSprite;
@@ -39,9 +40,32 @@ class Explosion;
 class BattlescapeMessage;
 class Camera;
 class Timer;
+class NumberText;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
 
+/**
+ * The sets the map's sprites come from, so a sprite can be recorded
+ * by its set and frame number. Each terrain gets its own set,
+ * numbered from SPRITES_TERRAIN by its map data set ID.
+ */
+enum SpriteSet { SPRITES_CURSOR, SPRITES_FLOOROB, SPRITES_SMOKE, SPRITES_X1, SPRITES_HIT, SPRITES_BULLET, SPRITES_UNIT, SPRITES_WAYPOINT, SPRITES_ARROW, SPRITES_TERRAIN };
+
+/**
+ * What a tile (or the overlays on top of all tiles) drew on the map last time:
+ * all the sprites with their positions and shades, and the area they cover.
+ */
+struct DrawnArea
+{
+	std::vector<int> values;
+	SDL_Rect bounds;
+	DrawnArea() { bounds.x = bounds.y = 0; bounds.w = bounds.h = 0; }
+	/// Forgets the drawing, keeping the memory for the next one.
+	void clear() { values.clear(); bounds.x = bounds.y = 0; bounds.w = bounds.h = 0; }
+	/// Checks if another drawing differs from this one.
+	bool changed(const DrawnArea &other) const { return bounds.x != other.bounds.x || bounds.y != other.bounds.y || bounds.w != other.bounds.w || bounds.h != other.bounds.h || values != other.values; }
+};
+
 /**
  * Interactive map of the battlescape
  */
@@ -74,6 +98,23 @@ private:
 	int getTerrainLevel(Position pos, int size);
 	std::vector<Position> _waypoints;
 	bool _unitDying;
+	std::vector<NumberText*> _waypointNumbers;
+	std::vector<DrawnArea> _drawnTiles;
+	DrawnArea _drawnOverlays, _recorded;
+	std::vector<std::pair<Tile*, Position> > _screenTiles;
+	std::map<BattleUnit*, int> _unitSprites;
+	Position _drawnOffset;
+	int _drawnEndZ;
+	bool _redrawAll, _recording;
+	void drawTile(Surface *surface, const SDL_Rect *clip, Tile *tile, const Position &screenPosition, const Position &bulletLow, const Position &bulletHigh);
+	void drawOverlays(Surface *surface, const SDL_Rect *clip);
+	static void drawBand(void *data, int begin, int end);
+	void blitSprite(Surface *sprite, int set, int frame, Surface *surface, const SDL_Rect *clip, int x, int y, int off, bool half = false, int newBaseColor = 0);
+	void blitTerrain(Tile *tile, int part, Surface *surface, const SDL_Rect *clip, int x, int y, int off, bool half = false, int newBaseColor = 0);
+	void recordValue(int value);
+	static void addDirtyRect(std::vector<SDL_Rect> *dirty, SDL_Rect rect);
+	static bool intersects(const SDL_Rect &a, const SDL_Rect &b);
+	static SDL_Rect unite(const SDL_Rect &a, const SDL_Rect &b);
 public:
 	/// Creates a new map at the specified position and size.
 	Map(Game *game, int width, int height, int x, int y, int visibleMapHeight);
@@ -17,9 +17,11 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <list>
+#include <climits>
 #include "Pathfinding.h"
 #include "PathfindingNode.h"
 #include "PathfindingOpenSet.h"
+#include "PathfindingClusters.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Ruleset/MapData.h"
@@ -35,7 +37,7 @@ namespace OpenXcom
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0), _pathPreviewed(false)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _generation(0), _clusters(0), _ignoreUnits(false), _epoch(0), _unit(0), _pathPreviewed(false)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
@@ -46,6 +48,7 @@ Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0
 		_save->getTileCoords(i, &p.x, &p.y, &p.z);
 		_nodes.push_back(PathfindingNode(p));
 	}
+	_clusters = new PathfindingClusters(_save, this);
 }
 
 /**
@@ -54,17 +57,38 @@ Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0
  */
 Pathfinding::~Pathfinding()
 {
-	// Nothing more to do here.
+	delete _clusters;
 }
 
 /**
  * Gets the Node on a given position on the map.
+ * Nodes left over from an earlier search are reset on the way.
  * @param pos position
  * @return Pointer to node.
  */
 PathfindingNode *Pathfinding::getNode(const Position& pos)
 {
-	return &_nodes[_save->getTileIndex(pos)];
+	PathfindingNode *node = &_nodes[_save->getTileIndex(pos)];
+	if (node->getGeneration() != _generation)
+	{
+		node->reset(_generation);
+	}
+	return node;
+}
+
+/**
+ * Starts a new search: every node now counts as unvisited, without touching them
+ * until the search gets to them. Only when the search counter wraps around are they all reset.
+ */
+void Pathfinding::startSearch()
+{
+	if (++_generation == INT_MAX)
+	{
+		_generation = 1;
+		for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
+			it->reset(0);
+	}
+	_openSet.clear();
 }
 
 /**
@@ -78,6 +102,7 @@ PathfindingNode *Pathfinding::getNode(const Position& pos)
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
 	_totalTUCost = 0;
+	bool missile = (target != 0 && maxTUCost == -1);
 	// i'm DONE with these out of bounds errors.
 	if (endPosition.x > _save->getMapSizeX() - unit->getArmor()->getSize() || endPosition.y > _save->getMapSizeY() - unit->getArmor()->getSize() || endPosition.x < 0 || endPosition.y < 0) return;
 
@@ -145,6 +170,12 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 
 	_path.clear();
 
+	// the AI looks for paths to the places it found with findReachable, no need to search again
+	if (!missile && !sneak && !_strafeMove && unit->getFaction() != FACTION_PLAYER && reachablePath(unit, endPosition, maxTUCost))
+	{
+		return;
+	}
+
 	// look for a possible fast and accurate bresenham path and skip A*
 	if (startPosition.z == endPosition.z && bresenhamPath(startPosition,endPosition, target, sneak))
 	{
@@ -156,6 +187,22 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 		_path.clear(); // if bresenham failed, we shouldn't keep the path it was attempting, in case A* fails too.
 		_totalTUCost = 0;
 	}
+	// Don't bother with A* if the terrain doesn't connect the two positions at all.
+	std::vector<bool> corridor;
+	if (!_clusters->findCorridor(unit, startPosition, endPosition, &corridor))
+	{
+		return;
+	}
+	// Long AI paths first try to stay within the clusters along the way.
+	if (!corridor.empty() && unit->getFaction() != FACTION_PLAYER)
+	{
+		if (aStarPath(startPosition, endPosition, target, sneak, maxTUCost, &corridor))
+		{
+			return;
+		}
+		_path.clear();
+		_totalTUCost = 0;
+	}
 	// Now try through A*.
 	if (!aStarPath(startPosition, endPosition, target, sneak, maxTUCost))
 	{
@@ -172,18 +219,18 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
  * @param target Target of the path.
  * @param sneak Is the unit sneaking?
  * @param maxTUCost Maximum time units the path can cost.
+ * @param corridor Which clusters the path may go through, or 0 for anywhere.
  * @return True if a path exists, false otherwise.
  */
-bool Pathfinding::aStarPath(const Position &startPosition, const Position &endPosition, BattleUnit *target, bool sneak, int maxTUCost)
+bool Pathfinding::aStarPath(const Position &startPosition, const Position &endPosition, BattleUnit *target, bool sneak, int maxTUCost, const std::vector<bool> *corridor)
 {
-	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	// forget the previous search, so we have to check them all
+	startSearch();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
+	PathfindingOpenSet &openList = _openSet;
 	openList.push(start);
 	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
@@ -211,6 +258,8 @@ bool Pathfinding::aStarPath(const Position &startPosition, const Position &endPo
 			int tuCost = getTUCost(currentPos, direction, &nextPos, _unit, target, missile);
 			if (tuCost >= 255) // Skip unreachable / blocked
 				continue;
+			if (corridor && !(*corridor)[_clusters->getClusterIndex(nextPos)]) // Stay on course
+				continue;
 			if (sneak && _save->getTile(nextPos)->getVisible()) tuCost *= 2; // avoid being seen
 			PathfindingNode *nextNode = getNode(nextPos);
 			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
@@ -300,7 +349,7 @@ int Pathfinding::getTUCost(const Position &startPosition, int direction, Positio
 						belowDestination = _save->getTile(*endPosition + Position(x,y,-1));
 					}
 			}
-			else if (_movementType == MT_FLY && belowDestination && belowDestination->getUnit() && belowDestination->getUnit() != unit)
+			else if (_movementType == MT_FLY && !_ignoreUnits && belowDestination && belowDestination->getUnit() && belowDestination->getUnit() != unit)
 			{
 				// 2 or more voxels poking into this tile = no go
 				if (belowDestination->getUnit()->getHeight() + belowDestination->getUnit()->getFloatHeight() - belowDestination->getTerrainLevel() > 26)
@@ -389,7 +438,7 @@ int Pathfinding::getTUCost(const Position &startPosition, int direction, Positio
 				cost = (int)((double)cost * 1.5);
 			}
 			cost += wallcost;
-			if (_unit->getFaction() == FACTION_HOSTILE && 
+			if (_unit->getFaction() == FACTION_HOSTILE && !_ignoreUnits &&
 				destinationTile->getUnit() &&
 				destinationTile->getUnit() != _unit)
 				cost += 32; // try to find a better path, but don't exclude this path entirely.
@@ -511,7 +560,7 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 			return false;
 	}
 
-	if (part == MapData::O_FLOOR)
+	if (part == MapData::O_FLOOR && !_ignoreUnits)
 	{
 		BattleUnit *unit = tile->getUnit();
 		if (unit == 0 || unit == _unit || unit == missileTarget || unit->isOut()) return false;
@@ -909,14 +958,18 @@ bool Pathfinding::bresenhamPath(const Position& origin, const Position& target,
 std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 {
 	const Position &start = unit->getPosition();
+	_movementType = unit->getArmor()->getMovementType();
 
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
+	if (_reachable.valid && _reachable.unitId == unit->getId() && _reachable.position == start && _reachable.tuMax == tuMax
+		&& _reachable.epoch == _epoch && _reachable.movementType == _movementType)
 	{
-		it->reset();
+		return _reachable.tiles;
 	}
+
+	startSearch();
 	PathfindingNode *startNode = getNode(start);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
+	PathfindingOpenSet &unvisited = _openSet;
 	unvisited.push(startNode);
 	std::vector<PathfindingNode*> reachable;
 	while (!unvisited.empty())
@@ -948,13 +1001,101 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 		reachable.push_back(currentNode);
 	}
 	std::sort(reachable.begin(), reachable.end(), MinNodeCosts());
-	std::vector<int> tiles;
-	tiles.reserve(reachable.size());
+
+	// keep the whole flood around, so the AI can look up paths to these tiles for free
+	if ((int)_reachable.cost.size() != _size)
+	{
+		_reachable.cost.assign(_size, -1);
+		_reachable.prevTile.assign(_size, -1);
+		_reachable.prevDir.assign(_size, -1);
+	}
+	for (std::vector<int>::const_iterator it = _reachable.tiles.begin(); it != _reachable.tiles.end(); ++it)
+	{
+		_reachable.cost[*it] = -1;
+	}
+	_reachable.tiles.clear();
+	_reachable.tiles.reserve(reachable.size());
 	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
 	{
-		tiles.push_back(_save->getTileIndex((*it)->getPosition()));
+		int tile = _save->getTileIndex((*it)->getPosition());
+		_reachable.tiles.push_back(tile);
+		_reachable.cost[tile] = (*it)->getTUCost(false);
+		_reachable.prevTile[tile] = (*it)->getPrevNode() ? _save->getTileIndex((*it)->getPrevNode()->getPosition()) : -1;
+		_reachable.prevDir[tile] = (*it)->getPrevDir();
+	}
+	_reachable.valid = true;
+	_reachable.unitId = unit->getId();
+	_reachable.position = start;
+	_reachable.tuMax = tuMax;
+	_reachable.epoch = _epoch;
+	_reachable.movementType = _movementType;
+	return _reachable.tiles;
+}
+
+/**
+ * Gets the cost to a tile, as found by the last findReachable, if that was for this unit where it stands now.
+ * @param unit The unit.
+ * @param pos The tile position.
+ * @return TU cost, or -1 if the tile wasn't reached (or findReachable wasn't done for this unit).
+ */
+int Pathfinding::getReachableCost(BattleUnit *unit, const Position &pos) const
+{
+	if (!_reachable.valid || _reachable.unitId != unit->getId() || _reachable.position != unit->getPosition() || _reachable.epoch != _epoch)
+		return -1;
+	return _reachable.cost[_save->getTileIndex(pos)];
+}
+
+/**
+ * Sets the path to a tile from the predecessors kept by the last findReachable.
+ * Only possible if that was for this unit, where it stands now, and nothing changed since.
+ * @param unit The unit moving.
+ * @param target The position we want to reach.
+ * @param maxTUCost Maximum time units the path can cost.
+ * @return True if the path was set.
+ */
+bool Pathfinding::reachablePath(BattleUnit *unit, const Position &target, int maxTUCost)
+{
+	if (_reachable.movementType != _movementType)
+		return false;
+	int cost = getReachableCost(unit, target);
+	if (cost == -1 || cost > maxTUCost)
+		return false;
+
+	// paths are stored in reverse order
+	for (int tile = _save->getTileIndex(target); _reachable.prevTile[tile] != -1; tile = _reachable.prevTile[tile])
+	{
+		_path.push_back(_reachable.prevDir[tile]);
 	}
-	return tiles;
+	_totalTUCost = cost;
+	return true;
+}
+
+/**
+ * Forgets the last findReachable. Units moving change the costs,
+ * so this is needed whenever the AI starts thinking again.
+ */
+void Pathfinding::resetReachable()
+{
+	++_epoch;
+}
+
+/**
+ * Marks the map connectivity around a position as out of date.
+ * @param position Center of the change.
+ * @param radius How many tiles around the center changed.
+ */
+void Pathfinding::terrainChanged(const Position &position, int radius)
+{
+	_clusters->terrainChanged(position, radius);
+	++_epoch;
+}
+
+/**
+ * Forgets the map connectivity, for when the map was replaced.
+ */
+void Pathfinding::resetClusters()
+{
+	_clusters->reset();
 }
 
 /**
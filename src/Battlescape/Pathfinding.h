@@ -22,6 +22,7 @@
 #include <vector>
 #include "Position.h"
 #include "../Ruleset/MapData.h"
+#include "PathfindingOpenSet.h"
 
 namespace OpenXcom
 {
@@ -31,6 +32,22 @@ class SavedBattleGame;
 class PathfindingNode;
 class Tile;
 class BattleUnit;
+class PathfindingClusters;
+
+/**
+ * The tiles a unit can reach with its time units, as found by the last flood of the map:
+ * the cheapest cost of each and the step leading there, so paths don't need another search.
+ */
+struct ReachableTiles
+{
+	bool valid;
+	int unitId, tuMax, epoch;
+	Position position;
+	MovementType movementType;
+	std::vector<int> tiles, cost, prevTile;
+	std::vector<char> prevDir;
+	ReachableTiles() : valid(false), unitId(-1), tuMax(0), epoch(0), movementType(MT_WALK) {}
+};
 
 /**
  * A utility class that calculates the shortest path between two points on the battlescape map.
@@ -40,23 +57,34 @@ class Pathfinding
 private:
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
+	int _generation;
+	PathfindingOpenSet _openSet;
 	int _size;
 	std::vector<int> _path;
 	MovementType _movementType;
+	PathfindingClusters *_clusters;
+	bool _ignoreUnits;
+	ReachableTiles _reachable;
+	int _epoch;
+	/// Takes a path from the last flood of the map, if it was from the same spot.
+	bool reachablePath(BattleUnit *unit, const Position &target, int maxTUCost);
 	/// Gets the node at certain position.
 	PathfindingNode *getNode(const Position& pos);
+	/// Starts a new search over the nodes.
+	void startSearch();
 	/// whether a tile blocks a certain movementType
 	bool isBlocked(Tile *tile, const int part, BattleUnit *missileTarget);
 	///Try to find a straight line path between two positions.
 	bool bresenhamPath(const Position& origin, const Position& target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000);
 	///Try to find a path between two positions.
-	bool aStarPath(const Position& origin, const Position& target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000);
+	bool aStarPath(const Position& origin, const Position& target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000, const std::vector<bool> *corridor = 0);
 	bool canFallDown(Tile *destinationTile);
 	bool canFallDown(Tile *destinationTile, int size);
 	BattleUnit *_unit;
 	bool _pathPreviewed;
 	bool _strafeMove;
 	int _totalTUCost;
+	friend class PathfindingClusters;
 public:
 	bool isOnStairs(const Position &startPosition, const Position &endPosition);
 	/// whether or not movement between starttile and endtile is possible in the direction.
@@ -88,8 +116,16 @@ public:
 	void setUnit(BattleUnit *unit) { _unit = unit; };
 	/// Get all reachable tiles, based on cost.
 	std::vector<int> findReachable(BattleUnit *unit, int tuMax);
+	/// Get the cost to a tile from the last findReachable for a unit.
+	int getReachableCost(BattleUnit *unit, const Position &pos) const;
+	/// Forget the last findReachable, for when units have moved.
+	void resetReachable();
 	/// get _totalTUCost; find out whether we can hike somewhere in this turn or not
 	int getTotalTUCost() const { return _totalTUCost; }
+	/// Update the map connectivity around a position after the terrain changed.
+	void terrainChanged(const Position &position, int radius = 0);
+	/// Forget the map connectivity, for when the map was replaced.
+	void resetClusters();
 };
 
 }
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "PathfindingClusters.h"
+#include "Pathfinding.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Ruleset/Armor.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sets up the clusters for a map. Nothing is calculated until a path needs it.
+ * @param save Pointer to the SavedBattleGame.
+ * @param pathfinding Pointer to the Pathfinding used to move between tiles.
+ */
+PathfindingClusters::PathfindingClusters(SavedBattleGame *save, Pathfinding *pathfinding) : _save(save), _pathfinding(pathfinding)
+{
+	_clustersX = (_save->getMapSizeX() + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	_clustersY = (_save->getMapSizeY() + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	_clustersZ = _save->getMapSizeZ();
+}
+
+/**
+ * Deletes the clusters.
+ */
+PathfindingClusters::~PathfindingClusters()
+{
+
+}
+
+/**
+ * Gets the index of the cluster containing a position.
+ * @param pos Position on the map.
+ * @return Cluster index.
+ */
+int PathfindingClusters::getClusterIndex(const Position &pos) const
+{
+	return (pos.z * _clustersY + pos.y / CLUSTER_SIZE) * _clustersX + pos.x / CLUSTER_SIZE;
+}
+
+/**
+ * Gets the number of clusters the map is split into.
+ * @return Number of clusters.
+ */
+int PathfindingClusters::getClusterCount() const
+{
+	return _clustersX * _clustersY * _clustersZ;
+}
+
+/**
+ * Gets the layer of clusters matching the way a unit moves, and its size.
+ * @param unit The unit.
+ * @return Pointer to the layer.
+ */
+PathfindingClusterLayer *PathfindingClusters::getLayer(BattleUnit *unit)
+{
+	int index = (unit->getArmor()->getMovementType() == MT_FLY ? 2 : 0) + (unit->getArmor()->getSize() > 1 ? 1 : 0);
+	PathfindingClusterLayer *layer = &_layers[index];
+	if (layer->clusters.empty())
+	{
+		layer->regions.assign(_save->getMapSizeXYZ(), -1);
+		layer->clusters.resize(getClusterCount());
+	}
+	return layer;
+}
+
+/**
+ * Gets the region a position belongs to, building its cluster if needed.
+ * @param layer The layer to look in.
+ * @param unit The unit moving.
+ * @param pos Position on the map.
+ * @return Region key, unique over the whole layer, or -1 if the unit can never get there.
+ */
+int PathfindingClusters::getRegion(PathfindingClusterLayer *layer, BattleUnit *unit, const Position &pos)
+{
+	int cluster = getClusterIndex(pos);
+	if (!layer->clusters[cluster].valid)
+	{
+		buildCluster(layer, unit, cluster);
+	}
+	int region = layer->regions[_save->getTileIndex(pos)];
+	if (region == -1)
+		return -1;
+	return cluster * CLUSTER_SIZE * CLUSTER_SIZE + region;
+}
+
+/**
+ * Checks if the terrain lets a unit stand at a position.
+ * @param unit The unit.
+ * @param pos Position of the unit.
+ * @return True if the unit fits there.
+ */
+bool PathfindingClusters::canStand(BattleUnit *unit, const Position &pos)
+{
+	int size = unit->getArmor()->getSize();
+	for (int x = 0; x < size; ++x)
+	{
+		for (int y = 0; y < size; ++y)
+		{
+			Tile *tile = _save->getTile(pos + Position(x, y, 0));
+			if (_pathfinding->isBlocked(tile, MapData::O_FLOOR, 0) || _pathfinding->isBlocked(tile, MapData::O_OBJECT, 0))
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Splits a cluster into regions: tiles are in the same region if a step between them
+ * stays inside the cluster. Steps leaving the cluster are kept as exits of their region.
+ * Units are ignored, so anything a unit can reach is also connected here.
+ * @param layer The layer the cluster belongs to.
+ * @param unit A unit moving like the ones the layer is for.
+ * @param cluster Cluster index.
+ */
+void PathfindingClusters::buildCluster(PathfindingClusterLayer *layer, BattleUnit *unit, int cluster)
+{
+	PathfindingCluster &c = layer->clusters[cluster];
+	int minX = (cluster % _clustersX) * CLUSTER_SIZE;
+	int minY = (cluster / _clustersX % _clustersY) * CLUSTER_SIZE;
+	int z = cluster / (_clustersX * _clustersY);
+	int width = std::min(CLUSTER_SIZE, _save->getMapSizeX() - minX);
+	int height = std::min(CLUSTER_SIZE, _save->getMapSizeY() - minY);
+
+	bool ignoreUnits = _pathfinding->_ignoreUnits;
+	bool strafeMove = _pathfinding->_strafeMove;
+	MovementType movementType = _pathfinding->_movementType;
+	BattleUnit *pathUnit = _pathfinding->_unit;
+	_pathfinding->_ignoreUnits = true;
+	_pathfinding->_strafeMove = false;
+	_pathfinding->_movementType = unit->getArmor()->getMovementType();
+	_pathfinding->_unit = unit;
+
+	// union-find over the tiles of the cluster, -1 for tiles no unit gets to
+	std::vector<int> parent(width * height, -1);
+	std::vector<int> open;
+	std::vector<std::pair<int, int> > outside;
+	for (int i = 0; i < width * height; ++i)
+	{
+		if (canStand(unit, Position(minX + i % width, minY + i / width, z)))
+		{
+			parent[i] = i;
+			open.push_back(i);
+		}
+	}
+	while (!open.empty())
+	{
+		int i = open.back();
+		open.pop_back();
+		Position pos(minX + i % width, minY + i / width, z);
+		for (int direction = 0; direction < 10; ++direction)
+		{
+			Position next;
+			if (_pathfinding->getTUCost(pos, direction, &next, unit, 0, false) >= 255)
+				continue;
+			if (next.z != z || next.x < minX || next.x >= minX + width || next.y < minY || next.y >= minY + height)
+			{
+				outside.push_back(std::make_pair(i, _save->getTileIndex(next)));
+				continue;
+			}
+			int j = (next.y - minY) * width + next.x - minX;
+			if (parent[j] == -1)
+			{
+				parent[j] = j;
+				open.push_back(j);
+			}
+			int a = i, b = j;
+			while (parent[a] != a) a = parent[a] = parent[parent[a]];
+			while (parent[b] != b) b = parent[b] = parent[parent[b]];
+			parent[std::max(a, b)] = std::min(a, b);
+		}
+	}
+
+	_pathfinding->_ignoreUnits = ignoreUnits;
+	_pathfinding->_strafeMove = strafeMove;
+	_pathfinding->_movementType = movementType;
+	_pathfinding->_unit = pathUnit;
+
+	// number the regions and find their centers
+	std::vector<int> region(width * height, -1);
+	std::vector<int> tiles;
+	c.centers.clear();
+	for (int i = 0; i < width * height; ++i)
+	{
+		int tile = _save->getTileIndex(Position(minX + i % width, minY + i / width, z));
+		if (parent[i] == -1)
+		{
+			layer->regions[tile] = -1;
+			continue;
+		}
+		int root = i;
+		while (parent[root] != root) root = parent[root];
+		if (region[root] == -1)
+		{
+			region[root] = c.centers.size();
+			c.centers.push_back(Position(0, 0, z));
+			tiles.push_back(0);
+		}
+		region[i] = region[root];
+		layer->regions[tile] = region[i];
+		c.centers[region[i]] += Position(minX + i % width, minY + i / width, 0);
+		tiles[region[i]]++;
+	}
+	for (size_t i = 0; i < c.centers.size(); ++i)
+	{
+		c.centers[i].x /= tiles[i];
+		c.centers[i].y /= tiles[i];
+	}
+
+	c.exits.assign(c.centers.size(), std::vector<int>());
+	for (std::vector<std::pair<int, int> >::const_iterator i = outside.begin(); i != outside.end(); ++i)
+	{
+		c.exits[region[i->first]].push_back(i->second);
+	}
+	for (std::vector<std::vector<int> >::iterator i = c.exits.begin(); i != c.exits.end(); ++i)
+	{
+		std::sort(i->begin(), i->end());
+		i->erase(std::unique(i->begin(), i->end()), i->end());
+	}
+	c.valid = true;
+}
+
+/**
+ * Searches the region graph for a way from one position to another.
+ * This can prove there is no path at all, and for long distances it
+ * also gives the clusters the path should stay in: those along the way
+ * and the ones next to them.
+ * @param unit The unit moving.
+ * @param start Where the unit starts.
+ * @param end Where the unit wants to go.
+ * @param corridor Set to which clusters to search in, left empty for "anywhere".
+ * @return False if the unit can't possibly get there, true otherwise.
+ */
+bool PathfindingClusters::findCorridor(BattleUnit *unit, const Position &start, const Position &end, std::vector<bool> *corridor)
+{
+	corridor->clear();
+	// guided missiles fly no matter how the unit that launched them moves
+	if (unit->getArmor()->getMovementType() != _pathfinding->_movementType)
+		return true;
+
+	PathfindingClusterLayer *layer = getLayer(unit);
+	int startRegion = getRegion(layer, unit, start);
+	int endRegion = getRegion(layer, unit, end);
+	if (startRegion == -1 || endRegion == -1)
+		return true; // odd spot, let the real search sort it out
+	if (startRegion == endRegion)
+		return true;
+
+	const int clusterArea = CLUSTER_SIZE * CLUSTER_SIZE;
+	Position goal = layer->clusters[endRegion / clusterArea].centers[endRegion % clusterArea];
+	std::map<int, double> cost;
+	std::map<int, int> prev;
+	std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int> >, std::greater<std::pair<double, int> > > open;
+	bool unknown = false;
+
+	cost[startRegion] = 0;
+	open.push(std::make_pair(0.0, startRegion));
+	while (!open.empty())
+	{
+		int current = open.top().second;
+		open.pop();
+		if (current == endRegion)
+			break;
+		Position here = layer->clusters[current / clusterArea].centers[current % clusterArea];
+		double hereCost = cost[current];
+		// copy, getting regions can rebuild other clusters
+		std::vector<int> exits = layer->clusters[current / clusterArea].exits[current % clusterArea];
+		for (std::vector<int>::const_iterator i = exits.begin(); i != exits.end(); ++i)
+		{
+			Position pos;
+			_save->getTileCoords(*i, &pos.x, &pos.y, &pos.z);
+			int next = getRegion(layer, unit, pos);
+			if (next == -1)
+			{
+				// stepped onto a tile the other cluster doesn't know about, the graph can't be trusted
+				unknown = true;
+				continue;
+			}
+			const Position &there = layer->clusters[next / clusterArea].centers[next % clusterArea];
+			Position d = there - here;
+			double nextCost = hereCost + 1 + 4 * sqrt((double)(d.x * d.x + d.y * d.y + d.z * d.z));
+			std::map<int, double>::iterator known = cost.find(next);
+			if (known == cost.end() || known->second > nextCost)
+			{
+				cost[next] = nextCost;
+				prev[next] = current;
+				Position g = goal - there;
+				open.push(std::make_pair(nextCost + 4 * sqrt((double)(g.x * g.x + g.y * g.y + g.z * g.z)), next));
+			}
+		}
+	}
+
+	if (prev.find(endRegion) == prev.end())
+		return unknown;
+
+	// short paths are cheap enough to search everywhere
+	Position distance = end - start;
+	if (std::max(std::abs(distance.x), std::abs(distance.y)) < 2 * CLUSTER_SIZE)
+		return true;
+
+	corridor->assign(getClusterCount(), false);
+	for (int region = endRegion; ; region = prev[region])
+	{
+		int cluster = region / clusterArea;
+		int cx = cluster % _clustersX, cy = cluster / _clustersX % _clustersY, cz = cluster / (_clustersX * _clustersY);
+		for (int z = std::max(0, cz - 1); z <= std::min(_clustersZ - 1, cz + 1); ++z)
+		{
+			for (int y = std::max(0, cy - 1); y <= std::min(_clustersY - 1, cy + 1); ++y)
+			{
+				for (int x = std::max(0, cx - 1); x <= std::min(_clustersX - 1, cx + 1); ++x)
+				{
+					(*corridor)[(z * _clustersY + y) * _clustersX + x] = true;
+				}
+			}
+		}
+		if (region == startRegion)
+			break;
+	}
+	return true;
+}
+
+/**
+ * Marks the clusters that could be affected by a terrain change for rebuilding.
+ * Moving between tiles looks at the tiles around them too, so a few extra tiles are included.
+ * @param position Center of the change.
+ * @param radius How many tiles around the center changed.
+ */
+void PathfindingClusters::terrainChanged(const Position &position, int radius)
+{
+	const int margin = radius + 3;
+	int minX = std::max(0, (position.x - margin) / CLUSTER_SIZE), maxX = std::min(_clustersX - 1, (position.x + margin) / CLUSTER_SIZE);
+	int minY = std::max(0, (position.y - margin) / CLUSTER_SIZE), maxY = std::min(_clustersY - 1, (position.y + margin) / CLUSTER_SIZE);
+	int minZ = std::max(0, position.z - 1), maxZ = std::min(_clustersZ - 1, position.z + 1);
+	for (int i = 0; i < 4; ++i)
+	{
+		if (_layers[i].clusters.empty())
+			continue;
+		for (int z = minZ; z <= maxZ; ++z)
+		{
+			for (int y = minY; y <= maxY; ++y)
+			{
+				for (int x = minX; x <= maxX; ++x)
+				{
+					_layers[i].clusters[(z * _clustersY + y) * _clustersX + x].valid = false;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Forgets all clusters, for when the map was replaced.
+ */
+void PathfindingClusters::reset()
+{
+	_clustersX = (_save->getMapSizeX() + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	_clustersY = (_save->getMapSizeY() + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	_clustersZ = _save->getMapSizeZ();
+	for (int i = 0; i < 4; ++i)
+	{
+		_layers[i].regions.clear();
+		_layers[i].clusters.clear();
+	}
+}
+
+}
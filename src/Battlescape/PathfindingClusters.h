@@ -0,0 +1,97 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_PATHFINDINGCLUSTERS_H
+#define OPENXCOM_PATHFINDINGCLUSTERS_H
+
+#include <vector>
+#include "Position.h"
+#include "../Ruleset/MapData.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class Pathfinding;
+class BattleUnit;
+
+/**
+ * One square block of tiles on one level, split up into regions
+ * of tiles that can reach each other without leaving the block.
+ */
+struct PathfindingCluster
+{
+	bool valid;
+	std::vector<Position> centers;
+	std::vector<std::vector<int> > exits;
+	PathfindingCluster() : valid(false) {}
+};
+
+/**
+ * The clusters of the whole map for one movement type and unit size.
+ */
+struct PathfindingClusterLayer
+{
+	std::vector<short> regions;
+	std::vector<PathfindingCluster> clusters;
+};
+
+/**
+ * A coarse graph of the battlescape map that knows which areas connect to which,
+ * looking at the terrain only. It is built lazily, cluster by cluster, and clusters
+ * are rebuilt when the terrain in or around them changes.
+ * Used to turn down paths to unreachable places without flooding the whole map,
+ * and to keep long paths within a corridor of clusters.
+ */
+class PathfindingClusters
+{
+public:
+	static const int CLUSTER_SIZE = 10;
+private:
+	SavedBattleGame *_save;
+	Pathfinding *_pathfinding;
+	PathfindingClusterLayer _layers[4];
+	int _clustersX, _clustersY, _clustersZ;
+	/// Gets the layer for a unit.
+	PathfindingClusterLayer *getLayer(BattleUnit *unit);
+	/// Gets the region a position belongs to.
+	int getRegion(PathfindingClusterLayer *layer, BattleUnit *unit, const Position &pos);
+	/// Splits a cluster up into regions.
+	void buildCluster(PathfindingClusterLayer *layer, BattleUnit *unit, int cluster);
+	/// Checks if a unit could stand on a position.
+	bool canStand(BattleUnit *unit, const Position &pos);
+public:
+	/// Creates the clusters for a map.
+	PathfindingClusters(SavedBattleGame *save, Pathfinding *pathfinding);
+	/// Cleans up the clusters.
+	~PathfindingClusters();
+	/// Gets the cluster a position is in.
+	int getClusterIndex(const Position &pos) const;
+	/// Gets the number of clusters on the map.
+	int getClusterCount() const;
+	/// Finds the clusters a path will have to go through.
+	bool findCorridor(BattleUnit *unit, const Position &start, const Position &end, std::vector<bool> *corridor);
+	/// Marks the clusters around a terrain change for rebuilding.
+	void terrainChanged(const Position &position, int radius);
+	/// Forgets all clusters.
+	void reset();
+};
+
+}
+
+#endif
@@ -27,7 +27,7 @@ namespace OpenXcom
  * Sets up a PathfindingNode.
  * @param pos Position.
  */
-PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _openentry(0)
+PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _generation(0), _checked(false), _openCost(-1)
 {
 
 }
@@ -50,11 +50,13 @@ const Position &PathfindingNode::getPosition() const
 }
 /**
  * Reset node.
+ * @param generation The search the node is now part of.
  */
-void PathfindingNode::reset()
+void PathfindingNode::reset(int generation)
 {
+	_generation = generation;
 	_checked = false;
-	_openentry = 0;
+	_openCost = -1;
 }
 
 /**
@@ -23,45 +23,59 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Creates an empty set.
+ */
+PathfindingOpenSet::PathfindingOpenSet() : _first(0), _end(0), _size(0)
+{
+
+}
+
+/**
+ * Cleans up the set.
  */
 PathfindingOpenSet::~PathfindingOpenSet()
 {
-	while (!_queue.empty())
-	{
-		delete _queue.top();
-		_queue.pop();
-	}
+
 }
 
 /**
- * Keep removing all discarded entries that have come to the top of the queue.
+ * Removes all the entries from the buckets that were used.
  */
-void PathfindingOpenSet::removeDiscarded()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	for (size_t i = 0; i < _end; ++i)
 	{
-		delete _queue.top();
-		_queue.pop();
+		_buckets[i].clear();
 	}
+	_first = 0;
+	_end = 0;
+	_size = 0;
 }
 
 /**
  * Get the node with the least cost.
  * After this call, the node is no longer in the set. It is an error to call this when the set is empty.
+ * Entries left behind when a node was pushed again with a lower cost are skipped.
  * @return A pointer to the node which had the least cost.
  */
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	PathfindingNode *nd = _queue.top()->_node;
-	delete _queue.top();
-	_queue.pop();
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
-	return nd;
+	while (true)
+	{
+		while (_buckets[_first].empty())
+		{
+			++_first;
+		}
+		PathfindingNode *nd = _buckets[_first].back();
+		_buckets[_first].pop_back();
+		if (nd->_openCost == (int)_first)
+		{
+			nd->_openCost = -1;
+			--_size;
+			return nd;
+		}
+	}
 }
 
 /**
@@ -72,13 +86,22 @@ PathfindingNode *PathfindingOpenSet::pop()
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	int cost = node->getTUCost(false) + node->getTUGuess();
+	if (cost < 0)
+		cost = 0;
+	if (_size == 0 || (size_t)cost < _first)
+		_first = cost;
+	if (node->_openCost == -1)
+		++_size;
+	node->_openCost = cost;
+
+	if ((size_t)cost >= _buckets.size())
+	{
+		_buckets.resize(cost + 1);
+	}
+	_buckets[cost].push_back(node);
+	if ((size_t)cost >= _end)
+		_end = cost + 1;
 }
 
 
@@ -19,57 +19,39 @@
 #ifndef OPENXCOM_PATHFINDINGOPENSET_H
 #define OPENXCOM_PATHFINDINGOPENSET_H
 
-#include <queue>
+#include <vector>
+#include <cstddef>
 
 namespace OpenXcom
 {
 
 class PathfindingNode;
 
-struct OpenSetEntry
-{
-	int _cost;
-	PathfindingNode *_node;
-};
-
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
- 	/**
-	 * Compare entries @a *a and @a *b.
-         * @param a Pointer to first entry.
-         * @param b Pointer to second entry.
-	 * @return true If entry @a *b must come before @a *a.
-	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
-	{
-		return b->_cost < a->_cost;
-	}
-};
-
 /**
  * A class that holds references to the nodes to be examined in pathfinding.
+ * Path costs are small integers, so nodes are kept in one bucket per cost
+ * and the buckets are reused from one search to the next.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleanup the set and free allocated memory.
+	/// Creates an empty set.
+	PathfindingOpenSet();
+	/// Cleanup the set.
 	~PathfindingOpenSet();
+	/// Empty the set for a new search, keeping the memory.
+	void clear();
 	/// Get the next node to check.
 	PathfindingNode *pop();
 	/// Add a node in the set.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _size == 0; }
 
 private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
-
-	/// Remove reachable discarded entries.
-	void removeDiscarded();
+	std::vector<std::vector<PathfindingNode*> > _buckets;
+	std::size_t _first, _end;
+	int _size;
 };
 
 }
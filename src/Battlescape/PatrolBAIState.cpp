@@ -134,14 +134,14 @@ void PatrolBAIState::think(BattleAction *action)
 	{
 		action->type = BA_NONE;
 		action->TU = 0;
-		if (Options::getBool("traceAI")) 
+		if (_game->getTraceSetting()) 
 		{
 			Log(LOG_INFO) << "PatrolBAIState::think()? Better not... #" << action->number;
 		}
 		return;
 	}
 
-	if (Options::getBool("traceAI")) 
+	if (_game->getTraceSetting()) 
 	{
 		Log(LOG_INFO) << "PatrolBAIState::think() #" << action->number;
 	}
@@ -149,7 +149,7 @@ void PatrolBAIState::think(BattleAction *action)
 	
 	if (_toNode != 0 && _unit->getPosition() == _toNode->getPosition())
 	{
-		if (Options::getBool("traceAI"))
+		if (_game->getTraceSetting())
 		{
 			Log(LOG_INFO) << "Patrol destination reached!";
 		}
@@ -29,6 +29,7 @@
 #include "../Ruleset/Unit.h"
 #include "../Ruleset/RuleSoldier.h"
 #include "../Ruleset/RuleItem.h"
+#include "../Ruleset/RuleInventory.h"
 #include "../Ruleset/MapData.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/BattleItem.h"
@@ -99,7 +100,7 @@ int Projectile::calculateTrajectory(double accuracy)
 	{
 		offset = 16;
 	}
-	else if(_action.weapon == _action.weapon->getOwner()->getItem("STR_LEFT_HAND") && !_action.weapon->getRules()->isTwoHanded())
+	else if(_action.weapon == _action.weapon->getOwner()->getItem(RuleInventory::LEFT_HAND) && !_action.weapon->getRules()->isTwoHanded())
 	{
 		offset = 8;
 	}
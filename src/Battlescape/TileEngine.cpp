@@ -21,6 +21,8 @@
 #include <climits>
 #include <set>
 #include <functional>
+#include <algorithm>
+#include <iterator>
 #include "TileEngine.h"
 #include <SDL.h>
 #include "BattleAIState.h"
@@ -43,19 +45,40 @@
 #include "../Engine/Options.h"
 #include "ProjectileFlyBState.h"
 #include "../Engine/Logger.h"
+#include "../Engine/ThreadPool.h"
 #include "../aresame.h"
 
 namespace OpenXcom
 {
 
 const int TileEngine::heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
+const Uint8 ThreatUnit::EXPOSURE_UNKNOWN;
+
+/**
+ * Takes the shape of a unit the AI wants to place somewhere.
+ * @param unit The unit.
+ */
+ThreatShape::ThreatShape(BattleUnit *unit) : height(unit->getHeight()), floatHeight(unit->getFloatHeight()), loftemps(unit->getLoftemps()), size(unit->getArmor()->getSize()), out(unit->isOut())
+{
+}
 
 /**
  * Sets up a TileEngine.
  * @param save pointer to SavedBattleGame object.
  */
-TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true)
+TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _lightFalloffSize(-1), _blastFans(BLAST_ELEVATIONS), _personalLighting(true), _raysCast(0), _raysReused(0), _voxelMapSizeX(0), _voxelMapSizeY(0)
 {
+	// directions of the explosion rays: every 5 degrees of elevation, every 3 degrees around
+	for (int fi = 0; fi < BLAST_ELEVATIONS; ++fi)
+	{
+		_blastSinFi[fi] = sin((fi * 5 - 90) * M_PI / 180.0);
+		_blastCosFi[fi] = cos((fi * 5 - 90) * M_PI / 180.0);
+	}
+	for (int te = 0; te < BLAST_DIRECTIONS; ++te)
+	{
+		_blastSinTe[te] = sin(te * 3 * M_PI / 180.0);
+		_blastCosTe[te] = cos(te * 3 * M_PI / 180.0);
+	}
 }
 
 /**
@@ -111,43 +134,41 @@ void TileEngine::calculateTerrainLighting()
 	const int layer = 1; // Static lighting layer.
 	const int fireLightPower = 15; // amount of light a fire generates
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
+	std::vector<LightSource> sources;
 
-	// add lighting of terrain
+	// collect lighting of terrain
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
+		Tile *tile = _save->getTiles()[i];
+
 		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(MapData::O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource())
+		if (tile->getMapData(MapData::O_FLOOR)
+			&& tile->getMapData(MapData::O_FLOOR)->getLightSource())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource(), layer);
+			sources.push_back(LightSource(tile->getPosition(), tile->getMapData(MapData::O_FLOOR)->getLightSource()));
 		}
-		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource())
+		if (tile->getMapData(MapData::O_OBJECT)
+			&& tile->getMapData(MapData::O_OBJECT)->getLightSource())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource(), layer);
+			sources.push_back(LightSource(tile->getPosition(), tile->getMapData(MapData::O_OBJECT)->getLightSource()));
 		}
 
 		// fires
-		if (_save->getTiles()[i]->getFire())
+		if (tile->getFire())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
+			sources.push_back(LightSource(tile->getPosition(), fireLightPower));
 		}
 
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
+		for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
 		{
 			if ((*it)->getRules()->getBattleType() == BT_FLARE)
 			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
+				sources.push_back(LightSource(tile->getPosition(), (*it)->getRules()->getPower()));
 			}
 		}
-
 	}
 
+	updateLightSources(sources, layer);
 }
 
 /**
@@ -158,53 +179,126 @@ void TileEngine::calculateUnitLighting()
 	const int layer = 2; // Dynamic lighting layer.
 	const int personalLightPower = 15; // amount of light a unit generates
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
+	std::vector<LightSource> sources;
 
 	if (_personalLighting)
 	{
-		// add lighting of soldiers
+		// collect lighting of soldiers
 		for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 		{
 			if ((*i)->getFaction() == FACTION_PLAYER && !(*i)->isOut())
 			{
-				addLight((*i)->getPosition(), personalLightPower, layer);
+				sources.push_back(LightSource((*i)->getPosition(), personalLightPower));
 			}
 		}
 	}
+
+	updateLightSources(sources, layer);
 }
 
 /**
- * Adds circular light pattern starting from center and loosing power with distance travelled.
- * @param center
- * @param power
+ * Brings a light layer up to date with a new set of light sources.
+ * Only the sources that appeared, disappeared or moved since the last update touch the layer:
+ * new sources are simply added (light combines by taking the brightest), and the footprint of
+ * each vanished source is cleared and relit by the remaining sources that reach into it.
+ * @param sources The light sources now on this layer. The list is taken over (and left with the old sources).
  * @param layer Light is seperated in 3 layers: Ambient, Static and Dynamic.
  */
-void TileEngine::addLight(const Position &center, int power, int layer)
+void TileEngine::updateLightSources(std::vector<LightSource> &sources, int layer)
 {
-	// only loop through the positive quadrant.
-	for (int x = 0; x <= power; ++x)
+	std::vector<LightSource> &old = _lightSources[layer];
+	std::sort(sources.begin(), sources.end());
+
+	std::vector<LightSource> removed, added;
+	std::set_difference(old.begin(), old.end(), sources.begin(), sources.end(), std::back_inserter(removed));
+	std::set_difference(sources.begin(), sources.end(), old.begin(), old.end(), std::back_inserter(added));
+
+	std::vector<Uint8> &light = _save->getTileLayers()->light[layer];
+	const int sizeX = _save->getMapSizeX(), sizeY = _save->getMapSizeY(), sizeZ = _save->getMapSizeZ();
+
+	for (std::vector<LightSource>::const_iterator i = removed.begin(); i != removed.end(); ++i)
 	{
-		for (int y = 0; y <= power; ++y)
+		int minX = std::max(0, i->center.x - i->power), maxX = std::min(sizeX - 1, i->center.x + i->power);
+		int minY = std::max(0, i->center.y - i->power), maxY = std::min(sizeY - 1, i->center.y + i->power);
+		if (minX > maxX || minY > maxY)
+			continue;
+
+		for (int z = 0; z < sizeZ; ++z)
 		{
-			for (int z = 0; z < _save->getMapSizeZ(); z++)
+			for (int y = minY; y <= maxY; ++y)
 			{
-				int distance = int(floor(sqrt(float(x*x + y*y)) + 0.5));
+				std::fill(light.begin() + (z * sizeY + y) * sizeX + minX, light.begin() + (z * sizeY + y) * sizeX + maxX + 1, 0);
+			}
+		}
 
-				if (_save->getTile(Position(center.x + x,center.y + y, z)))
-					_save->getTile(Position(center.x + x,center.y + y, z))->addLight(power - distance, layer);
+		for (std::vector<LightSource>::const_iterator j = sources.begin(); j != sources.end(); ++j)
+		{
+			if (j->center.x + j->power >= minX && j->center.x - j->power <= maxX
+				&& j->center.y + j->power >= minY && j->center.y - j->power <= maxY)
+			{
+				addLight(*j, layer, minX, minY, maxX, maxY);
+			}
+		}
+	}
+
+	for (std::vector<LightSource>::const_iterator i = added.begin(); i != added.end(); ++i)
+	{
+		addLight(*i, layer, 0, 0, sizeX - 1, sizeY - 1);
+	}
 
-				if (_save->getTile(Position(center.x - x,center.y - y, z)))
-					_save->getTile(Position(center.x - x,center.y - y, z))->addLight(power - distance, layer);
+	old.swap(sources);
+}
 
-				if (_save->getTile(Position(center.x - x,center.y + y, z)))
-					_save->getTile(Position(center.x - x,center.y + y, z))->addLight(power - distance, layer);
+/**
+ * Adds circular light pattern starting from center and loosing power with distance travelled.
+ * The light reaches all levels of the map, and only raises tiles that are darker than it.
+ * @param source The light source.
+ * @param layer Light is seperated in 3 layers: Ambient, Static and Dynamic.
+ * @param minX Left edge of the area to light.
+ * @param minY Top edge of the area to light.
+ * @param maxX Right edge of the area to light.
+ * @param maxY Bottom edge of the area to light.
+ */
+void TileEngine::addLight(const LightSource &source, int layer, int minX, int minY, int maxX, int maxY)
+{
+	const int power = source.power;
+	if (power <= 0)
+		return;
 
-				if (_save->getTile(Position(center.x + x,center.y - y, z)))
-					_save->getTile(Position(center.x + x,center.y - y, z))->addLight(power - distance, layer);
+	// distance falloff for one quadrant, shared by all sources
+	if (power > _lightFalloffSize)
+	{
+		_lightFalloffSize = std::max(power, 15);
+		_lightFalloff.resize((_lightFalloffSize + 1) * (_lightFalloffSize + 1));
+		for (int y = 0; y <= _lightFalloffSize; ++y)
+		{
+			for (int x = 0; x <= _lightFalloffSize; ++x)
+			{
+				_lightFalloff[y * (_lightFalloffSize + 1) + x] = int(floor(sqrt(float(x*x + y*y)) + 0.5));
+			}
+		}
+	}
+
+	std::vector<Uint8> &light = _save->getTileLayers()->light[layer];
+	const int sizeX = _save->getMapSizeX(), sizeY = _save->getMapSizeY(), sizeZ = _save->getMapSizeZ();
+	minX = std::max(std::max(minX, 0), source.center.x - power);
+	maxX = std::min(std::min(maxX, sizeX - 1), source.center.x + power);
+	minY = std::max(std::max(minY, 0), source.center.y - power);
+	maxY = std::min(std::min(maxY, sizeY - 1), source.center.y + power);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const int *falloff = &_lightFalloff[std::abs(y - source.center.y) * (_lightFalloffSize + 1)];
+		for (int x = minX; x <= maxX; ++x)
+		{
+			int value = std::min(power - falloff[std::abs(x - source.center.x)], 255);
+			if (value <= 0)
+				continue;
+			for (int z = 0; z < sizeZ; ++z)
+			{
+				Uint8 &current = light[(z * sizeY + y) * sizeX + x];
+				if (current < value)
+					current = value;
 			}
 		}
 	}
@@ -222,7 +316,6 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 	Position test;
 	int direction;
 	bool swap;
-	std::vector<Position> _trajectory;
 	if (_save->getStrafeSetting() && (unit->getTurretType() > -1)) {
 		direction = unit->getTurretDirection();
 	}
@@ -246,6 +339,28 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 	{
 		++pos.z;
 	}
+
+	if (unit->getFaction() == FACTION_PLAYER)
+	{
+		// the terrain we see only changes when we move, turn or the terrain itself changes
+		FOVCache &cache = _fovCache[unit->getId()];
+		int size = unit->getArmor()->getSize();
+		if (cache.valid && cache.center == center && cache.eyes == pos && cache.direction == direction && cache.size == size)
+		{
+			_raysReused += cache.rays;
+		}
+		else
+		{
+			cache.center = center;
+			cache.eyes = pos;
+			cache.direction = direction;
+			cache.size = size;
+			castTerrainFOV(unit, pos, direction, &cache);
+			_raysCast += cache.rays;
+		}
+		applyTerrainFOV(cache);
+	}
+
 	for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
 	{
 		if (direction%2)
@@ -294,38 +409,6 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 								_save->updateExposedUnits();
 							}
 						}
-
-						if (unit->getFaction() == FACTION_PLAYER)
-						{
-							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
-							// large units have "4 pair of eyes"
-							int size = unit->getArmor()->getSize();
-							for (int xo = 0; xo < size; xo++)
-							{
-								for (int yo = 0; yo < size; yo++)
-								{
-									Position poso = pos + Position(xo,yo,0);
-									_trajectory.clear();
-									int tst = calculateLine(poso, test, true, &_trajectory, unit, false);
-									unsigned int tsize = _trajectory.size();
-									if (tst>127) --tsize; //last tile is blocked thus must be cropped
-									for (unsigned int i = 0; i < tsize; i++)
-									{
-										Position posi = _trajectory.at(i); 
-										//mark every tile of line as visible (as in original)
-										//this is needed because of bresenham narrow stroke. 
-										_save->getTile(posi)->setVisible(+1);
-										_save->getTile(posi)->setDiscovered(true, 2);
-										// walls to the east or south of a visible tile, we see that too
-										Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
-										if (t) t->setDiscovered(true, 0);
-										t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
-										if (t) t->setDiscovered(true, 1);
-									}
-
-								}
-							}
-						}
 					}
 				}
 			}
@@ -360,99 +443,328 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 
 
 /**
- * @brief Find all the soldiers that would see queryingUnit at tile (aka tilePos) and collect some statistics for AI.
- * @param tile the tile to check
- * @param tilePos the position of the tile to check, redundantly
- * @param queryingUnit the unit to temporarily place at tilePos for calculations
- * @return false if the unit couldn't possibly be placed at tile (i.e., something's blocking it), true otherwise
+ * Casts the terrain visibility rays of a unit and stores the result in its cache.
+ * This sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace.
+ * @param unit The unit that is looking.
+ * @param eyes The position the unit is looking from.
+ * @param direction The direction the unit is looking at.
+ * @param cache The cache to fill.
  */
-bool TileEngine::surveyXComThreatToTile(Tile *tile, Position &tilePos, BattleUnit *queryingUnit)
+void TileEngine::castTerrainFOV(BattleUnit *unit, const Position &eyes, int direction, FOVCache *cache)
 {
-	if (tile->soldiersVisible != -1) return true; // already calculated this turn
+	const Position &center = unit->getPosition();
+	Position test;
+	bool swap = (direction==0 || direction==4);
+	int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
+	int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
+	int y1, y2;
+	std::vector<Position> _trajectory;
+	std::vector<int> visits(_save->getMapSizeXYZ(), 0);
 
-	BattleUnit hypotheticalUnit(*queryingUnit); // this is why I needed a copy constructor for BattleUnit
-	// I tried repeatedly to just move queryingUnit without making a copy of it but that caused mysterious crashes in loftemps calculations for 2x2 units. :<
-	
-	if (!_save->setUnitPosition(&hypotheticalUnit, tilePos, true)) 
+	cache->valid = true;
+	cache->rays = 0;
+	cache->touched.assign(_save->getMapSizeXYZ(), false);
+	cache->visibleTiles.clear();
+
+	for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
 	{
-		return false;
+		if (direction%2)
+		{
+			y1 = 0;
+			y2 = MAX_VIEW_DISTANCE;
+		}
+		else
+		{
+			y1 = -x;
+			y2 = x;
+		}
+		for (int y = y1; y <= y2; ++y)
+		{
+			if (x*x + y*y > MAX_VIEW_DISTANCE*MAX_VIEW_DISTANCE)
+				continue;
+			test.x = center.x + signX[direction]*(swap?y:x);
+			test.y = center.y + signY[direction]*(swap?x:y);
+			for (int z = 0; z < _save->getMapSizeZ(); z++)
+			{
+				test.z = z;
+				if (!_save->getTile(test))
+					continue;
+				// large units have "4 pair of eyes"
+				for (int xo = 0; xo < cache->size; xo++)
+				{
+					for (int yo = 0; yo < cache->size; yo++)
+					{
+						Position poso = eyes + Position(xo,yo,0);
+						_trajectory.clear();
+						int tst = calculateLine(poso, test, true, &_trajectory, unit, false);
+						++cache->rays;
+						unsigned int tsize = _trajectory.size();
+						// remember everything the ray went through, including the tile that blocked it
+						for (unsigned int i = 0; i < tsize; i++)
+						{
+							if (_save->getTile(_trajectory[i]))
+							{
+								cache->touched[_save->getTileIndex(_trajectory[i])] = true;
+							}
+						}
+						if (tst>127) --tsize; //last tile is blocked thus must be cropped
+						for (unsigned int i = 0; i < tsize; i++)
+						{
+							//mark every tile of line as visible (as in original)
+							//this is needed because of bresenham narrow stroke.
+							++visits[_save->getTileIndex(_trajectory[i])];
+						}
+					}
+				}
+			}
+		}
 	}
-	
-	std::map<int, BattleUnit*> originalTileUnits;
-	std::vector<Position> toBackUp;
-	
-	toBackUp.push_back(hypotheticalUnit.getPosition());
-	toBackUp.push_back(hypotheticalUnit.getTile()->getPosition()); // no such thing as too many backups??? .__.
-	toBackUp.push_back(hypotheticalUnit.getLastPosition());
-	toBackUp.push_back(tilePos);
-	
-	// back up the BattleUnit pointers from the live tile data
-	for (std::vector<Position>::iterator which = toBackUp.begin(); which != toBackUp.end(); ++which)
+
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		for (int x = hypotheticalUnit.getArmor()->getSize()-1; x >= 0; x--)
+		if (visits[i])
 		{
-			for (int y = hypotheticalUnit.getArmor()->getSize()-1; y >= 0; y--)
+			cache->visibleTiles.push_back(std::make_pair(i, visits[i]));
+		}
+	}
+}
+
+/**
+ * Marks the tiles in a unit's cached field of view as visible and discovered.
+ * @param cache The cached field of view.
+ */
+void TileEngine::applyTerrainFOV(const FOVCache &cache)
+{
+	for (std::vector<std::pair<int, int> >::const_iterator i = cache.visibleTiles.begin(); i != cache.visibleTiles.end(); ++i)
+	{
+		Tile *tile = _save->getTiles()[i->first];
+		tile->setVisible(i->second);
+		tile->setDiscovered(true, 2);
+		// walls to the east or south of a visible tile, we see that too
+		Tile* t = _save->getTile(tile->getPosition() + Position(1, 0, 0));
+		if (t) t->setDiscovered(true, 0);
+		t = _save->getTile(tile->getPosition() + Position(0, 1, 0));
+		if (t) t->setDiscovered(true, 1);
+	}
+}
+
+/**
+ * Invalidates the cached field of view of all units that looked through the given area,
+ * so it gets recalculated next time.
+ * @param position The position of the changed terrain.
+ * @param radius How many tiles around the position have changed.
+ */
+void TileEngine::invalidateFOV(const Position &position, int radius)
+{
+	// blockage checks look at the walls of neighbouring tiles too
+	int r = radius + 1;
+	for (std::map<int, FOVCache>::iterator i = _fovCache.begin(); i != _fovCache.end(); ++i)
+	{
+		FOVCache &cache = i->second;
+		if (!cache.valid || distance(position, cache.center) > MAX_VIEW_DISTANCE + r + 1)
+			continue;
+		for (int x = -r; x <= r && cache.valid; ++x)
+		{
+			for (int y = -r; y <= r && cache.valid; ++y)
 			{
-				Position pos = *which;
-				pos.x += x;
-				pos.y += y;
-				
-				Tile *tileToSave = _save->getTile(pos);
-				if (!tileToSave) continue; // out of map bounds?
-				
-				int index = _save->getTileIndex(pos);				
-				originalTileUnits[index] = tileToSave->getUnit();
+				for (int z = -1; z <= 1 && cache.valid; ++z)
+				{
+					Position p = position + Position(x, y, z);
+					if (_save->getTile(p) && cache.touched[_save->getTileIndex(p)])
+					{
+						cache.valid = false;
+					}
+				}
 			}
 		}
 	}
+}
 
+/**
+ * Builds the voxel map: a packed bitmap of all the terrain voxels on the battlefield,
+ * laid out as rows of 16 voxels (one tile wide) like the LOFTEMPS themselves.
+ * This lets voxelCheck reject empty space with a single lookup.
+ */
+void TileEngine::buildVoxelMap()
+{
+	_voxelMapSizeX = _save->getMapSizeX();
+	_voxelMapSizeY = _save->getMapSizeY();
+	_voxelMap.assign(_save->getMapSizeXYZ() * 12 * 16, 0);
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		updateVoxelMap(_save->getTiles()[i]);
+	}
+}
 
-#if 0
-	// this block of code would make sure that the unit in question wouldn't occlude its own LOS checks
-	// since the LOS checks happen from soldiers to the hypothetical unit, this is possible, I think
-	// however, this code also causes the game to crash in other parts of the code for mysterious reasons
-	for (int x = hypotheticalUnit.getArmor()->getSize()-1; x >= 0; x--)
+/**
+ * Updates the voxel map rows of a single tile, after its terrain or doors changed.
+ * Open ufo doors are left out, like voxelCheck does.
+ * @param tile The tile to update.
+ */
+void TileEngine::updateVoxelMap(Tile *tile)
+{
+	Position voxel(tile->getPosition().x * 16, tile->getPosition().y * 16, tile->getPosition().z * 24);
+	for (int layer = 0; layer < 12; ++layer)
 	{
-		for (int y = hypotheticalUnit.getArmor()->getSize()-1; y >= 0; y--)
+		voxel.z = tile->getPosition().z * 24 + layer * 2;
+		for (int y = 0; y < 16; ++y)
 		{
-			Position pos = hypotheticalUnit.getPosition();
-			pos.x += x;
-			pos.y += y;
-
-			Tile *zeroMe = _save->getTile(pos);
-			assert (!zeroMe || zeroMe->getUnit() == queryingUnit);
-			if (zeroMe) zeroMe->setUnit(0);
+			Uint16 row = 0;
+			for (int part = 0; part < 4; ++part)
+			{
+				MapData *mp = tile->getMapData(part);
+				if (mp && !tile->isUfoDoorOpen(part))
+				{
+					row |= _voxelData->at(mp->getLoftID(layer) * 16 + y);
+				}
+			}
+			voxel.y = tile->getPosition().y * 16 + y;
+			_voxelMap[getVoxelMapIndex(voxel)] = row;
 		}
 	}
-#endif
+}
 
-#ifdef _DEBUG
-	// sanity-check the tile data...
-	int count = 0;
-	for (int i = 0; i < _save->getMapSizeX() * _save->getMapSizeY() * _save->getMapSizeZ(); ++i)
+/**
+ * Updates all the cached terrain data around a position, after its terrain changed
+ * (doors opening or closing, parts getting destroyed).
+ * @param position The position of the changed terrain.
+ * @param radius How many tiles around the position have changed.
+ */
+void TileEngine::terrainChanged(const Position &position, int radius)
+{
+	invalidateFOV(position, radius);
+	invalidateXComThreat(position, radius);
+	if (_save->getPathfinding())
+	{
+		_save->getPathfinding()->terrainChanged(position, radius);
+	}
+	if (!_voxelMap.empty())
 	{
-		if (_save->getTiles()[i]->getUnit() == queryingUnit)
+		for (int x = position.x - radius; x <= position.x + radius; ++x)
 		{
-			++count;
+			for (int y = position.y - radius; y <= position.y + radius; ++y)
+			{
+				Tile *tile = _save->getTile(Position(x, y, position.z));
+				if (tile)
+				{
+					updateVoxelMap(tile);
+				}
+			}
 		}
 	}
-	if (count != queryingUnit->getArmor()->getSize()*queryingUnit->getArmor()->getSize())
+}
+
+/**
+ * Forgets everything cached about the terrain, for when a new map gets loaded.
+ */
+void TileEngine::resetTerrainCache()
+{
+	_fovCache.clear();
+	_voxelMap.clear();
+	_threatUnits.clear();
+	for (int layer = 0; layer < LIGHTLAYERS; ++layer)
+	{
+		_lightSources[layer].clear();
+	}
+}
+
+/**
+ * Gets the number of terrain visibility rays that had to be cast this turn.
+ * @return Number of rays.
+ */
+int TileEngine::getRaysCast() const
+{
+	return _raysCast;
+}
+
+/**
+ * Gets the number of terrain visibility rays that were reused from the cache this turn.
+ * @return Number of rays.
+ */
+int TileEngine::getRaysReused() const
+{
+	return _raysReused;
+}
+
+/**
+ * Resets the field of view statistics, at the start of each turn.
+ */
+void TileEngine::resetFOVStatistics()
+{
+	_raysCast = 0;
+	_raysReused = 0;
+}
+
+/**
+ * @brief Find all the soldiers that would see queryingUnit at tile (aka tilePos) and collect some statistics for AI.
+ * The map itself is not touched: the unit is only placed there hypothetically, so several tiles can be surveyed at once.
+ * @param tile the tile to check
+ * @param tilePos the position of the tile to check, redundantly
+ * @param queryingUnit the unit to hypothetically place at tilePos for calculations
+ * @return false if the unit couldn't possibly be placed at tile (i.e., something's blocking it), true otherwise
+ */
+bool TileEngine::surveyXComThreatToTile(Tile *tile, Position &tilePos, BattleUnit *queryingUnit)
+{
+	prepareXComThreat(queryingUnit);
+	return surveyTile(tile, tilePos, queryingUnit);
+}
+
+/**
+ * Gets the threat field ready for surveys on behalf of a unit. The tile threat data and the
+ * exposures depend on the shape of the unit placed on the tiles, so the tile threat data is
+ * recalculated when a differently shaped unit asks, and every X-Com unit gets its exposures
+ * for that shape. This must happen before the surveys go to the worker threads.
+ * @param queryingUnit The unit to hypothetically place on the tiles.
+ */
+void TileEngine::prepareXComThreat(BattleUnit *queryingUnit)
+{
+	ThreatShape shape(queryingUnit);
+	if (!(shape == _threatShape))
+	{
+		_threatShape = shape;
+		_save->getTileLayers()->resetThreat();
+	}
+	for (std::map<int, ThreatUnit>::iterator i = _threatUnits.begin(); i != _threatUnits.end(); ++i)
 	{
-		Log(LOG_ERROR) << count << " tiles are occupied by " << queryingUnit->getType() << " #" << queryingUnit->getId() << " and that is messed up.";
+		if (i->second.xcom && i->second.exposure.find(_threatShape) == i->second.exposure.end())
+		{
+			i->second.exposure[_threatShape].assign(_save->getMapSizeXYZ(), ThreatUnit::EXPOSURE_UNKNOWN);
+		}
 	}
-#endif
+}
+
+/**
+ * Surveys one tile for the AI, see surveyXComThreatToTile().
+ * The threat field has to be prepared for the querying unit already.
+ * @param tile the tile to check
+ * @param tilePos the position of the tile to check, redundantly
+ * @param queryingUnit the unit to hypothetically place at tilePos for calculations
+ * @return false if the unit couldn't possibly be placed at tile, true otherwise
+ */
+bool TileEngine::surveyTile(Tile *tile, const Position &tilePos, BattleUnit *queryingUnit)
+{
+	TileThreat *threat = tile->getThreat();
+	if (threat->soldiersVisible != -1) return true; // already calculated this turn
+
+	BattleUnit hypotheticalUnit(*queryingUnit); // this is why I needed a copy constructor for BattleUnit
 	
-	_save->setUnitPosition(&hypotheticalUnit, tilePos); // updates the unit and the tiles
-	//_save->setUnitPosition(&hypotheticalUnit, tilePos); // reset its lastPosition too
+	if (!_save->setUnitPosition(&hypotheticalUnit, tilePos, true)) 
+	{
+		return false;
+	}
 
-		
-	tile->soldiersVisible = 0; // we're actually not updating the other three tiles of a 2x2 unit because the AI code is going to ignore them anyway for now
-	tile->closestSoldierDSqr = INT_MAX;
-	tile->closestAlienDSqr = INT_MAX;
-	tile->meanSoldierDSqr = INT_MAX;
-	tile->totalExposure = 0;
+	// the copy only stands at tilePos as far as its own exposure checks are concerned, see voxelCheck()
+	hypotheticalUnit.setPosition(tilePos);
+	hypotheticalUnit.setTile(tile, _save->getTile(tilePos + Position(0, 0, -1)));
+
+	threat->soldiersVisible = 0; // we're actually not updating the other three tiles of a 2x2 unit because the AI code is going to ignore them anyway for now
+	threat->closestSoldierDSqr = INT_MAX;
+	threat->closestAlienDSqr = INT_MAX;
+	threat->meanSoldierDSqr = INT_MAX;
+	threat->totalExposure = 0;
 	
 	int dsqrTotal = 0;
+	int index = _save->getTileIndex(tilePos);
 	
 	//Position targetVoxel = getSightOriginVoxel(&hypotheticalUnit); // relevant if trying to use calculateLine() which doesn't seem to cooperate anyway!
 	Position targetVoxel(0,0,0);
@@ -476,41 +788,222 @@ bool TileEngine::surveyXComThreatToTile(Tile *tile, Position &tilePos, BattleUni
 		// this works OK but we don't need to try all those rays for this tactical assessment
 		//if ((*i)->getFaction() == FACTION_PLAYER && canTargetUnit(&originVoxel, tile, &targetVoxel, *i))		
 		// this should be the best, a routine that gives us the degree of exposure while economizing raytraces:
-		int exposure;
-		if ((*i)->getFaction() == FACTION_PLAYER && (exposure = checkVoxelExposure(&originVoxel, tile, *i, &hypotheticalUnit)))
+		int exposure = 0;
+		if ((*i)->getFaction() == FACTION_PLAYER)
+		{
+			// the soldier's exposures are kept for as long as it stays where it is, see updateXComThreat()
+			std::map<int, ThreatUnit>::iterator source = _threatUnits.find((*i)->getId());
+			std::map<ThreatShape, std::vector<Uint8> >::iterator exposures;
+			if (source != _threatUnits.end() && source->second.xcom && source->second.eyes == originVoxel
+				&& (exposures = source->second.exposure.find(_threatShape)) != source->second.exposure.end())
+			{
+				Uint8 &known = exposures->second[index];
+				if (known == ThreatUnit::EXPOSURE_UNKNOWN)
+				{
+					known = checkVoxelExposure(&originVoxel, tile, *i, &hypotheticalUnit);
+				}
+				exposure = known;
+			}
+			else
+			{
+				exposure = checkVoxelExposure(&originVoxel, tile, *i, &hypotheticalUnit);
+			}
+		}
+		if (exposure)
 		{
-			++tile->soldiersVisible;
-			tile->totalExposure += exposure;
+			++threat->soldiersVisible;
+			threat->totalExposure += exposure;
 
-			if (dsqr < tile->closestSoldierDSqr)
+			if (dsqr < threat->closestSoldierDSqr)
 			{
-				tile->closestSoldierDSqr = dsqr;
-				tile->closestSoldierPos = (*i)->getPosition();
+				threat->closestSoldierDSqr = dsqr;
+				threat->closestSoldierPos = (*i)->getPosition();
 			}
 			
 			dsqrTotal += dsqr;
 		}
 
-		if ((*i)->getFaction() == FACTION_HOSTILE && dsqr < tile->closestAlienDSqr) tile->closestAlienDSqr = dsqr;
+		if ((*i)->getFaction() == FACTION_HOSTILE && dsqr < threat->closestAlienDSqr) threat->closestAlienDSqr = dsqr;
 	}
 	
-	tile->meanSoldierDSqr = tile->soldiersVisible ? (dsqrTotal / tile->soldiersVisible) : 0;
+	threat->meanSoldierDSqr = threat->soldiersVisible ? (dsqrTotal / threat->soldiersVisible) : 0;
 	
-	//if (tile->_soldiersVisible == 0 && tile->getVisible()) { Log(LOG_WARNING) << "Visible tile returned !canTargetTile() for all soldiers."; }
+	//if (threat->soldiersVisible == 0 && tile->getVisible()) { Log(LOG_WARNING) << "Visible tile returned !canTargetTile() for all soldiers."; }
 
-	// restore tile data
-	for (std::map<int,BattleUnit*>::iterator i = originalTileUnits.begin(); i != originalTileUnits.end(); ++i)
+	if (threat->soldiersVisible == 0)
 	{
-		_save->getTiles()[i->first]->setUnit(i->second);
+		threat->closestSoldierDSqr = -1; 
+		threat->closestSoldierPos = Position(INT_MAX, INT_MAX, INT_MAX);
 	}
 	
-	if (tile->soldiersVisible == 0)
+	return true;
+}
+
+/**
+ * Everything the threat survey jobs need to know.
+ */
+struct ThreatSurveyJob
+{
+	TileEngine *engine;
+	std::vector<Tile*> *tiles;
+	BattleUnit *queryingUnit;
+};
+
+/**
+ * Thread pool entry point for surveying one tile.
+ * @param data Pointer to the ThreatSurveyJob.
+ * @param index Index of the tile in the job.
+ */
+void TileEngine::surveyXComThreat(void *data, int index)
+{
+	ThreatSurveyJob *job = (ThreatSurveyJob*)data;
+	Tile *tile = (*job->tiles)[index];
+	job->engine->surveyTile(tile, tile->getPosition(), job->queryingUnit);
+}
+
+/**
+ * Surveys a batch of tiles for the AI at once, spread over the worker threads.
+ * The results end up in the tiles' threat data just like single surveys do, and
+ * they don't depend on the order the tiles are done in.
+ * @param tiles The tiles to check; tiles that are already surveyed are skipped.
+ * @param queryingUnit The unit to hypothetically place on the tiles.
+ */
+void TileEngine::surveyXComThreatToTiles(const std::vector<Tile*> &tiles, BattleUnit *queryingUnit)
+{
+	std::vector<Tile*> todo;
+	for (std::vector<Tile*>::const_iterator i = tiles.begin(); i != tiles.end(); ++i)
 	{
-		tile->closestSoldierDSqr = -1; 
-		tile->closestSoldierPos = Position(INT_MAX, INT_MAX, INT_MAX);
+		if ((*i)->getThreat()->soldiersVisible == Tile::NOT_CALCULATED)
+		{
+			todo.push_back(*i);
+		}
+	}
+	// two threads must never survey the same tile
+	std::sort(todo.begin(), todo.end());
+	todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+	if (todo.empty())
+		return;
+	// the voxel map is built lazily, do it before the threads get to it
+	if (_voxelMap.empty())
+	{
+		buildVoxelMap();
+	}
+	prepareXComThreat(queryingUnit);
+
+	ThreatSurveyJob job;
+	job.engine = this;
+	job.tiles = &todo;
+	job.queryingUnit = queryingUnit;
+	ThreadPool::getInstance()->run(surveyXComThreat, &job, todo.size());
+}
+
+/**
+ * Updates the AI's threat field after units moved, went down or changed sides:
+ * the exposures to X-Com units that moved are forgotten, and the threat data of the tiles
+ * around every unit that moved is recalculated the next time it's needed.
+ * Everything else stays as it was surveyed, so this is cheap to call before every AI action.
+ */
+void TileEngine::updateXComThreat()
+{
+	std::set<int> current;
+	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if ((*i)->isOut() || ((*i)->getFaction() != FACTION_PLAYER && (*i)->getFaction() != FACTION_HOSTILE))
+			continue;
+		bool xcom = (*i)->getFaction() == FACTION_PLAYER;
+		Position eyes = xcom ? getSightOriginVoxel(*i) : (*i)->getPosition();
+		current.insert((*i)->getId());
+		std::map<int, ThreatUnit>::iterator known = _threatUnits.find((*i)->getId());
+		if (known != _threatUnits.end())
+		{
+			if (known->second.xcom == xcom && known->second.eyes == eyes)
+				continue;
+			invalidateThreatAround(known->second.position);
+		}
+		ThreatUnit &unit = _threatUnits[(*i)->getId()];
+		unit.position = (*i)->getPosition();
+		unit.eyes = eyes;
+		unit.xcom = xcom;
+		unit.exposure.clear();
+		invalidateThreatAround(unit.position);
+	}
+	for (std::map<int, ThreatUnit>::iterator i = _threatUnits.begin(); i != _threatUnits.end();)
+	{
+		if (current.find(i->first) == current.end())
+		{
+			invalidateThreatAround(i->second.position);
+			_threatUnits.erase(i++);
+		}
+		else
+		{
+			++i;
+		}
 	}
-	
-	return true;
+}
+
+/**
+ * Forgets the whole threat field, for a new turn or a new map.
+ */
+void TileEngine::resetXComThreat()
+{
+	_threatUnits.clear();
+	_save->getTileLayers()->resetThreat();
+}
+
+/**
+ * Forgets the exposures to the X-Com units that could be looking through changed terrain.
+ * @param position The position of the changed terrain.
+ * @param radius How many tiles around the position have changed.
+ */
+void TileEngine::invalidateXComThreat(const Position &position, int radius)
+{
+	for (std::map<int, ThreatUnit>::iterator i = _threatUnits.begin(); i != _threatUnits.end(); ++i)
+	{
+		if (i->second.xcom && distance(position, i->second.position) <= MAX_VIEW_DISTANCE + radius + 1)
+		{
+			for (std::map<ThreatShape, std::vector<Uint8> >::iterator j = i->second.exposure.begin(); j != i->second.exposure.end(); ++j)
+			{
+				j->second.assign(j->second.size(), ThreatUnit::EXPOSURE_UNKNOWN);
+			}
+			invalidateThreatAround(i->second.position);
+		}
+	}
+}
+
+/**
+ * Marks the threat data of all tiles within sight of a position as not calculated.
+ * @param position The position.
+ */
+void TileEngine::invalidateThreatAround(const Position &position)
+{
+	std::vector<TileThreat> &threat = _save->getTileLayers()->threat;
+	int minX = std::max(0, position.x - MAX_VIEW_DISTANCE), maxX = std::min(_save->getMapSizeX() - 1, position.x + MAX_VIEW_DISTANCE);
+	int minY = std::max(0, position.y - MAX_VIEW_DISTANCE), maxY = std::min(_save->getMapSizeY() - 1, position.y + MAX_VIEW_DISTANCE);
+	for (int z = 0; z < _save->getMapSizeZ(); ++z)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int x = minX; x <= maxX; ++x)
+			{
+				TileThreat &t = threat[_save->getTileIndex(Position(x, y, z))];
+				t.soldiersVisible = Tile::NOT_CALCULATED;
+				t.closestSoldierDSqr = Tile::NOT_CALCULATED;
+			}
+		}
+	}
+}
+
+/**
+ * Checks if a unit's footprint covers a position.
+ * @param unit The unit.
+ * @param pos The position to check.
+ * @return True if the unit stands on that position.
+ */
+bool TileEngine::unitOccupies(BattleUnit *unit, const Position &pos) const
+{
+	const Position &unitPos = unit->getPosition();
+	int size = unit->getArmor()->getSize();
+	return pos.z == unitPos.z && pos.x >= unitPos.x && pos.x < unitPos.x + size && pos.y >= unitPos.y && pos.y < unitPos.y + size;
 }
 
 /**
@@ -601,7 +1094,7 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 	Position targetVoxel = Position((tile->getPosition().x * 16) + 7, (tile->getPosition().y * 16) + 8, tile->getPosition().z * 24);
 	Position scanVoxel;
 	std::vector<Position> _trajectory;
-	BattleUnit *otherUnit = tile->getUnit();
+	BattleUnit *otherUnit = excludeAllBut ? excludeAllBut : tile->getUnit();
 	if (otherUnit == 0) return 0; //no unit in this tile, even if it elevated and appearing in it.
 	if (otherUnit == excludeUnit) return 0; //skip self
 
@@ -1015,6 +1508,7 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
 		int rndPower = RNG::generate(power/4, (power*3)/4); //RNG::boxMuller(power, power/6)
 		if (tile->damage(part, rndPower))
 			_save->setObjectiveDestroyed(true);
+		terrainChanged(tile->getPosition());
 	}
 	else if (part == 4)
 	{
@@ -1074,9 +1568,99 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
 	return bu;
 }
 
+/**
+ * Everything the explosion ray tracing jobs need to know.
+ */
+struct BlastJob
+{
+	TileEngine *engine;
+	std::vector<BlastFan> *fans;
+	Position center;
+	int power, maxRadius, vertdec;
+	ItemDamageType type;
+};
+
+/**
+ * Thread pool entry point for tracing one fan of explosion rays.
+ * @param data Pointer to the BlastJob.
+ * @param fan Elevation of the fan.
+ */
+void TileEngine::traceBlastFan(void *data, int fan)
+{
+	BlastJob *job = (BlastJob*)data;
+	job->engine->traceBlastFan(&(*job->fans)[fan], fan, job->center, job->power, job->type, job->maxRadius, job->vertdec);
+}
+
+/**
+ * Traces all explosion rays at one elevation, recording which tiles they reach and with how much power.
+ * This only reads the terrain, so the fans can be traced at the same time.
+ * @param fan Where to store the tiles reached.
+ * @param elevation Index of the elevation of the rays.
+ * @param center Tile where the explosion is centered.
+ * @param power Power of the explosion.
+ * @param type The damage type of the explosion.
+ * @param maxRadius The maximum radius of the explosion.
+ * @param vertdec Power lost when the explosion changes level.
+ */
+void TileEngine::traceBlastFan(BlastFan *fan, int elevation, const Position &center, int power, ItemDamageType type, int maxRadius, int vertdec)
+{
+	double centerZ = center.z + 0.5;
+	double centerX = center.x + 0.5;
+	double centerY = center.y + 0.5;
+	double sin_fi = _blastSinFi[elevation];
+	double cos_fi = _blastCosFi[elevation];
+
+	fan->steps.clear();
+	fan->rayEnds.clear();
+
+	for (int te = 0; te < BLAST_DIRECTIONS; ++te)
+	{
+		double cos_te = _blastCosTe[te];
+		double sin_te = _blastSinTe[te];
+
+		Tile *origin = _save->getTile(center);
+		double l = 0;
+		double vx, vy, vz;
+		int tileX, tileY, tileZ;
+		int power_ = power + 1;
+
+		while (power_ > 0 && l <= maxRadius)
+		{
+			vx = centerX + l * sin_te * cos_fi;
+			vy = centerY + l * cos_te * cos_fi;
+			vz = centerZ + l * sin_fi;
+
+			tileZ = int(floor(vz));
+			tileX = int(floor(vx));
+			tileY = int(floor(vy));
+
+			Tile *dest = _save->getTile(Position(tileX, tileY, tileZ));
+			if (!dest) break; // out of map!
+
+			// blockage by terrain is deducted from the explosion power
+			if (std::abs(l) > 0) // no need to block epicentrum
+			{
+				power_ -= (horizontalBlockage(origin, dest, type) + verticalBlockage(origin, dest, type)) * 2;
+				power_ -= 10; // explosive damage decreases by 10 per tile
+				if (origin->getPosition().z != tileZ) power_ -= vertdec; //3d explosion factor
+			}
+
+			if (power_ > 0)
+			{
+				fan->steps.push_back(std::make_pair(_save->getTileIndex(dest->getPosition()), power_));
+			}
+			origin = dest;
+			l++;
+		}
+		fan->rayEnds.push_back(fan->steps.size());
+	}
+}
+
 /**
  * HE, smoke and fire explodes in a circular pattern on 1 level only. HE however damages floor tiles of the above level. Not the units on it.
  * HE destroys an object if its armor is lower than the explosive power, then it's HE blockage is applied for further propagation.
+ * The rays are traced first (spread over the thread pool), then their effects are applied
+ * ray by ray in a fixed order, so random numbers are drawn exactly as if it all happened in one go.
  * See http://www.ufopaedia.org/index.php?title=Explosions for more info.
  * @param center Center of the explosion in voxelspace.
  * @param power Power of the explosion.
@@ -1086,19 +1670,15 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
  */
 void TileEngine::explode(const Position &center, int power, ItemDamageType type, int maxRadius, BattleUnit *unit)
 {
-	double centerZ = (int)(center.z / 24) + 0.5;
-	double centerX = (int)(center.x / 16) + 0.5;
-	double centerY = (int)(center.y / 16) + 0.5;
-	int power_;
-	std::set<Tile*> tilesAffected;
-	std::pair<std::set<Tile*>::iterator,bool> ret;
+	std::vector<int> tilesAffected;
 
 	if (type == DT_IN)
 	{
 		power /= 2;
 	}
 
-	int exHeight = Options::getInt("battleExplosionHeight");
+	static const int &battleExplosionHeight = Options::watchInt("battleExplosionHeight");
+	int exHeight = battleExplosionHeight;
 	int vertdec = 1000; //default flat explosion
 	if (exHeight<0) exHeight = 0;
 	if (exHeight>3) exHeight = 3;
@@ -1114,132 +1694,108 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 		vertdec = 5;
 	}
 
+	BlastJob job;
+	job.engine = this;
+	job.fans = &_blastFans;
+	job.center = Position(center.x / 16, center.y / 16, center.z / 24);
+	job.power = power;
+	job.maxRadius = maxRadius;
+	job.vertdec = vertdec;
+	job.type = type;
+	ThreadPool::getInstance()->run(traceBlastFan, &job, BLAST_ELEVATIONS);
+
+	_blastVisited.assign(_save->getMapSizeXYZ(), false);
 
-	for (int fi = -90; fi <= 90; fi += 5)
-//	for (int fi = 0; fi <= 0; fi += 10)
+	for (std::vector<BlastFan>::iterator fan = _blastFans.begin(); fan != _blastFans.end(); ++fan)
 	{
-		// raytrace every 3 degrees makes sure we cover all tiles in a circle.
-		for (int te = 0; te <= 360; te += 3)
+		std::vector<std::pair<int, int> >::const_iterator step = fan->steps.begin();
+		for (std::vector<int>::const_iterator rayEnd = fan->rayEnds.begin(); rayEnd != fan->rayEnds.end(); ++rayEnd)
 		{
-			double cos_te = cos(te * M_PI / 180.0);
-			double sin_te = sin(te * M_PI / 180.0);
-			double sin_fi = sin(fi * M_PI / 180.0);
-			double cos_fi = cos(fi * M_PI / 180.0);
-
-			Tile *origin = _save->getTile(Position(centerX, centerY, centerZ));
-			double l = 0;
-			double vx, vy, vz;
-			int tileX, tileY, tileZ;
-			power_ = power + 1;
-
-			while (power_ > 0 && l <= maxRadius)
+			for (; step != fan->steps.begin() + *rayEnd; ++step)
 			{
-				vx = centerX + l * sin_te * cos_fi;
-				vy = centerY + l * cos_te * cos_fi;
-				vz = centerZ + l * sin_fi;
-
-				tileZ = int(floor(vz));
-				tileX = int(floor(vx));
-				tileY = int(floor(vy));
+				Tile *dest = _save->getTiles()[step->first];
+				int power_ = step->second;
 
-				Tile *dest = _save->getTile(Position(tileX, tileY, tileZ));
-				if (!dest) break; // out of map!
-
-
-				// blockage by terrain is deducted from the explosion power
-				if (std::abs(l) > 0) // no need to block epicentrum
+				if (type == DT_HE)
 				{
-					power_ -= (horizontalBlockage(origin, dest, type) + verticalBlockage(origin, dest, type)) * 2;
-					power_ -= 10; // explosive damage decreases by 10 per tile
-					if (origin->getPosition().z != tileZ) power_ -= vertdec; //3d explosion factor
+					// explosives do 1/2 damage to terrain and 1/2 up to 3/2 random damage to units
+					dest->setExplosive(power_ / 2);
 				}
 
-				if (power_ > 0)
+				if (_blastVisited[step->first]) continue; // check if we had this tile already
+				_blastVisited[step->first] = true;
+				tilesAffected.push_back(step->first);
+
+				if (type == DT_STUN)
 				{
-					if (type == DT_HE)
+					// power 50 - 150%
+					if (dest->getUnit())
 					{
-						// explosives do 1/2 damage to terrain and 1/2 up to 3/2 random damage to units
-						dest->setExplosive(power_ / 2);
+						dest->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
 					}
-
-					ret = tilesAffected.insert(dest); // check if we had this tile already
-					if (ret.second)
+					for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); ++it)
 					{
-						if (type == DT_STUN)
-						{
-							// power 50 - 150%
-							if (dest->getUnit())
-							{
-								dest->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
-							}
-							for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); ++it)
-							{
-								if ((*it)->getUnit())
-								{
-									(*it)->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
-								}
-							}
-						}
-						if (type == DT_HE)
+						if ((*it)->getUnit())
 						{
-							// power 50 - 150%
-							if (dest->getUnit())
-							{
-								dest->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
-							}
-							bool done = false;
-							while (!done)
-							{
-								done = dest->getInventory()->size() == 0;
-								for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); )
-								{
-									if (power_ > (*it)->getRules()->getArmor())
-									{
-										if ((*it)->getUnit() && (*it)->getUnit()->getStatus() == STATUS_UNCONSCIOUS)
-											(*it)->getUnit()->instaKill();
-										_save->removeItem((*it));
-										break;
-									}
-									else
-									{
-										++it;
-										done = it == dest->getInventory()->end();
-									}
-								}
-							}
+							(*it)->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
 						}
-
-						if (type == DT_SMOKE)
-						{
-							// smoke from explosions always stay 6 to 14 turns - power of a smoke grenade is 60
-							if (dest->getSmoke() < 10)
-							{
-								dest->addSmoke(RNG::generate(power_/10, 14));
-							}
-						}
-
-						if (type == DT_IN && !dest->isVoid())
+					}
+				}
+				if (type == DT_HE)
+				{
+					// power 50 - 150%
+					if (dest->getUnit())
+					{
+						dest->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
+					}
+					bool done = false;
+					while (!done)
+					{
+						done = dest->getInventory()->size() == 0;
+						for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); )
 						{
-							if (dest->getFire() == 0)
+							if (power_ > (*it)->getRules()->getArmor())
 							{
-								dest->ignite();
+								if ((*it)->getUnit() && (*it)->getUnit()->getStatus() == STATUS_UNCONSCIOUS)
+									(*it)->getUnit()->instaKill();
+								_save->removeItem((*it));
+								break;
 							}
-							if (dest->getUnit())
+							else
 							{
-								dest->getUnit()->damage(Position(0, 0, 0), RNG::generate(0, power_/3), type); // immediate IN damage
-								dest->getUnit()->setFire(RNG::generate(1, 5)); // catch fire and burn for 1-5 rounds
+								++it;
+								done = it == dest->getInventory()->end();
 							}
 						}
+					}
+				}
 
-						if (unit && dest->getUnit() && dest->getUnit()->getFaction() != unit->getFaction())
-						{
-							unit->addFiringExp();
-						}
+				if (type == DT_SMOKE)
+				{
+					// smoke from explosions always stay 6 to 14 turns - power of a smoke grenade is 60
+					if (dest->getSmoke() < 10)
+					{
+						dest->addSmoke(RNG::generate(power_/10, 14));
+					}
+				}
 
+				if (type == DT_IN && !dest->isVoid())
+				{
+					if (dest->getFire() == 0)
+					{
+						dest->ignite();
+					}
+					if (dest->getUnit())
+					{
+						dest->getUnit()->damage(Position(0, 0, 0), RNG::generate(0, power_/3), type); // immediate IN damage
+						dest->getUnit()->setFire(RNG::generate(1, 5)); // catch fire and burn for 1-5 rounds
 					}
 				}
-				origin = dest;
-				l++;
+
+				if (unit && dest->getUnit() && dest->getUnit()->getFaction() != unit->getFaction())
+				{
+					unit->addFiringExp();
+				}
 			}
 		}
 	}
@@ -1247,11 +1803,13 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 
 	if (type == DT_HE)
 	{
-		for (std::set<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+		// tiles are stored in map order, so this is the same order as sorting them by address
+		std::sort(tilesAffected.begin(), tilesAffected.end());
+		for (std::vector<int>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
 		{
-			if (detonate(*i))
+			if (detonate(_save->getTiles()[*i]))
 				_save->setObjectiveDestroyed(true);
-			applyItemGravity(*i);
+			applyItemGravity(_save->getTiles()[*i]);
 		}
 	}
 
@@ -1294,6 +1852,7 @@ bool TileEngine::detonate(Tile* tile)
 					{
 						tiles[i]->destroy(parts[i]);
 					}
+					terrainChanged(tiles[i]->getPosition());
 				}
 			}
 		}
@@ -1402,10 +1961,11 @@ int TileEngine::verticalBlockage(Tile *startTile, Tile *endTile, ItemDamageType
  */
 int TileEngine::horizontalBlockage(Tile *startTile, Tile *endTile, ItemDamageType type)
 {
-	static const Position oneTileNorth = Position(0, -1, 0);
-	static const Position oneTileEast = Position(1, 0, 0);
-	static const Position oneTileSouth = Position(0, 1, 0);
-	static const Position oneTileWest = Position(-1, 0, 0);
+	// not static: explosion rays are traced on several threads at once
+	const Position oneTileNorth = Position(0, -1, 0);
+	const Position oneTileEast = Position(1, 0, 0);
+	const Position oneTileSouth = Position(0, 1, 0);
+	const Position oneTileWest = Position(-1, 0, 0);
 
 	// safety check
 	if (startTile == 0 || endTile == 0) return 0;
@@ -1763,6 +2323,8 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick)
 	{
 
 		unit->spendTimeUnits(TUCost);
+		// adjacent doors open along with this one
+		terrainChanged(unit->getPosition(), 2 + size);
 		calculateFOV(unit->getPosition());
 		// look from the other side (may be need check reaction fire?)
 		std::vector<BattleUnit*> *vunits = unit->getVisibleUnits();
@@ -1798,7 +2360,11 @@ int TileEngine::closeUfoDoors()
 				continue;
 			}
 		}
-		doorsclosed += _save->getTiles()[i]->closeUfoDoor();
+		if (_save->getTiles()[i]->closeUfoDoor())
+		{
+			terrainChanged(_save->getTiles()[i]->getPosition());
+			++doorsclosed;
+		}
 	}
 
 	return doorsclosed;
@@ -2088,19 +2654,27 @@ int TileEngine::voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool
 	}
 
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i=0; i< 4; ++i)
+	if (_voxelMap.empty())
 	{
-		MapData *mp = tile->getMapData(i);
-		if (tile->isUfoDoorOpen(i))
-			continue;
-		if (mp != 0)
+		buildVoxelMap();
+	}
+	// the voxel map tells us whether there is anything at all, then we look for which part it is
+	if (_voxelMap[getVoxelMapIndex(voxel)] & (1 << (15 - voxel.x%16)))
+	{
+		for (int i=0; i< 4; ++i)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
+			MapData *mp = tile->getMapData(i);
+			if (tile->isUfoDoorOpen(i))
+				continue;
+			if (mp != 0)
 			{
-				return i;
+				int x = 15 - voxel.x%16;
+				int y = voxel.y%16;
+				int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
+				if (_voxelData->at(idx) & (1 << x))
+				{
+					return i;
+				}
 			}
 		}
 	}
@@ -2108,9 +2682,25 @@ int TileEngine::voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool
 	if (!excludeAllUnits)
 	{
 		BattleUnit *unit = tile->getUnit();
+		if (excludeAllBut)
+		{
+			// the only unit that counts is found by its own position rather than through the tiles,
+			// so it may be standing there hypothetically (see surveyXComThreatToTile)
+			Tile *below = unit ? 0 : _save->getTile(Position(voxel.x/16, voxel.y/16, (voxel.z/24)-1));
+			unit = 0;
+			if (unitOccupies(excludeAllBut, tile->getPosition()))
+			{
+				unit = excludeAllBut;
+			}
+			else if (below && unitOccupies(excludeAllBut, below->getPosition()))
+			{
+				tile = below;
+				unit = excludeAllBut;
+			}
+		}
 		// sometimes there is unit on the tile below, but sticks up to this tile with his head,
 		// in this case we couldn't have unit standing at current tile.
-		if (unit == 0) 
+		else if (unit == 0) 
 		{
 			tile = _save->getTile(Position(voxel.x/16, voxel.y/16, (voxel.z/24)-1)); //below
 			if (tile) unit = tile->getUnit();
@@ -20,6 +20,7 @@
 #define OPENXCOM_TILEENGINE_H
 
 #include <vector>
+#include <map>
 #include "Position.h"
 #include "../Ruleset/MapData.h"
 #include <SDL.h>
@@ -34,6 +35,86 @@ class BattleUnit;
 class BattleItem;
 class Tile;
 
+/**
+ * The terrain part of a unit's field of view, as it was last calculated.
+ * Stays valid until the unit moves or turns, or the terrain it looked through changes.
+ */
+struct FOVCache
+{
+	Position center, eyes;
+	int direction, size;
+	bool valid;
+	int rays;
+	std::vector<bool> touched;
+	std::vector<std::pair<int, int> > visibleTiles;
+	FOVCache() : direction(-1), size(0), valid(false), rays(0) {}
+};
+
+/**
+ * Everything about the unit the AI places on a tile that changes how exposed it is there.
+ */
+struct ThreatShape
+{
+	int height, floatHeight, loftemps, size;
+	bool out;
+	ThreatShape() : height(-1), floatHeight(-1), loftemps(-1), size(-1), out(false) {}
+	ThreatShape(BattleUnit *unit);
+	bool operator==(const ThreatShape &other) const
+	{
+		return height == other.height && floatHeight == other.floatHeight && loftemps == other.loftemps && size == other.size && out == other.out;
+	}
+	bool operator<(const ThreatShape &other) const
+	{
+		if (height != other.height) return height < other.height;
+		if (floatHeight != other.floatHeight) return floatHeight < other.floatHeight;
+		if (loftemps != other.loftemps) return loftemps < other.loftemps;
+		if (size != other.size) return size < other.size;
+		return out < other.out;
+	}
+};
+
+/**
+ * What the AI's threat field remembers about one unit: where it was, and for X-Com units,
+ * how exposed every tile of the map is to it (in percent) for each shape of querying unit,
+ * as far as that has been needed yet.
+ * The exposures stay valid until the unit moves or the terrain around it changes.
+ */
+struct ThreatUnit
+{
+	static const Uint8 EXPOSURE_UNKNOWN = 255;
+	Position position, eyes;
+	bool xcom;
+	std::map<ThreatShape, std::vector<Uint8> > exposure;
+	ThreatUnit() : xcom(false) {}
+};
+
+/**
+ * The tiles reached by one fan of explosion rays (all directions at one elevation),
+ * with the power left on each of them, in the order the rays reached them.
+ */
+struct BlastFan
+{
+	std::vector<std::pair<int, int> > steps;
+	std::vector<int> rayEnds;
+};
+
+/**
+ * A light stamped onto one of the light layers: a unit, a fire, a flare or a lamp.
+ */
+struct LightSource
+{
+	Position center;
+	int power;
+	LightSource(const Position &center_, int power_) : center(center_), power(power_) {}
+	bool operator<(const LightSource &other) const
+	{
+		if (power != other.power) return power < other.power;
+		if (center.x != other.center.x) return center.x < other.center.x;
+		if (center.y != other.center.y) return center.y < other.center.y;
+		return center.z < other.center.z;
+	}
+};
+
 /**
  * A utility class that modifies tile properties on a battlescape map. This includes lighting, destruction, smoke, fire, fog of war.
  * Note that this function does not handle any sounds or animations.
@@ -46,10 +127,47 @@ private:
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
 	static const int heightFromCenter[11];
-	void addLight(const Position &center, int power, int layer);
+	static const int LIGHTLAYERS = 3;
+	std::vector<LightSource> _lightSources[LIGHTLAYERS];
+	std::vector<int> _lightFalloff;
+	int _lightFalloffSize;
+	static const int BLAST_ELEVATIONS = 37, BLAST_DIRECTIONS = 121;
+	double _blastSinTe[BLAST_DIRECTIONS], _blastCosTe[BLAST_DIRECTIONS], _blastSinFi[BLAST_ELEVATIONS], _blastCosFi[BLAST_ELEVATIONS];
+	std::vector<BlastFan> _blastFans;
+	std::vector<bool> _blastVisited;
+	static void traceBlastFan(void *data, int fan);
+	void traceBlastFan(BlastFan *fan, int elevation, const Position &center, int power, ItemDamageType type, int maxRadius, int vertdec);
+	static void surveyXComThreat(void *data, int index);
+	bool unitOccupies(BattleUnit *unit, const Position &pos) const;
+	void updateLightSources(std::vector<LightSource> &sources, int layer);
+	void addLight(const LightSource &source, int layer, int minX, int minY, int maxX, int maxY);
 	int blockage(Tile *tile, const int part, ItemDamageType type);
 	int vectorToDirection(const Position &vector);
 	bool _personalLighting;
+	std::map<int, FOVCache> _fovCache;
+	int _raysCast, _raysReused;
+	std::vector<Uint16> _voxelMap;
+	int _voxelMapSizeX, _voxelMapSizeY;
+	void castTerrainFOV(BattleUnit *unit, const Position &eyes, int direction, FOVCache *cache);
+	void applyTerrainFOV(const FOVCache &cache);
+	void invalidateFOV(const Position &position, int radius);
+	std::map<int, ThreatUnit> _threatUnits;
+	ThreatShape _threatShape;
+	void prepareXComThreat(BattleUnit *queryingUnit);
+	bool surveyTile(Tile *tile, const Position &tilePos, BattleUnit *queryingUnit);
+	void invalidateXComThreat(const Position &position, int radius);
+	void invalidateThreatAround(const Position &position);
+	void buildVoxelMap();
+	void updateVoxelMap(Tile *tile);
+	/**
+	 * Gets the index of the 16 voxel wide row holding a voxel in the voxel map.
+	 * @param voxel The voxel (must be inside the map).
+	 * @return Index in the voxel map.
+	 */
+	inline int getVoxelMapIndex(const Position &voxel) const
+	{
+		return (((voxel.z/24) * 12 + (voxel.z%24)/2) * _voxelMapSizeY * 16 + voxel.y) * _voxelMapSizeX + voxel.x/16;
+	}
 public:
 	/// Creates a new TileEngine class.
 	TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData);
@@ -63,6 +181,16 @@ public:
 	bool calculateFOV(BattleUnit *unit);
 	/// Calculate the field of view within range of a certain position.
 	void calculateFOV(const Position &position);
+	/// Update everything that depends on the terrain around a position after it changed.
+	void terrainChanged(const Position &position, int radius = 0);
+	/// Forget everything cached about the terrain.
+	void resetTerrainCache();
+	/// Get the number of terrain rays cast this turn.
+	int getRaysCast() const;
+	/// Get the number of terrain rays reused from the cache this turn.
+	int getRaysReused() const;
+	/// Reset the per-turn field of view statistics.
+	void resetFOVStatistics();
 	/// Check reaction fire.
 	bool checkReactionFire(BattleUnit *unit, BattleAction *action, BattleUnit *potentialVictim = 0, bool recalculateFOV = true);
 	/// Recalculate lighting of the battlescape.
@@ -84,6 +212,12 @@ public:
 	int calculateParabola(const Position& origin, const Position& target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, double curvature, double accuracy);
 	/// Find all the soldiers that would see queryingUnit at tile (aka tilePos) and collect some statistics for AI.
 	bool surveyXComThreatToTile(Tile *tile, Position &tilePos, BattleUnit *hypotheticalUnit);	
+	/// Survey a batch of tiles for the AI on the worker threads.
+	void surveyXComThreatToTiles(const std::vector<Tile*> &tiles, BattleUnit *queryingUnit);
+	/// Update the AI's threat field after units moved or went down.
+	void updateXComThreat();
+	/// Forget the AI's whole threat field.
+	void resetXComThreat();
 	/// Get the origin voxel of a unit's eyesight
 	Position getSightOriginVoxel(BattleUnit *currentUnit);
 	/// Check visibility of a unit on this tile
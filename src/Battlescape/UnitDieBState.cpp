@@ -76,8 +76,6 @@ UnitDieBState::UnitDieBState(BattlescapeGame *parent, BattleUnit *unit, ItemDama
 	_unit->clearVisibleTiles();
 	_unit->clearVisibleUnits();
 
-    parent->resetSituationForAI();
-
     if (_unit->getFaction() == FACTION_HOSTILE)
     {
         std::vector<Node *> *nodes = parent->getSave()->getNodes();
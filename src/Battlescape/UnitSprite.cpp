@@ -90,9 +90,9 @@ void UnitSprite::setBattleItem(BattleItem *item)
 {
 	if(item)
 	{
-		if(item->getSlot()->getId() == "STR_RIGHT_HAND" || item->getRules()->isTwoHanded())
+		if(item->getSlot()->getId() == RuleInventory::RIGHT_HAND || item->getRules()->isTwoHanded())
 			_item = item;
-		if(item->getSlot()->getId() == "STR_LEFT_HAND" && !item->getRules()->isTwoHanded())
+		if(item->getSlot()->getId() == RuleInventory::LEFT_HAND && !item->getRules()->isTwoHanded())
 			_itema = item;
 	}
 	_redraw = true;
@@ -544,7 +544,7 @@ void UnitSprite::drawRoutine1()
 		}
 		else
 		{
-			if(_item->getSlot()->getId() == "STR_RIGHT_HAND")
+			if(_item->getSlot()->getId() == RuleInventory::RIGHT_HAND)
 			{
 			item = _itemSurface->getFrame(_item->getRules()->getHandSprite() + _unit->getDirection());
 			item->setX(0);
@@ -572,7 +572,7 @@ void UnitSprite::drawRoutine1()
 		}
 		else
 		{
-			if(_item->getSlot()->getId() == "STR_RIGHT_HAND")
+			if(_item->getSlot()->getId() == RuleInventory::RIGHT_HAND)
 			{
 			rightArm = _unitSurface->getFrame(rarm1H + _unit->getDirection());
 			}
@@ -754,7 +754,7 @@ void UnitSprite::drawRoutine4()
 		}
 		else
 		{
-			if(_item->getSlot()->getId() == "STR_RIGHT_HAND")
+			if(_item->getSlot()->getId() == RuleInventory::RIGHT_HAND)
 			{
 			item = _itemSurface->getFrame(_item->getRules()->getHandSprite() + _unit->getDirection());
 			item->setX(0);
@@ -182,6 +182,7 @@ void UnitWalkBState::think()
 			if (_unit->getSpecialAbility() == SPECAB_BURNFLOOR)
 			{
 				_unit->getTile()->destroy(MapData::O_FLOOR);
+				_terrain->terrainChanged(_unit->getPosition());
 			}
 
 			// move our personal lighting with us
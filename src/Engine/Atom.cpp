@@ -0,0 +1,180 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Atom.h"
+#include <deque>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Every string turned into an atom so far, with an open addressing
+ * hash table to find them by string. The strings are kept in a deque
+ * so references to them stay valid while more are added.
+ */
+struct AtomTable
+{
+	std::deque<std::string> strings;
+	std::vector<int> slots;
+	AtomTable() : strings(1), slots(64, -1)
+	{
+		slots[hash(strings[0]) & (slots.size() - 1)] = 0;
+	}
+
+	/**
+	 * Hashes a string (FNV-1a).
+	 * @param str The string.
+	 * @return Hash of the string.
+	 */
+	static unsigned int hash(const std::string &str)
+	{
+		unsigned int h = 2166136261u;
+		for (std::string::const_iterator i = str.begin(); i != str.end(); ++i)
+		{
+			h = (h ^ (unsigned char)*i) * 16777619u;
+		}
+		return h;
+	}
+
+	/**
+	 * Finds the slot of a string in the hash table.
+	 * @param str The string.
+	 * @return Index of the slot holding the string, or of the empty slot it would go in.
+	 */
+	size_t find(const std::string &str) const
+	{
+		size_t mask = slots.size() - 1;
+		size_t i = hash(str) & mask;
+		while (slots[i] != -1 && strings[slots[i]] != str)
+		{
+			i = (i + 1) & mask;
+		}
+		return i;
+	}
+
+	/**
+	 * Adds a new string, growing the hash table
+	 * so it never gets more than half full.
+	 * @param str The string.
+	 * @return ID of the string.
+	 */
+	int add(const std::string &str)
+	{
+		int id = strings.size();
+		strings.push_back(str);
+		if (strings.size() * 2 > slots.size())
+		{
+			slots.assign(slots.size() * 2, -1);
+			for (size_t i = 0; i != strings.size(); ++i)
+			{
+				slots[find(strings[i])] = i;
+			}
+		}
+		else
+		{
+			slots[find(str)] = id;
+		}
+		return id;
+	}
+};
+
+/**
+ * Gets the table of atoms, making it the first time
+ * so atoms work fine in static initializers.
+ * @return The atom table.
+ */
+static AtomTable &getTable()
+{
+	static AtomTable table;
+	return table;
+}
+
+/**
+ * Finds the ID of a string, giving it a new one
+ * if it was never seen before.
+ * @param str The string.
+ * @return ID of the string.
+ */
+static int intern(const std::string &str)
+{
+	AtomTable &table = getTable();
+	int id = table.slots[table.find(str)];
+	if (id == -1)
+	{
+		id = table.add(str);
+	}
+	return id;
+}
+
+/**
+ * Creates the atom for a string, interning it if needed.
+ * @param str The string.
+ */
+Atom::Atom(const std::string &str) : _id(intern(str))
+{
+}
+
+/**
+ * Creates the atom for a string, interning it if needed.
+ * @param str The string.
+ */
+Atom::Atom(const char *str) : _id(intern(str))
+{
+}
+
+/**
+ * Returns the string this atom stands for.
+ * @return The string.
+ */
+const std::string &Atom::str() const
+{
+	return getTable().strings[_id];
+}
+
+/**
+ * Looks up the atom for a string without interning it,
+ * so unknown strings don't fill up the table.
+ * @param str The string.
+ * @param atom Set to the atom, if there is one.
+ * @return True if the string was already interned.
+ */
+bool Atom::find(const std::string &str, Atom *atom)
+{
+	const AtomTable &table = getTable();
+	int id = table.slots[table.find(str)];
+	if (id == -1)
+	{
+		return false;
+	}
+	atom->_id = id;
+	return true;
+}
+
+/**
+ * Returns how many different strings were interned,
+ * which is also one past the highest ID, so it can be
+ * used to size tables indexed by atom.
+ * @return Number of atoms.
+ */
+int Atom::getCount()
+{
+	return getTable().strings.size();
+}
+
+}
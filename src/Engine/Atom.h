@@ -0,0 +1,77 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_ATOM_H
+#define OPENXCOM_ATOM_H
+
+#include <string>
+
+namespace OpenXcom
+{
+
+/**
+ * An interned string, used for the identifiers the game
+ * keeps comparing and looking up, like item types and
+ * inventory slots. Every different string gets a small
+ * integer ID the first time it's seen, so copying, comparing
+ * and sorting atoms is just handling an integer, and the
+ * string itself is only needed for YAML and the interface.
+ * Atoms are sorted by ID, which is the order they were first seen in.
+ * New atoms must only be made on the main thread, but existing
+ * ones can be copied and compared anywhere.
+ */
+class Atom
+{
+private:
+	int _id;
+public:
+	/// Creates the atom for the empty string.
+	Atom() : _id(0) {}
+	/// Creates the atom for a string.
+	Atom(const std::string &str);
+	/// Creates the atom for a string.
+	explicit Atom(const char *str);
+	/// Gets the atom's ID.
+	int getId() const { return _id; }
+	/// Gets the atom's string.
+	const std::string &str() const;
+	/// Gets the atom's string.
+	operator const std::string &() const { return str(); }
+	/// Finds the atom for a string, if there is one.
+	static bool find(const std::string &str, Atom *atom);
+	/// Gets the number of atoms made so far.
+	static int getCount();
+
+	friend bool operator==(const Atom &a, const Atom &b) { return a._id == b._id; }
+	friend bool operator!=(const Atom &a, const Atom &b) { return a._id != b._id; }
+	friend bool operator<(const Atom &a, const Atom &b) { return a._id < b._id; }
+};
+
+/**
+ * Sorts atoms by their strings instead of their IDs, for lists
+ * whose order shows in the game, so it stays alphabetical like
+ * it was with plain strings no matter when the atoms were made.
+ */
+struct AtomStringLess
+{
+	bool operator()(const Atom &a, const Atom &b) const { return a != b && a.str() < b.str(); }
+};
+
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include "Font.h"
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 #include "Exception.h"
 #include "Surface.h"
 #include "Language.h"
@@ -27,6 +28,7 @@ namespace OpenXcom
 {
 
 std::wstring Font::_index = L"";
+static const wchar_t LATIN_CHARS = 256;
 
 /**
  * Initializes the font with a blank surface sized big enough to
@@ -35,7 +37,7 @@ std::wstring Font::_index = L"";
  * @param height Height in pixels of each character.
  * @param spacing Horizontal spacing between each character.
  */
-Font::Font(int width, int height, int spacing) : _width(width), _height(height), _chars(), _spacing(spacing)
+Font::Font(int width, int height, int spacing) : _width(width), _height(height), _chars(), _latinChars(), _colors(0), _spacing(spacing)
 {
 	_surface = new Surface(width, height * _index.length());
 }
@@ -89,7 +91,23 @@ void Font::load()
 
 		_chars[_index[i]] = rect;
 	}
+
+	_colors = 0;
+	for (int y = 0; y < _surface->getHeight(); ++y)
+	{
+		for (int x = 0; x < _width; ++x)
+		{
+			_colors = std::max(_colors, _surface->getPixel(x, y) + 1);
+		}
+	}
 	_surface->unlock();
+
+	// the most common characters get a table of their own, no need to search for them
+	_latinChars.clear();
+	for (wchar_t c = 0; c < LATIN_CHARS; ++c)
+	{
+		_latinChars.push_back(getCharRect(c));
+	}
 }
 
 /**
@@ -143,6 +161,37 @@ Surface *Font::getChar(wchar_t c)
 	_surface->getCrop()->h = _chars[c].h;
 	return _surface;
 }
+/**
+ * Returns the size and position of a particular character
+ * in the font's surface, without touching its cropping rectangle.
+ * @param c Character to look for, '?' is used if the font doesn't have it.
+ * @return Rectangle around the character.
+ */
+const SDL_Rect &Font::getCharRect(wchar_t c)
+{
+	if (c >= 0 && (size_t)c < _latinChars.size())
+	{
+		return _latinChars[c];
+	}
+	std::map<wchar_t, SDL_Rect>::iterator i = _chars.find(c);
+	if (i == _chars.end())
+	{
+		return _chars[L'?'];
+	}
+	return i->second;
+}
+
+/**
+ * Returns how many colors of the palette the characters use,
+ * counting from the start, so text drawing knows how many
+ * colors it needs to look up.
+ * @return Number of colors.
+ */
+int Font::getColors() const
+{
+	return _colors;
+}
+
 /**
  * Returns the maximum width for any character in the font.
  * @return Width in pixels.
@@ -20,6 +20,7 @@
 #define OPENXCOM_FONT_H
 
 #include <map>
+#include <vector>
 #include <string>
 #include <SDL.h>
 
@@ -34,6 +35,9 @@ class Surface;
  * in one column in a surface.
  * @note The characters don't all need to be the same size, they can
  * have blank space and will be automatically lined up properly.
+ * The surface doubles as the glyph atlas for drawing text straight
+ * from its pixels, with the size and position of every character
+ * kept alongside.
  */
 class Font
 {
@@ -42,6 +46,8 @@ private:
 	Surface *_surface;
 	int _width, _height;
 	std::map<wchar_t, SDL_Rect> _chars;
+	std::vector<SDL_Rect> _latinChars;
+	int _colors;
 	int _spacing; // For some reason the X-Com small font is smooshed together by one pixel...
 public:
 	/// Creates a font with a blank surface.
@@ -54,6 +60,10 @@ public:
 	static void loadIndex(const std::string &filename);
 	/// Gets a particular character from the font, with its real size.
 	Surface *getChar(wchar_t c);
+	/// Gets the size and position of a character in the font's surface.
+	const SDL_Rect &getCharRect(wchar_t c);
+	/// Gets how many palette colors the characters use.
+	int getColors() const;
 	/// Gets the font's character width.
 	int getWidth() const;
 	/// Gets the font's character height.
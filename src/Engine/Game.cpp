@@ -39,6 +39,7 @@
 #include "InteractiveSurface.h"
 #include "Options.h"
 #include "CrossPlatform.h"
+#include "ThreadPool.h"
 
 namespace OpenXcom
 {
@@ -144,6 +145,8 @@ Game::~Game()
 
 	Mix_CloseAudio();
 
+	ThreadPool::shutdown();
+
 	SDL_Quit();
 }
 
@@ -463,16 +466,46 @@ Ruleset *Game::getRuleset() const
 
 /**
  * Changes the ruleset currently in use by the game.
- * @param filename Filename of the language file.
+ * With the rulesetCache option, the merged rulesets are cached in the
+ * user folder, and the cache is used instead as long as neither their
+ * files nor the game version changed.
+ * Logs how long loading took, to keep an eye on startup time.
  */
 void Game::loadRuleset()
 {
+	Uint32 start = SDL_GetTicks();
 	_rules = new Ruleset();
 	std::vector<std::string> rulesets = Options::getRulesets();
+	bool cache = Options::getBool("rulesetCache");
+	std::string cacheFile = Options::getUserFolder() + "ruleset.cache";
+	unsigned int key = 0;
+	if (cache)
+	{
+		key = Ruleset::hashSources(rulesets);
+		try
+		{
+			if (_rules->loadCache(cacheFile, key))
+			{
+				Log(LOG_INFO) << "Ruleset loaded from cache in " << SDL_GetTicks() - start << " ms.";
+				return;
+			}
+		}
+		catch (YAML::Exception &e)
+		{
+			Log(LOG_WARNING) << "Ruleset cache is broken, ignoring it: " << e.what();
+			delete _rules;
+			_rules = new Ruleset();
+		}
+	}
 	for (std::vector<std::string>::iterator i = rulesets.begin(); i != rulesets.end(); ++i)
 	{
 		_rules->load(*i);
 	}
+	Log(LOG_INFO) << "Ruleset loaded from " << rulesets.size() << " sources in " << SDL_GetTicks() - start << " ms.";
+	if (cache)
+	{
+		_rules->saveCache(cacheFile, key);
+	}
 }
 
 /**
@@ -13,6 +13,11 @@
 #include <yaml-cpp/yaml.h>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #include "OpenGL.h"
 #include "Logger.h"
@@ -94,6 +99,7 @@ Uint32 (APIENTRYP wglSwapIntervalEXT)(int interval);
     if(buffer_surface) delete buffer_surface;
     buffer_surface = new Surface(iwidth, iheight, 0, 0, ibpp); // use OpenXcom's Surface class to get an aligned buffer with bonus SDL_Surface
 	buffer = (uint32_t*) buffer_surface->getSurface()->pixels;
+	invalidate();
 
     glBindTexture(GL_TEXTURE_2D, gltexture);
 	glErrorCheck();
@@ -114,11 +120,80 @@ Uint32 (APIENTRYP wglSwapIntervalEXT)(int interval);
 
   void OpenGL::clear() {
     memset(buffer, 0, iwidth * iheight * ibpp);
+    invalidate();
     glClearColor(0.0, 0.0, 0.0, 1.0);
     glClear(GL_COLOR_BUFFER_BIT);
     glFlush();
   }
 
+  /**
+   * Converts an 8 bit surface into the 32 bit buffer through a lookup table
+   * made from its palette, instead of a generic SDL blit. Only rows whose
+   * palette indices changed since the last call are converted, and those
+   * are the only ones refresh() uploads to the texture. Anything that isn't
+   * an 8 bit surface fitting in the buffer just gets blitted whole.
+   * @param src Surface to convert.
+   */
+  void OpenGL::convert(SDL_Surface *src) {
+    SDL_Surface *dst = buffer_surface->getSurface();
+    SDL_Palette *palette = src->format->palette;
+    if (src->format->BytesPerPixel != 1 || palette == 0 || dst->format->BytesPerPixel != 4 || src->w > dst->w || src->h > dst->h) {
+      SDL_BlitSurface(src, 0, dst, 0);
+      invalidate();
+      return;
+    }
+
+    bool all = lastIndices.size() != (size_t)(src->w * src->h);
+    if (lastColors.size() != (size_t)palette->ncolors || (!lastColors.empty() && memcmp(&lastColors[0], palette->colors, palette->ncolors * sizeof(SDL_Color)) != 0)) {
+      lastColors.assign(palette->colors, palette->colors + palette->ncolors);
+      for (int i = 0; i < 256; ++i) {
+        lookup[i] = i < palette->ncolors ? SDL_MapRGB(dst->format, palette->colors[i].r, palette->colors[i].g, palette->colors[i].b) : 0;
+      }
+      all = true;
+    }
+    if (all) lastIndices.resize(src->w * src->h);
+
+    for (int y = 0; y < src->h; ++y) {
+      const Uint8 *row = (const Uint8*)src->pixels + y * src->pitch;
+      Uint8 *last = &lastIndices[y * src->w];
+      if (!all && memcmp(row, last, src->w) == 0) continue;
+      memcpy(last, row, src->w);
+
+      Uint32 *out = (Uint32*)((Uint8*)dst->pixels + y * dst->pitch);
+      int x = 0;
+#if defined(__AVX2__)
+      for (; x + 8 <= src->w; x += 8) {
+        __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row + x)));
+        _mm256_storeu_si256((__m256i*)(out + x), _mm256_i32gather_epi32((const int*)lookup, index, 4));
+      }
+#endif
+      for (; x + 4 <= src->w; x += 4) {
+        out[x] = lookup[row[x]];
+        out[x + 1] = lookup[row[x + 1]];
+        out[x + 2] = lookup[row[x + 2]];
+        out[x + 3] = lookup[row[x + 3]];
+      }
+      for (; x < src->w; ++x) {
+        out[x] = lookup[row[x]];
+      }
+
+      dirtyBegin = std::min(dirtyBegin, (unsigned)y);
+      dirtyEnd = std::max(dirtyEnd, (unsigned)y + 1);
+    }
+  }
+
+  /**
+   * Forgets the palette and pixels of the last convert(),
+   * so the next one converts everything and refresh() uploads
+   * the whole buffer again.
+   */
+  void OpenGL::invalidate() {
+    dirtyBegin = 0;
+    dirtyEnd = iheight;
+    lastColors.clear();
+    lastIndices.clear();
+  }
+
   void OpenGL::refresh(bool smooth, unsigned inwidth, unsigned inheight, unsigned outwidth, unsigned outheight) {
     while (glGetError() != GL_NO_ERROR); // clear possible error from who knows where
     if(shader_support && (fragmentshader || vertexshader)) {
@@ -161,9 +236,15 @@ Uint32 (APIENTRYP wglSwapIntervalEXT)(int interval);
 
 	glErrorCheck();
 
-    glTexSubImage2D(GL_TEXTURE_2D,
-      /* mip-map level = */ 0, /* x = */ 0, /* y = */ 0,
-      iwidth, iheight, GL_BGRA, iformat, buffer);
+    // only the rows that changed since the last upload
+    if (dirtyBegin < dirtyEnd) {
+      glTexSubImage2D(GL_TEXTURE_2D,
+        /* mip-map level = */ 0, /* x = */ 0, /* y = */ dirtyBegin,
+        iwidth, dirtyEnd - dirtyBegin, GL_BGRA, iformat,
+        (Uint8*)buffer + dirtyBegin * buffer_surface->getSurface()->pitch);
+      dirtyBegin = iheight;
+      dirtyEnd = 0;
+    }
 
 
     //OpenGL projection sets 0,0 as *bottom-left* of screen.
@@ -341,6 +422,8 @@ Uint32 (APIENTRYP wglSwapIntervalEXT)(int interval);
 	ibpp = 32; // this didn't seem to be set anywhere before...
 	iformat = GL_UNSIGNED_INT_8_8_8_8_REV; // nor this
 	buffer_surface = 0;
+	dirtyBegin = 0;
+	dirtyEnd = 0;
   }
 
 }
@@ -13,6 +13,7 @@
 
 #include <SDL.h>
 #include <SDL_opengl.h>
+#include <vector>
 
 #include "Surface.h"
 
@@ -65,6 +66,14 @@ public:
   Surface *buffer_surface;
   unsigned iwidth, iheight, iformat, ibpp;
 
+  /// buffer rows changed since the last upload
+  unsigned dirtyBegin, dirtyEnd;
+  /// source palette and pixels of the last convert(), to find what changed
+  std::vector<SDL_Color> lastColors;
+  std::vector<Uint8> lastIndices;
+  /// source palette in the buffer's pixel format
+  Uint32 lookup[256];
+
   static bool checkErrors;
 
   /// call to resize internal buffer; internal use
@@ -73,6 +82,10 @@ public:
   bool lock(uint32_t *&data, unsigned &pitch);
   /// make all the pixels go away
   void clear();
+  /// copy an 8 bit surface into the buffer through the palette, only where it changed
+  void convert(SDL_Surface *src);
+  /// forget what was converted last, so the whole buffer gets converted and uploaded again
+  void invalidate();
   /// make the buffer show up on screen
   void refresh(bool smooth, unsigned inwidth, unsigned inheight, unsigned outwidth, unsigned outheight);
   /// set a shader! but what kind?
@@ -43,7 +43,22 @@ std::vector<std::string> _dataList;
 std::string _userFolder = "";
 std::string _configFolder = "";
 std::vector<std::string> _userList;
-std::map<std::string, std::string> _options;
+
+/**
+ * An option's value as it's written in the options file,
+ * along with what it means as a number and as a boolean,
+ * so nobody has to parse it again every time it's read.
+ */
+struct OptionValue
+{
+	std::string string;
+	int integer;
+	bool boolean;
+	OptionValue() : integer(0), boolean(false) {}
+};
+
+// never erase from this, watchers keep references into it
+std::map<std::string, OptionValue> _options;
 std::vector<std::string> _rulesets;
 std::vector<std::string> _purchaseexclusions;
 
@@ -52,7 +67,6 @@ std::vector<std::string> _purchaseexclusions;
  */
 void createDefault()
 {
-	_options.clear();
 #ifdef DINGOO
 	setInt("displayWidth", 320);
 	setInt("displayHeight", 200);
@@ -126,6 +140,8 @@ void createDefault()
 	setBool("battleAutoEnd", false);
 	setBool("allowPsionicCapture", false);
 	setBool("borderless", false);
+	setInt("workerThreads", 4); // threads sharing heavy calculations, 1 to do everything on the main thread
+	setBool("rulesetCache", false); // keep the merged ruleset in the user folder for faster startup
 
 	// new battle mode data
 	setInt("NewBattleMission", 0);
@@ -262,10 +278,9 @@ void loadArgs(int argc, char** args)
 			std::transform(argname.begin(), argname.end(), argname.begin(), ::tolower);
 			if (argc > i + 1)
 			{
-				std::map<std::string, std::string>::iterator it = _options.find(argname);
-				if (it != _options.end())
+				if (_options.find(argname) != _options.end())
 				{
-					it->second = args[i+1];
+					setString(argname, args[i+1]);
 				}
 				else if (argname == "data")
 				{
@@ -446,7 +461,7 @@ void load(const std::string &filename)
 		std::string key, value;
 		i.first() >> key;
 		i.second() >> value;
-		_options[key] = value;
+		setString(key, value);
 	}
 
 	if (const YAML::Node *pName = doc.FindValue("purchaseexclusions"))
@@ -477,8 +492,14 @@ void save(const std::string &filename)
 	}
 	YAML::Emitter out;
 
+	std::map<std::string, std::string> options;
+	for (std::map<std::string, OptionValue>::iterator i = _options.begin(); i != _options.end(); ++i)
+	{
+		options[i->first] = i->second.string;
+	}
+
 	out << YAML::BeginMap;
-	out << YAML::Key << "options" << YAML::Value << _options;
+	out << YAML::Key << "options" << YAML::Value << options;
 	out << YAML::Key << "rulesets" << YAML::Value << _rulesets;
 	out << YAML::EndMap;
 
@@ -532,7 +553,7 @@ std::string getUserFolder()
  */
 std::string getString(const std::string& id)
 {
-	return _options[id];
+	return _options[id].string;
 }
 
 /**
@@ -542,11 +563,7 @@ std::string getString(const std::string& id)
  */
 int getInt(const std::string& id)
 {
-	std::stringstream ss;
-	int value;
-	ss << std::dec << _options[id];
-	ss >> std::dec >> value;
-	return value;
+	return _options[id].integer;
 }
 
 /**
@@ -556,11 +573,7 @@ int getInt(const std::string& id)
  */
 bool getBool(const std::string& id)
 {
-	std::stringstream ss;
-	bool value;
-	ss << std::boolalpha << _options[id];
-	ss >> std::boolalpha >> value;
-	return value;
+	return _options[id].boolean;
 }
 
 /**
@@ -570,7 +583,21 @@ bool getBool(const std::string& id)
  */
 void setString(const std::string& id, const std::string& value)
 {
-	_options[id] = value;
+	OptionValue &option = _options[id];
+	option.string = value;
+
+	// parse it right away, the value is read a lot more often than it's changed
+	std::stringstream ssInt, ssBool;
+	ssInt << std::dec << value;
+	if (!(ssInt >> std::dec >> option.integer))
+	{
+		option.integer = 0;
+	}
+	ssBool << std::boolalpha << value;
+	if (!(ssBool >> std::boolalpha >> option.boolean))
+	{
+		option.boolean = false;
+	}
 }
 
 /**
@@ -582,7 +609,7 @@ void setInt(const std::string& id, int value)
 {
 	std::stringstream ss;
 	ss << std::dec << value;
-	_options[id] = ss.str();
+	setString(id, ss.str());
 }
 
 /**
@@ -594,7 +621,33 @@ void setBool(const std::string& id, bool value)
 {
 	std::stringstream ss;
 	ss << std::boolalpha << value;
-	_options[id] = ss.str();
+	setString(id, ss.str());
+}
+
+/**
+ * Returns an integer option that keeps following the option
+ * whenever it's set, loaded or restored, for code that reads it
+ * too often to look it up every time. Keep the reference around
+ * and reading the option is just reading an int.
+ * @param id Option ID.
+ * @return Reference to the option value.
+ */
+const int &watchInt(const std::string& id)
+{
+	return _options[id].integer;
+}
+
+/**
+ * Returns a boolean option that keeps following the option
+ * whenever it's set, loaded or restored, for code that reads it
+ * too often to look it up every time. Keep the reference around
+ * and reading the option is just reading a bool.
+ * @param id Option ID.
+ * @return Reference to the option value.
+ */
+const bool &watchBool(const std::string& id)
+{
+	return _options[id].boolean;
 }
 
 /**
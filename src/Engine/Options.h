@@ -69,6 +69,10 @@ namespace Options
 	void setInt(const std::string& id, int value);
 	/// Sets a boolean option.
 	void setBool(const std::string& id, bool value);
+	/// Watches an integer option, for reading it in hot code.
+	const int &watchInt(const std::string& id);
+	/// Watches a boolean option, for reading it in hot code.
+	const bool &watchBool(const std::string& id);
 	/// Gets the list of rulesets to use.
 	std::vector<std::string> getRulesets();
 	/// Gets the list of rulesets to use.
@@ -501,3 +501,67 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+
+/**
+ * Apply the Scale effect on a band of rows of a bitmap.
+ * The result is exactly the same as the matching rows of ::scale(), because the
+ * rows just outside the band are still read as neighbours. Bands of the same bitmap
+ * don't write to the same destination rows, so they can be scaled at the same time.
+ * \param scale Scale factor. 2, 3 or 4.
+ * \param void_dst Pointer at the first pixel of the destination bitmap.
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_src Pointer at the first pixel of the source bitmap.
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param begin First source row of the band.
+ * \param end Source row after the last one of the band.
+ */
+void scale_rows(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned begin, unsigned end)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y;
+
+	switch (scale) {
+	case 2 :
+		for (y = begin; y < end; ++y) {
+			stage_scale2x(SCDST(2*y), SCDST(2*y+1), SCSRC(y > 0 ? y-1 : y), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		}
+		break;
+	case 3 :
+		for (y = begin; y < end; ++y) {
+			stage_scale3x(SCDST(3*y), SCDST(3*y+1), SCDST(3*y+2), SCSRC(y > 0 ? y-1 : y), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		}
+		break;
+	case 4 : {
+		/* the scale2x rows of the band and of one source row on each side */
+		unsigned first = begin > 0 ? begin - 1 : 0;
+		unsigned last = end < height ? end + 1 : height;
+		unsigned mid_slice = ((2 * pixel * width) + 0x7) & ~0x7;
+		unsigned char* mid = (unsigned char*)malloc(2 * (last - first) * mid_slice);
+		unsigned last_mid = 2 * height - 1;
+
+		if (!mid)
+			return;
+
+		for (y = first; y < last; ++y) {
+			stage_scale2x(mid + 2*(y-first)*mid_slice, mid + (2*(y-first)+1)*mid_slice, SCSRC(y > 0 ? y-1 : y), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		}
+		for (y = begin; y < end; ++y) {
+			unsigned m0 = y > 0 ? 2*y-1 : 0;
+			unsigned m3 = 2*y+2 < last_mid ? 2*y+2 : last_mid;
+			stage_scale4x(SCDST(4*y), SCDST(4*y+1), SCDST(4*y+2), SCDST(4*y+3),
+				mid + (m0 - 2*first)*mid_slice, mid + (2*y - 2*first)*mid_slice, mid + (2*y+1 - 2*first)*mid_slice, mid + (m3 - 2*first)*mid_slice,
+				pixel, width);
+		}
+		free(mid);
+		break;
+	}
+	}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	scale2x_mmx_emms();
+#endif
+}
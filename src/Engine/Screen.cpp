@@ -20,6 +20,7 @@
 #include <sstream>
 #include <iomanip>
 #include <limits.h>
+#include <cstring>
 #include "../lodepng.h"
 #include "Exception.h"
 #include "Surface.h"
@@ -122,6 +123,11 @@ void Screen::handle(Action *action)
 				default: Timer::gameSlowSpeed = 1; break;
 			}				
 		}
+		// f6 - flip benchmark
+		else if (action->getDetails()->type == SDL_KEYDOWN && action->getDetails()->key.keysym.sym == SDLK_F6)
+		{
+			benchmarkFlip();
+		}
 	}
 	
 	if (action->getDetails()->type == SDL_KEYDOWN && action->getDetails()->key.keysym.sym == SDLK_RETURN && (SDL_GetModState() & KMOD_ALT) != 0)
@@ -182,6 +188,54 @@ void Screen::flip()
 	}
 }
 
+/**
+ * Flips the current frame a bunch of times, once forcing everything to be
+ * redrawn and uploaded every time, and once letting the upscalers and the
+ * OpenGL upload skip what didn't change, and logs how long a frame took each way.
+ * With OpenGL it also checks the palette lookup converted the frame the same
+ * as an SDL blit does. Doesn't need a GPU, a software OpenGL like Mesa's
+ * llvmpipe works too (but turn off vsync or it's just timing the display).
+ */
+void Screen::benchmarkFlip()
+{
+	const int frames = 100;
+	Uint32 times[2];
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		Uint32 start = SDL_GetTicks();
+		for (int i = 0; i < frames; ++i)
+		{
+			if (pass == 0)
+			{
+				Zoom::invalidate();
+				glOutput.invalidate();
+			}
+			flip();
+		}
+		times[pass] = SDL_GetTicks() - start;
+	}
+
+	Log(LOG_INFO) << "benchmarkFlip() " << frames << " frames at " << getWidth() << "x" << getHeight() << (isOpenGLEnabled() ? " with OpenGL:" : " in software:");
+	Log(LOG_INFO) << "  full redraw: " << times[0] / (double)frames << "ms per frame";
+	Log(LOG_INFO) << "  unchanged frame: " << times[1] / (double)frames << "ms per frame";
+
+	if (isOpenGLEnabled() && glOutput.buffer_surface && _surface->getSurface()->format->BytesPerPixel == 1)
+	{
+		SDL_Surface *buffer = glOutput.buffer_surface->getSurface();
+		SDL_Surface *blit = SDL_ConvertSurface(_surface->getSurface(), buffer->format, SDL_SWSURFACE);
+		bool same = (blit != 0);
+		for (int y = 0; same && y < blit->h; ++y)
+		{
+			same = memcmp((Uint8*)blit->pixels + y * blit->pitch, (Uint8*)buffer->pixels + y * buffer->pitch, blit->w * 4) == 0;
+		}
+		if (blit)
+		{
+			SDL_FreeSurface(blit);
+		}
+		Log(LOG_INFO) << "  palette lookup " << (same ? "matches" : "DOESN'T match") << " SDL blit";
+	}
+}
+
 /**
  * Clears all the contents out of the internal buffer.
  */
@@ -292,6 +346,7 @@ void Screen::setResolution(int width, int height)
 	{
 		throw Exception(SDL_GetError());
 	}
+	Zoom::invalidate();
 	_scaleX = getWidth() / (double)BASE_WIDTH;
 	_scaleY = getHeight() / (double)BASE_HEIGHT;
 
@@ -389,10 +444,11 @@ void Screen::screenshot(const std::string &filename) const
  */
 bool Screen::isHQXEnabled()
 {
-	int w = Options::getInt("displayWidth");
-	int h = Options::getInt("displayHeight");
+	static const int &w = Options::watchInt("displayWidth");
+	static const int &h = Options::watchInt("displayHeight");
+	static const bool &useHQXFilter = Options::watchBool("useHQXFilter");
 
-	if (Options::getBool("useHQXFilter") && (
+	if (useHQXFilter && (
 		(w == Screen::BASE_WIDTH * 2 && h == Screen::BASE_HEIGHT * 2) || 
 		(w == Screen::BASE_WIDTH * 3 && h == Screen::BASE_HEIGHT * 3) || 
 		(w == Screen::BASE_WIDTH * 4 && h == Screen::BASE_HEIGHT * 4)))
@@ -406,7 +462,8 @@ bool Screen::isHQXEnabled()
 
 bool Screen::isOpenGLEnabled()
 {
-	return Options::getBool("useOpenGL");
+	static const bool &useOpenGL = Options::watchBool("useOpenGL");
+	return useOpenGL;
 }
 
 }
@@ -87,6 +87,8 @@ public:
 	double getYScale() const;
 	/// Takes a screenshot.
 	void screenshot(const std::string &filename) const;
+	/// Times flipping the screen with and without redrawing everything.
+	void benchmarkFlip();
 	/// Checks whether HQX is requested and works for the selected resolution
 	static bool isHQXEnabled();
 	/// Checks whether OpenGL output is requested
@@ -21,22 +21,77 @@
 #define	OPENXCOM_SHADERDRAW_H
 
 #include "ShaderDrawHelper.h"
+
+#if defined(__AVX2__)
+#define OPENXCOM_SHADER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENXCOM_SHADER_SSE2
+#include <emmintrin.h>
+#endif
 	
 namespace OpenXcom
 {
 
+namespace helper
+{
+
 /**
- * Universal blit function
+ * Checks at compile time if `ColorFunc` has a vectorized version of `func`.
+ * A kernel opts in by declaring `typedef void vectorized;` and a static function
+ * `int func_vector(dest*, src0*, count, src1, src2, src3)` that works on whole rows of pixels
+ * and returns how many of them it did, the rest is done by `func`.
+ */
+template<typename ColorFunc>
+struct is_vector_kernel
+{
+	template<typename T>
+	static char test(typename T::vectorized*);
+	template<typename T>
+	static long test(...);
+	enum { value = sizeof(test<ColorFunc>(0)) == 1 };
+};
+
+/// row part of `ShaderDraw` for kernels without a vectorized `func`.
+template<bool Vector>
+struct ShaderRow
+{
+	template<typename ColorFunc, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type, typename Src3Type>
+	static inline int run(DestType&, Src0Type&, Src1Type&, Src2Type&, Src3Type&, int)
+	{
+		return 0;
+	}
+};
+
+/// row part of `ShaderDraw` for kernels with a vectorized `func`.
+template<>
+struct ShaderRow<true>
+{
+	template<typename ColorFunc, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type, typename Src3Type>
+	static inline int run(DestType& dest, Src0Type& src0, Src1Type& src1, Src2Type& src2, Src3Type& src3, int count)
+	{
+		const int done = ColorFunc::func_vector(&dest.get_ref(), &src0.get_ref(), count, src1.get_ref(), src2.get_ref(), src3.get_ref());
+		dest.skip_x(done);
+		src0.skip_x(done);
+		src1.skip_x(done);
+		src2.skip_x(done);
+		src3.skip_x(done);
+		return done;
+	}
+};
+
+/**
+ * Universal blit function, with or without the vectorized version of `ColorFunc::func`.
  * @tparam ColorFunc class that contains static function `func` that get 5 arguments
- * function is used to modify these arguments.
+ * @tparam Vector use `ColorFunc::func_vector` for the start of every row.
  * @param dest_frame destination surface modified by function.
  * @param src0_frame surface or scalar
  * @param src1_frame surface or scalar
  * @param src2_frame surface or scalar
  * @param src3_frame surface or scalar
  */
-template<typename ColorFunc, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type, typename Src3Type>
-static inline void ShaderDraw(const DestType& dest_frame, const Src0Type& src0_frame, const Src1Type& src1_frame, const Src2Type& src2_frame, const Src3Type& src3_frame)
+template<typename ColorFunc, bool Vector, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type, typename Src3Type>
+static inline void ShaderDrawLoop(const DestType& dest_frame, const Src0Type& src0_frame, const Src1Type& src1_frame, const Src2Type& src2_frame, const Src3Type& src3_frame)
 {
 	//creating helper objects
 	helper::controler<DestType> dest(dest_frame);
@@ -100,14 +155,51 @@ static inline void ShaderDraw(const DestType& dest_frame, const Src0Type& src0_f
 		src2.set_x(begin_x, end_x);
 		src3.set_x(begin_x, end_x);
 		
-		//iteration on x-axis
-		for(int x = end_x-begin_x; x>0; --x, dest.inc_x(), src0.inc_x(), src1.inc_x(), src2.inc_x(), src3.inc_x())
+		//vectorized part of x-axis
+		const int done = ShaderRow<Vector>::template run<ColorFunc>(dest, src0, src1, src2, src3, end_x-begin_x);
+		
+		//iteration on rest of x-axis
+		for(int x = end_x-begin_x-done; x>0; --x, dest.inc_x(), src0.inc_x(), src1.inc_x(), src2.inc_x(), src3.inc_x())
 		{
 			ColorFunc::func(dest.get_ref(), src0.get_ref(), src1.get_ref(), src2.get_ref(), src3.get_ref());				
 		}
 	}
 
 };
+
+}//namespace helper
+
+/**
+ * Universal blit function
+ * @tparam ColorFunc class that contains static function `func` that get 5 arguments
+ * function is used to modify these arguments.
+ * If `ColorFunc` has a vectorized version of `func`, it's used where it can be.
+ * @param dest_frame destination surface modified by function.
+ * @param src0_frame surface or scalar
+ * @param src1_frame surface or scalar
+ * @param src2_frame surface or scalar
+ * @param src3_frame surface or scalar
+ */
+template<typename ColorFunc, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type, typename Src3Type>
+static inline void ShaderDraw(const DestType& dest_frame, const Src0Type& src0_frame, const Src1Type& src1_frame, const Src2Type& src2_frame, const Src3Type& src3_frame)
+{
+	helper::ShaderDrawLoop<ColorFunc, helper::is_vector_kernel<ColorFunc>::value>(dest_frame, src0_frame, src1_frame, src2_frame, src3_frame);
+}
+
+/**
+ * Universal blit function that only uses `ColorFunc::func`, one pixel at a time.
+ * Gives the same result as `ShaderDraw`, it's there to compare both of them.
+ * @param dest_frame destination surface modified by function.
+ * @param src0_frame surface or scalar
+ * @param src1_frame surface or scalar
+ * @param src2_frame surface or scalar
+ * @param src3_frame surface or scalar
+ */
+template<typename ColorFunc, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type, typename Src3Type>
+static inline void ShaderDrawScalar(const DestType& dest_frame, const Src0Type& src0_frame, const Src1Type& src1_frame, const Src2Type& src2_frame, const Src3Type& src3_frame)
+{
+	helper::ShaderDrawLoop<ColorFunc, false>(dest_frame, src0_frame, src1_frame, src2_frame, src3_frame);
+}
 	
 template<typename ColorFunc, typename DestType, typename Src0Type, typename Src1Type, typename Src2Type>
 static inline void ShaderDraw(const DestType& dest_frame, const Src0Type& src0_frame, const Src1Type& src1_frame, const Src2Type& src2_frame)
@@ -149,6 +241,69 @@ const Uint8 ColorShade = 15;
 const Uint8 ColorShadeMax = 15;
 const Uint8 BLACK = 15;
 
+/**
+ * Shades a row of 8-bit palette pixels the way `Surface::blitNShade` does,
+ * as many pixels at once as the widest instruction set the game is compiled for allows.
+ * Pixels of color 0 in `src` are transparent, shades going past the darkest
+ * one of a color group become black.
+ * @param dest destination pixels.
+ * @param src source pixels.
+ * @param count number of pixels in the row.
+ * @param shade value added to the shade of every pixel.
+ * @param newColor color group to put pixels in (shifted by 4), or -1 to keep their own.
+ * @return number of pixels done, the caller has to do the rest one at a time.
+ */
+static inline int ShadeRow(Uint8* dest, const Uint8* src, int count, int shade, int newColor)
+{
+	int i = 0;
+#if defined(OPENXCOM_SHADER_AVX2) || defined(OPENXCOM_SHADER_SSE2)
+	if(shade < 0)
+		return 0;
+	if(shade > ColorShadeMax + 1)
+		shade = ColorShadeMax + 1;
+#endif
+#ifdef OPENXCOM_SHADER_AVX2
+	{
+		const __m256i shadeMask = _mm256_set1_epi8(ColorShade);
+		const __m256i shadeAdd = _mm256_set1_epi8((char)shade);
+		const __m256i group = _mm256_set1_epi8((char)newColor);
+		const __m256i zero = _mm256_setzero_si256();
+		for(; i + 32 <= count; i += 32)
+		{
+			const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+			const __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+			const __m256i newShade = _mm256_add_epi8(_mm256_and_si256(s, shadeMask), shadeAdd);
+			const __m256i black = _mm256_cmpgt_epi8(newShade, shadeMask);
+			const __m256i color = _mm256_or_si256(newColor < 0 ? _mm256_andnot_si256(shadeMask, s) : group, newShade);
+			const __m256i shaded = _mm256_blendv_epi8(color, shadeMask, black);
+			_mm256_storeu_si256((__m256i*)(dest + i), _mm256_blendv_epi8(shaded, d, _mm256_cmpeq_epi8(s, zero)));
+		}
+	}
+#endif
+#if defined(OPENXCOM_SHADER_AVX2) || defined(OPENXCOM_SHADER_SSE2)
+	{
+		const __m128i shadeMask = _mm_set1_epi8(ColorShade);
+		const __m128i shadeAdd = _mm_set1_epi8((char)shade);
+		const __m128i group = _mm_set1_epi8((char)newColor);
+		const __m128i zero = _mm_setzero_si128();
+		for(; i + 16 <= count; i += 16)
+		{
+			const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+			const __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+			const __m128i newShade = _mm_add_epi8(_mm_and_si128(s, shadeMask), shadeAdd);
+			const __m128i black = _mm_cmpgt_epi8(newShade, shadeMask);
+			const __m128i color = _mm_or_si128(newColor < 0 ? _mm_andnot_si128(shadeMask, s) : group, newShade);
+			const __m128i shaded = _mm_or_si128(_mm_and_si128(black, shadeMask), _mm_andnot_si128(black, color));
+			const __m128i transparent = _mm_cmpeq_epi8(s, zero);
+			_mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, shaded)));
+		}
+	}
+#else
+	(void)dest; (void)src; (void)count; (void)shade; (void)newColor;
+#endif
+	return i;
+}
+
 }//namespace helper
 
 }//namespace OpenXcom
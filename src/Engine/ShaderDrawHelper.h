@@ -447,6 +447,12 @@ struct controler
 	inline void mod_x(int& begin, int& end);
 	inline void set_x(const int& begin, const int& end);
 	inline void inc_x();
+	/**
+	 * function used only by kernels with vectorized `func`,
+	 * moves `n` pixels forward on x-axis at once.
+	 * @param n number of pixels
+	 */
+	inline void skip_x(int n);
 
 	inline int& get_ref();
 };
@@ -500,6 +506,10 @@ struct controler<Scalar<T> >
 	{
 		//nothing
 	}
+	inline void skip_x(int)
+	{
+		//nothing
+	}
 	
 	inline T& get_ref()
 	{
@@ -554,6 +564,10 @@ struct controler<Nothing>
 	{
 		//nothing
 	}
+	inline void skip_x(int)
+	{
+		//nothing
+	}
 	
 	inline const int& get_ref()
 	{
@@ -629,6 +643,10 @@ struct controler_base
 	{
 		ptr_pos_x += step.first;
 	}
+	inline void skip_x(int n)
+	{
+		ptr_pos_x += step.first*n;
+	}
 	
 	inline PixelRef get_ref()
 	{
@@ -25,6 +25,7 @@
 #include "Exception.h"
 #include "ShaderMove.h"
 #include <stdlib.h>
+#include <string.h>
 #ifdef _WIN32
 #include <malloc.h>
 #endif
@@ -33,6 +34,7 @@
 #define _aligned_free   __mingw_aligned_free
 #endif //MINGW
 #include "Language.h"
+#include "Logger.h"
 
 namespace OpenXcom
 {
@@ -740,6 +742,7 @@ void Surface::paletteRestore()
  */
 struct ColorReplace
 {
+	typedef void vectorized;
 	
 	/**
 	* Function used by ShaderDraw in Surface::blitNShade
@@ -762,6 +765,20 @@ struct ColorReplace
 		}
 	}
 	
+	/**
+	* Vectorized version of `func`, for as much of a row as it can do.
+	* @param dest destination pixels
+	* @param src source pixels
+	* @param count number of pixels in the row
+	* @param shade value of shade of this surface
+	* @param newColor new color to set (it should be offseted by 4)
+	* @return number of pixels done
+	*/
+	static inline int func_vector(Uint8* dest, const Uint8* src, int count, const int& shade, const int& newColor, const int&)
+	{
+		return helper::ShadeRow(dest, src, count, shade, newColor);
+	}
+	
 };
 
 /**
@@ -769,6 +786,8 @@ struct ColorReplace
  */
 struct StandartShade
 {
+	typedef void vectorized;
+	
 	/**
 	* Function used by ShaderDraw in Surface::blitNShade
 	* set shade
@@ -791,8 +810,108 @@ struct StandartShade
 		}
 	}
 	
+	/**
+	* Vectorized version of `func`, for as much of a row as it can do.
+	* @param dest destination pixels
+	* @param src source pixels
+	* @param count number of pixels in the row
+	* @param shade value of shade of this surface
+	* @param notused
+	* @param notused
+	* @return number of pixels done
+	*/
+	static inline int func_vector(Uint8* dest, const Uint8* src, int count, const int& shade, const int&, const int&)
+	{
+		return helper::ShadeRow(dest, src, count, shade, -1);
+	}
+	
 };
 
+/**
+ * Blits a surface the way Surface::blitNShade does, with or without the vectorized shading.
+ * @param src Surface to blit.
+ * @param dest Surface to blit to.
+ * @param x X position of the blit.
+ * @param y Y position of the blit.
+ * @param off Shade of the blit.
+ * @param newBaseColor New color of the blit, plus 1, or 0 to keep the colors.
+ */
+template<bool Vector>
+static void shadeSurface(Surface *src, Surface *dest, int x, int y, int off, int newBaseColor)
+{
+	ShaderMove<Uint8> s(src, x, y);
+	ShaderMove<Uint8> d = ShaderSurface(dest);
+	if(newBaseColor)
+	{
+		int color = (newBaseColor - 1) << 4;
+		helper::ShaderDrawLoop<ColorReplace, Vector>(d, s, ShaderScalar(off), ShaderScalar(color), helper::Nothing());
+	}
+	else
+		helper::ShaderDrawLoop<StandartShade, Vector>(d, s, ShaderScalar(off), helper::Nothing(), helper::Nothing());
+}
+
+/**
+ * Blits a bunch of sprites all over a couple of scratch surfaces in every shade,
+ * once one pixel at a time and once with the vectorized shading,
+ * and logs how long each took and if they drew the same thing.
+ * @param sprites Sprites to blit, the terrain of a battle is a good example.
+ * @param width Width of the scratch surfaces.
+ * @param height Height of the scratch surfaces.
+ */
+void Surface::benchmarkShading(const std::vector<Surface*> &sprites, int width, int height)
+{
+	const int runs = 20;
+	Surface *results[2] = { new Surface(width, height), new Surface(width, height) };
+	Uint32 times[2];
+	int blits = 0;
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		Surface *dest = results[pass];
+		dest->clear();
+		dest->lock();
+		Uint32 start = SDL_GetTicks();
+		blits = 0;
+		for (int run = 0; run < runs; ++run)
+		{
+			for (size_t i = 0; i < sprites.size(); ++i, ++blits)
+			{
+				// spread them out, including a bit over the edges
+				int x = (blits * 37) % (width + 32) - 16;
+				int y = (blits * 23) % (height + 40) - 20;
+				// a couple of shades are past black on purpose
+				int off = blits % 18;
+				int newBaseColor = (blits % 4 == 0) ? blits % 16 + 1 : 0;
+				if (pass == 0)
+					shadeSurface<false>(sprites[i], dest, x, y, off, newBaseColor);
+				else
+					shadeSurface<true>(sprites[i], dest, x, y, off, newBaseColor);
+			}
+		}
+		times[pass] = SDL_GetTicks() - start;
+		dest->unlock();
+	}
+
+	bool same = true;
+	for (int y = 0; y < height && same; ++y)
+	{
+		same = memcmp((Uint8*)results[0]->getSurface()->pixels + y * results[0]->getSurface()->pitch, (Uint8*)results[1]->getSurface()->pixels + y * results[1]->getSurface()->pitch, width) == 0;
+	}
+	delete results[0];
+	delete results[1];
+
+#if defined(OPENXCOM_SHADER_AVX2)
+	std::string vector = "AVX2";
+#elif defined(OPENXCOM_SHADER_SSE2)
+	std::string vector = "SSE2";
+#else
+	std::string vector = "none";
+#endif
+	Log(LOG_INFO) << "benchmarkShading() " << blits << " blits of " << sprites.size() << " sprites:";
+	Log(LOG_INFO) << "  scalar: " << times[0] << "ms";
+	Log(LOG_INFO) << "  vector (" << vector << "): " << times[1] << "ms";
+	Log(LOG_INFO) << "  results " << (same ? "match" : "DIFFER");
+}
+
 
 
 /**
@@ -805,8 +924,9 @@ struct StandartShade
  * @param off
  * @param half some tiles are blitted only the right half
  * @param newBaseColor Attention: the actual color + 1, because 0 is no new base color.
+ * @param clip If set, only pixels inside this rectangle of the target are drawn.
  */
-void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int newBaseColor)
+void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int newBaseColor, const SDL_Rect *clip)
 {
 	ShaderMove<Uint8> src(this, x, y);
 	if(half)
@@ -815,14 +935,19 @@ void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int
 		g.beg_x = g.end_x/2;
 		src.setDomain(g);
 	}
+	ShaderMove<Uint8> dest = ShaderSurface(surface);
+	if(clip)
+	{
+		dest.setDomain(GraphSubset(std::make_pair((int)clip->x, clip->x + clip->w), std::make_pair((int)clip->y, clip->y + clip->h)));
+	}
 	if(newBaseColor)
 	{
 		--newBaseColor;
 		newBaseColor <<= 4;
-		ShaderDraw<ColorReplace>(ShaderSurface(surface), src, ShaderScalar(off), ShaderScalar(newBaseColor));
+		ShaderDraw<ColorReplace>(dest, src, ShaderScalar(off), ShaderScalar(newBaseColor));
 	}
 	else
-		ShaderDraw<StandartShade>(ShaderSurface(surface), src, ShaderScalar(off));
+		ShaderDraw<StandartShade>(dest, src, ShaderScalar(off));
 		
 }
 
@@ -22,6 +22,7 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <string>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -124,9 +125,11 @@ public:
 	/// Restores the original palette.
 	void paletteRestore();
 	/// Specific blit function to blit battlescape terrain data in different shades in a fast way.
-	void blitNShade(Surface *surface, int x, int y, int off, bool half = false, int newBaseColor = 0);
+	void blitNShade(Surface *surface, int x, int y, int off, bool half = false, int newBaseColor = 0, const SDL_Rect *clip = 0);
 	/// Invalidate the surface: force it to be redrawn
 	void invalidate();
+	/// Times the vectorized shading of blitNShade against the plain one.
+	static void benchmarkShading(const std::vector<Surface*> &sprites, int width, int height);
 };
 
 }
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include "ThreadPool.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+ThreadPool *ThreadPool::_instance = 0;
+
+/**
+ * Starts the worker threads. With less than two threads
+ * there are no workers and batches just run on the caller.
+ * @param threads Number of threads working on a batch, including the caller.
+ */
+ThreadPool::ThreadPool(int threads) : _mutex(0), _work(0), _done(0), _job(0), _data(0), _count(0), _next(0), _finished(0), _batch(0), _quit(false)
+{
+	if (threads < 2)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_work = SDL_CreateCond();
+	_done = SDL_CreateCond();
+	for (int i = 1; i < threads; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, this);
+		if (thread == 0)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+/**
+ * Tells the worker threads to stop and waits for them.
+ */
+ThreadPool::~ThreadPool()
+{
+	if (_mutex == 0)
+		return;
+
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_work);
+	SDL_UnlockMutex(_mutex);
+
+	for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+
+	SDL_DestroyCond(_done);
+	SDL_DestroyCond(_work);
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Gets the thread pool shared by the whole game, starting it
+ * the first time with as many threads as the options ask for.
+ * @return Pointer to the thread pool.
+ */
+ThreadPool *ThreadPool::getInstance()
+{
+	if (_instance == 0)
+	{
+		_instance = new ThreadPool(Options::getInt("workerThreads"));
+	}
+	return _instance;
+}
+
+/**
+ * Stops the shared thread pool, if it was ever started.
+ */
+void ThreadPool::shutdown()
+{
+	delete _instance;
+	_instance = 0;
+}
+
+/**
+ * Gets the number of threads working on a batch, including the caller.
+ * @return Number of threads.
+ */
+int ThreadPool::getThreads() const
+{
+	return _threads.size() + 1;
+}
+
+/**
+ * Waits for batches and works on them until the pool is stopped.
+ * @param pool Pointer to the thread pool.
+ * @return Exit code of the thread.
+ */
+int ThreadPool::worker(void *pool)
+{
+	ThreadPool *self = (ThreadPool*)pool;
+	int batch = 0;
+
+	SDL_LockMutex(self->_mutex);
+	while (true)
+	{
+		while (!self->_quit && self->_batch == batch)
+		{
+			SDL_CondWait(self->_work, self->_mutex);
+		}
+		if (self->_quit)
+			break;
+		batch = self->_batch;
+		self->work();
+	}
+	SDL_UnlockMutex(self->_mutex);
+	return 0;
+}
+
+/**
+ * Takes jobs of the current batch one at a time and runs them
+ * outside of the lock. Must be called with the lock held.
+ */
+void ThreadPool::work()
+{
+	while (_next < _count)
+	{
+		int index = _next++;
+		SDL_UnlockMutex(_mutex);
+		_job(_data, index);
+		SDL_LockMutex(_mutex);
+		if (++_finished == _count)
+		{
+			SDL_CondBroadcast(_done);
+		}
+	}
+}
+
+/**
+ * Runs a job for every index from 0 to count - 1, spread over the
+ * pool's threads, and returns when all of them are finished.
+ * Jobs can run in any order, so anything that has to be deterministic
+ * must only depend on the index and be merged by the caller.
+ * @param job Function to call for every index.
+ * @param data Data passed to every call.
+ * @param count Number of jobs.
+ */
+void ThreadPool::run(ThreadJob job, void *data, int count)
+{
+	if (_threads.empty() || count < 2)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job(data, i);
+		}
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+	_job = job;
+	_data = data;
+	_count = count;
+	_next = 0;
+	_finished = 0;
+	++_batch;
+	SDL_CondBroadcast(_work);
+
+	work();
+	while (_finished < _count)
+	{
+		SDL_CondWait(_done, _mutex);
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+
+/**
+ * Everything the band jobs of a runBands() batch need to know.
+ */
+struct BandBatch
+{
+	BandJob job;
+	void *data;
+	int begin, end, height;
+};
+
+/**
+ * Thread pool entry point for drawing one band.
+ * @param data Pointer to the BandBatch.
+ * @param index Index of the band, from the top.
+ */
+void ThreadPool::band(void *data, int index)
+{
+	BandBatch *batch = (BandBatch*)data;
+	int begin = batch->begin + index * batch->height;
+	int end = std::min(begin + batch->height, batch->end);
+	batch->job(batch->data, begin, end);
+}
+
+/**
+ * Splits a range of surface rows into horizontal bands and runs a job for
+ * every band, spread over the pool's threads. Bands don't overlap, so jobs
+ * that only write pixels inside their own band don't need any locking, and
+ * anything drawn in order within a band keeps that order.
+ * There are a couple of bands per thread, so uneven bands still keep every thread busy.
+ * @param job Function to call for every band.
+ * @param data Data passed to every call.
+ * @param begin First row.
+ * @param end Row after the last one.
+ * @param minHeight Bands are never made thinner than this, it's not worth it.
+ */
+void ThreadPool::runBands(BandJob job, void *data, int begin, int end, int minHeight)
+{
+	int rows = end - begin;
+	if (rows <= 0)
+		return;
+	int bands = std::max(1, std::min(getThreads() * 2, rows / std::max(1, minHeight)));
+
+	BandBatch batch;
+	batch.job = job;
+	batch.data = data;
+	batch.begin = begin;
+	batch.end = end;
+	batch.height = (rows + bands - 1) / bands;
+	run(band, &batch, (rows + batch.height - 1) / batch.height);
+}
+
+}
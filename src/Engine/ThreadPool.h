@@ -0,0 +1,82 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_THREADPOOL_H
+#define OPENXCOM_THREADPOOL_H
+
+#include <vector>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+/**
+ * A job run by the thread pool: a function called once for every
+ * index of a batch, with the data shared by the whole batch.
+ */
+typedef void (*ThreadJob)(void *data, int index);
+
+/**
+ * A job drawing one horizontal band of a surface, from row begin up to (not including) row end.
+ */
+typedef void (*BandJob)(void *data, int begin, int end);
+
+/**
+ * Fixed set of worker threads that split up batches of independent jobs.
+ * The thread submitting a batch works on it too and only returns once
+ * every job is done, so callers never see work in progress.
+ * Jobs must not touch anything another job of the same batch writes to.
+ */
+class ThreadPool
+{
+private:
+	static ThreadPool *_instance;
+	std::vector<SDL_Thread*> _threads;
+	SDL_mutex *_mutex;
+	SDL_cond *_work, *_done;
+	ThreadJob _job;
+	void *_data;
+	int _count, _next, _finished, _batch;
+	bool _quit;
+	/// Entry point of the worker threads.
+	static int worker(void *pool);
+	/// Runs jobs of the current batch until there are none left.
+	void work();
+	/// Runs one band of a runBands() batch.
+	static void band(void *data, int index);
+public:
+	/// Creates a pool with a number of worker threads.
+	ThreadPool(int threads);
+	/// Stops the worker threads.
+	~ThreadPool();
+	/// Gets the shared thread pool.
+	static ThreadPool *getInstance();
+	/// Stops the shared thread pool.
+	static void shutdown();
+	/// Gets the number of threads working on a batch.
+	int getThreads() const;
+	/// Runs a batch of jobs and waits for all of them.
+	void run(ThreadJob job, void *data, int count);
+	/// Splits a range of rows into bands and draws them in parallel.
+	void runBands(BandJob job, void *data, int begin, int end, int minHeight = 16);
+};
+
+}
+
+#endif
@@ -18,6 +18,8 @@
  */
 
 #include "Zoom.h"
+#include <vector>
+#include <algorithm>
 
 //#include "Scalers/hq2x.hpp"
 
@@ -28,6 +30,7 @@
 #include "Screen.h"
 
 #include "OpenGL.h"
+#include "ThreadPool.h"
 
 // Scale2X
 #include "Scalers/scalebit.h"
@@ -578,6 +581,157 @@ static int zoomSurface2X_SSE2(SDL_Surface *src, SDL_Surface *dst)
 	return 0;
 }
 
+/// Source rows in every band of the upscalers, which is also the granularity of the change check.
+static const int UPSCALE_BAND_HEIGHT = 8;
+
+/**
+ * What the last upscale() drew, so unchanged bands can be left alone.
+ */
+struct UpscaleFrame
+{
+	SDL_Surface *src, *dst;
+	void *srcPixels, *dstPixels;
+	int factor;
+	bool hqx;
+	std::vector<Uint32> hashes;
+};
+
+static UpscaleFrame lastUpscale = { 0, 0, 0, 0, 0, false, std::vector<Uint32>() };
+
+/**
+ * Everything the upscaleBand() jobs of one frame need to know.
+ */
+struct UpscaleJob
+{
+	SDL_Surface *src, *dst;
+	int factor;
+	bool hqx;
+	std::vector<int> bands;
+};
+
+/**
+ * Hashes a range of rows of a surface (FNV-1a), to tell whether they changed since the last frame.
+ * @param surface Surface to hash.
+ * @param begin First row.
+ * @param end Row after the last one.
+ * @return Hash of the rows.
+ */
+static Uint32 hashRows(SDL_Surface *surface, int begin, int end)
+{
+	Uint32 hash = 2166136261u;
+	int bytes = surface->w * surface->format->BytesPerPixel;
+	for (int y = begin; y < end; ++y)
+	{
+		Uint8 *row = (Uint8*)surface->pixels + y * surface->pitch;
+		Uint32 *word = (Uint32*)row;
+		for (int i = 0; i < bytes / 4; ++i)
+		{
+			hash = (hash ^ word[i]) * 16777619u;
+		}
+		for (int i = bytes & ~3; i < bytes; ++i)
+		{
+			hash = (hash ^ row[i]) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+/**
+ * Thread pool entry point for upscaling one band of the screen.
+ * Every band reads one source row past each of its edges, but only writes its own destination rows.
+ * @param data Pointer to the UpscaleJob.
+ * @param index Index of the band in the job's list.
+ */
+static void upscaleBand(void *data, int index)
+{
+	UpscaleJob *job = (UpscaleJob*)data;
+	SDL_Surface *src = job->src, *dst = job->dst;
+	int begin = job->bands[index] * UPSCALE_BAND_HEIGHT;
+	int end = std::min(begin + UPSCALE_BAND_HEIGHT, src->h);
+
+	if (job->hqx)
+	{
+		switch (job->factor)
+		{
+		case 2:
+			hq2x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, begin, end);
+			break;
+		case 3:
+			hq3x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, begin, end);
+			break;
+		case 4:
+			hq4x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, begin, end);
+			break;
+		}
+	}
+	else
+	{
+		scale_rows(job->factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h, begin, end);
+	}
+}
+
+/**
+ * Upscales a surface with HQX or ScaleX, split into bands spread over the thread pool.
+ * Bands whose source rows (or the rows right next to them, which they also read)
+ * haven't changed since the last frame are skipped, as long as it's still the
+ * same destination surface holding the result of the last frame.
+ * @param src The surface to upscale.
+ * @param dst The surface to draw on, exactly factor times bigger.
+ * @param factor Scaling factor, 2, 3 or 4.
+ * @param hqx Use HQX instead of ScaleX.
+ */
+static void upscale(SDL_Surface *src, SDL_Surface *dst, int factor, bool hqx)
+{
+	int bands = (src->h + UPSCALE_BAND_HEIGHT - 1) / UPSCALE_BAND_HEIGHT;
+	std::vector<Uint32> hashes(bands);
+	for (int i = 0; i < bands; ++i)
+	{
+		hashes[i] = hashRows(src, i * UPSCALE_BAND_HEIGHT, std::min((i + 1) * UPSCALE_BAND_HEIGHT, src->h));
+	}
+
+	bool redrawAll = lastUpscale.src != src || lastUpscale.dst != dst ||
+		lastUpscale.srcPixels != src->pixels || lastUpscale.dstPixels != dst->pixels ||
+		lastUpscale.factor != factor || lastUpscale.hqx != hqx || (int)lastUpscale.hashes.size() != bands;
+
+	UpscaleJob job;
+	job.src = src;
+	job.dst = dst;
+	job.factor = factor;
+	job.hqx = hqx;
+	for (int i = 0; i < bands; ++i)
+	{
+		if (redrawAll ||
+			hashes[i] != lastUpscale.hashes[i] ||
+			(i > 0 && hashes[i - 1] != lastUpscale.hashes[i - 1]) ||
+			(i + 1 < bands && hashes[i + 1] != lastUpscale.hashes[i + 1]))
+		{
+			job.bands.push_back(i);
+		}
+	}
+
+	lastUpscale.src = src;
+	lastUpscale.dst = dst;
+	lastUpscale.srcPixels = src->pixels;
+	lastUpscale.dstPixels = dst->pixels;
+	lastUpscale.factor = factor;
+	lastUpscale.hqx = hqx;
+	lastUpscale.hashes.swap(hashes);
+
+	ThreadPool::getInstance()->run(upscaleBand, &job, (int)job.bands.size());
+}
+
+/**
+ * Forgets what was upscaled last, so the next flip redraws
+ * the whole screen. Needed whenever the display surface gets
+ * reset behind the upscaler's back, eg. on a resolution change.
+ */
+void Zoom::invalidate()
+{
+	lastUpscale.src = 0;
+	lastUpscale.dst = 0;
+	lastUpscale.hashes.clear();
+}
+
 /** Checks the SSE2 feature bit returned by the CPUID instruction
  */
 bool Zoom::haveSSE2()
@@ -605,7 +759,7 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, OpenGL *glOut)
 {
 	if (Screen::isOpenGLEnabled() && glOut->buffer_surface)
 	{
-		SDL_BlitSurface(src, 0, glOut->buffer_surface->getSurface(), 0); // TODO; this is less than ideal...
+		glOut->convert(src);
 
 		glOut->refresh(glOut->linear, glOut->iwidth, glOut->iheight, dst->w, dst->h);
 		SDL_GL_SwapBuffers();
@@ -640,7 +794,10 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	int dgap;
 	static bool proclaimed = false;
 
-	if (Options::getBool("useHQXFilter"))
+	static const bool &useHQXFilter = Options::watchBool("useHQXFilter");
+	static const bool &useScaleFilter = Options::watchBool("useScaleFilter");
+
+	if (useHQXFilter)
 	{
 		static bool initDone = false;
 
@@ -650,47 +807,45 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			initDone = true;
 		}
 
-		// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
-
 		if (dst->w == src->w * 2 && dst->h == src->h * 2)
 		{
-			hq2x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			upscale(src, dst, 2, true);
 			return 0;
 		}
 
 		if (dst->w == src->w * 3 && dst->h == src->h * 3)
 		{
-			hq3x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			upscale(src, dst, 3, true);
 			return 0;
 		}
 
 		if (dst->w == src->w * 4 && dst->h == src->h * 4)
 		{
-			hq4x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			upscale(src, dst, 4, true);
 			return 0;
 		}
 
 	}
 
-	if (Options::getBool("useScaleFilter"))
+	if (useScaleFilter)
 	{
 		// check the resolution to see which of scale2x, scale3x, etc. we need
 
 		if (dst->w == src->w * 2 && dst->h == src->h *2 && !scale_precondition(2, src->format->BytesPerPixel, src->w, src->h))
 		{
-			scale(2, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+			upscale(src, dst, 2, false);
 			return 0;
 		}
 
 		if (dst->w == src->w * 3 && dst->h == src->h *3 && !scale_precondition(3, src->format->BytesPerPixel, src->w, src->h))
 		{
-			scale(3, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+			upscale(src, dst, 3, false);
 			return 0;
 		}
 
 		if (dst->w == src->w * 4 && dst->h == src->h *4 && !scale_precondition(4, src->format->BytesPerPixel, src->w, src->h))
 		{
-			scale(4, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+			upscale(src, dst, 4, false);
 			return 0;
 		}
 
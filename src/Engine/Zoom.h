@@ -19,6 +19,8 @@ class Zoom
 	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
 	/// Check for SSE2 instructions using CPUID.
 	static bool haveSSE2(); 
+	/// Forget what was upscaled last, so the next flip redraws everything.
+	static void invalidate();
 
 private:
 
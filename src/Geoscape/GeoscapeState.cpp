@@ -565,6 +565,10 @@ void GeoscapeState::timeAdvance()
 
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
+		// Jump straight to the next step where something can happen.
+		i += skipQuietSteps(timeSpan - i);
+		if (i == timeSpan)
+			break;
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
 		switch (trigger)
@@ -590,6 +594,156 @@ void GeoscapeState::timeAdvance()
 	_globe->draw();
 }
 
+/// Extra distance kept from destinations when skipping steps, for rounding errors.
+const double QUIET_STEP_MARGIN = 1e-6;
+
+/**
+ * Checks if a moving target could reach its destination on the next step.
+ * Errs on the safe side, a false alarm just means the step isn't skipped.
+ * @param target Pointer to the moving target.
+ * @param reach How far the target and its destination can get closer in a step.
+ * @return True if the destination is within reach.
+ */
+static bool nearDestination(const MovingTarget *target, double reach)
+{
+	return target->getDestination() == 0 || target->getDistance(target->getDestination()) <= 2 * reach + QUIET_STEP_MARGIN;
+}
+
+/**
+ * Checks if the next step only moves UFOs and craft around,
+ * without any of them getting to their destination.
+ * @param flying List of flying UFOs.
+ * @param crafts List of craft with a destination.
+ * @return True if nothing can arrive on the next step.
+ */
+static bool quietStep(const std::vector<Ufo*> &flying, const std::vector<Craft*> &crafts)
+{
+	for (std::vector<Ufo*>::const_iterator i = flying.begin(); i != flying.end(); ++i)
+	{
+		if (nearDestination(*i, (*i)->getSpeedRadian()))
+			return false;
+	}
+	for (std::vector<Craft*>::const_iterator i = crafts.begin(); i != crafts.end(); ++i)
+	{
+		// Craft chasing a UFO have to account for the UFO moving first.
+		double reach = (*i)->getSpeedRadian();
+		Ufo *u = dynamic_cast<Ufo*>((*i)->getDestination());
+		if (u != 0 && u->getStatus() == Ufo::FLYING)
+		{
+			reach += u->getSpeedRadian();
+		}
+		if (nearDestination(*i, reach))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Skips over the 5 second steps where nothing happens
+ * but UFOs and craft moving and landed UFOs waiting.
+ * The skip stops before the first step that has anything else to do:
+ * a trigger, a landed UFO taking off, or a UFO or craft getting close to
+ * its destination. Moving targets still move one step at a time like in
+ * time5Seconds(), so the game plays out exactly the same, random rolls
+ * included, but with nothing in the air the time jumps straight there.
+ * @param steps Maximum number of steps to skip.
+ * @return Number of steps skipped.
+ */
+int GeoscapeState::skipQuietSteps(int steps)
+{
+	SavedGame *save = _game->getSavedGame();
+	steps = std::min(steps, save->getTime()->getStepsToTrigger() - 1);
+	if (steps <= 0 || save->getBases()->empty() || !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning())
+	{
+		return 0;
+	}
+
+	// Leftovers from the last step have to be cleaned up by time5Seconds() first.
+	for (std::vector<Waypoint*>::iterator i = save->getWaypoints()->begin(); i != save->getWaypoints()->end(); ++i)
+	{
+		if ((*i)->getFollowers()->empty())
+			return 0;
+	}
+
+	std::vector<Ufo*> flying, waiting;
+	for (std::vector<Ufo*>::iterator i = save->getUfos()->begin(); i != save->getUfos()->end(); ++i)
+	{
+		switch ((*i)->getStatus())
+		{
+		case Ufo::FLYING:
+			flying.push_back(*i);
+			break;
+		case Ufo::LANDED:
+			// The step that brings it down to 0 makes it lift off.
+			steps = std::min(steps, (*i)->getSecondsRemaining() / 5 - 1);
+			waiting.push_back(*i);
+			break;
+		case Ufo::CRASHED:
+			if ((*i)->getSecondsRemaining() == 0)
+				return 0;
+			waiting.push_back(*i);
+			break;
+		case Ufo::DESTROYED:
+			return 0;
+		}
+	}
+
+	std::vector<Craft*> crafts;
+	for (std::vector<Base*>::iterator i = save->getBases()->begin(); i != save->getBases()->end(); ++i)
+	{
+		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
+		{
+			if ((*j)->isDestroyed())
+				return 0;
+			if ((*j)->getDestination() != 0)
+			{
+				Ufo *u = dynamic_cast<Ufo*>((*j)->getDestination());
+				if (u != 0 && (!u->getDetected() || u->getStatus() == Ufo::DESTROYED))
+					return 0;
+				crafts.push_back(*j);
+			}
+		}
+	}
+	if (steps <= 0)
+	{
+		return 0;
+	}
+
+	int skipped = 0;
+	if (flying.empty() && crafts.empty())
+	{
+		skipped = steps;
+	}
+	for (; skipped < steps && quietStep(flying, crafts); ++skipped)
+	{
+		for (std::vector<Ufo*>::iterator i = flying.begin(); i != flying.end(); ++i)
+		{
+			(*i)->think();
+		}
+		for (std::vector<Craft*>::iterator i = crafts.begin(); i != crafts.end(); ++i)
+		{
+			(*i)->think();
+		}
+	}
+	if (skipped == 0)
+	{
+		return 0;
+	}
+	for (std::vector<Ufo*>::iterator i = waiting.begin(); i != waiting.end(); ++i)
+	{
+		if ((*i)->getStatus() == Ufo::LANDED)
+		{
+			(*i)->setSecondsRemaining((*i)->getSecondsRemaining() - skipped * 5);
+		}
+		else
+		{
+			(*i)->think();
+		}
+	}
+	save->getTime()->skip(skipped);
+	return skipped;
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game second, like craft movement.
@@ -648,7 +802,7 @@ void GeoscapeState::time5Seconds()
 							int soldiersOnBase = 0;
 							for (std::vector<Soldier*>::iterator j = base->getSoldiers()->begin(); j != base->getSoldiers()->end() ; ++j)
 							{
-								if (((*j)->getCraft() == 0 || (*j)->getCraft()->getStatus() != "STR_OUT") && (*j)->getWoundRecovery() == 0) soldiersOnBase++;
+								if (((*j)->getCraft() == 0 || (*j)->getCraft()->getStatus() != Craft::STATUS_OUT) && (*j)->getWoundRecovery() == 0) soldiersOnBase++;
 							}
 							if (soldiersOnBase > 0)
 							{
@@ -712,21 +866,15 @@ void GeoscapeState::time5Seconds()
 		{
 			if ((*j)->isDestroyed())
 			{
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				Country *country = _game->getSavedGame()->locateCountry(**j);
+				if (country)
 				{
-					if((*country)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*country)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(-(*j)->getRules()->getScore());
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				Region *region = _game->getSavedGame()->locateRegion(**j);
+				if (region)
 				{
-					if((*region)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*region)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(-(*j)->getRules()->getScore());
 				}
 
 				delete *j;
@@ -906,6 +1054,9 @@ void GeoscapeState::time5Seconds()
 	}
 }
 
+/// How far UFOs can detect XCOM bases from, 80 XCOM units.
+const double UFO_DETECTION_RANGE = 80 * (1 / 60.0) * (M_PI / 180.0);
+
 /**
  * Functor that attempt to detect an XCOM base.
  */
@@ -938,13 +1089,33 @@ bool DetectXCOMBase::operator()(const Ufo *ufo) const
 	}
 
 	// UFOs have a detection range of 80 XCOM units.
-	if (_base.getDistance(ufo) >= 80 * (1 / 60.0) * (M_PI / 180.0))
+	if (_base.getDistance(ufo) >= UFO_DETECTION_RANGE)
 	{
 		return false;
 	}
 	return ((int)_base.getDetectionChance() < RNG::generate(0, 100));
 }
 
+/**
+ * Checks if any UFO detects an XCOM base. Only the UFOs close enough
+ * to the base are tried, in the same order as the list of UFOs.
+ * @param save Pointer to the saved game.
+ * @param base The base to detect.
+ * @return If a UFO detected the base.
+ */
+static bool detectXCOMBase(SavedGame *save, const Base &base)
+{
+	std::vector<Target*> near;
+	save->getUfoGrid()->getNear(&base, UFO_DETECTION_RANGE, &near);
+	DetectXCOMBase detector(base);
+	for (std::vector<Target*>::const_iterator i = near.begin(); i != near.end(); ++i)
+	{
+		if (detector(static_cast<Ufo*>(*i)))
+			return true;
+	}
+	return false;
+}
+
 /**
  * Functor that marks an XCOM base for retaliation.
  * This is required because of the iterator type.
@@ -966,7 +1137,7 @@ void GeoscapeState::time10Minutes()
 		// Fuel consumption for XCOM craft.
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_OUT")
+			if ((*j)->getStatus() == Craft::STATUS_OUT)
 			{
 				(*j)->consumeFuel();
 				if (!(*j)->getLowFuel() && (*j)->getFuel() <= (*j)->getFuelLimit())
@@ -999,8 +1170,7 @@ void GeoscapeState::time10Minutes()
 		for (std::vector<Base*>::iterator iBase = _game->getSavedGame()->getBases()->begin(); iBase != _game->getSavedGame()->getBases()->end(); ++iBase)
 		{
 			// Find a UFO that detected this base, if any.
-			std::vector<Ufo*>::const_iterator uu = std::find_if(_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase));
-			if (uu != _game->getSavedGame()->getUfos()->end())
+			if (detectXCOMBase(_game->getSavedGame(), **iBase))
 			{
 				// Base found
 				(*iBase)->setRetaliationTarget(true);
@@ -1014,8 +1184,7 @@ void GeoscapeState::time10Minutes()
 		for (std::vector<Base*>::iterator iBase = _game->getSavedGame()->getBases()->begin(); iBase != _game->getSavedGame()->getBases()->end(); ++iBase)
 		{
 			// Find a UFO that detected this base, if any.
-			std::vector<Ufo*>::const_iterator uu = std::find_if(_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase));
-			if (uu != _game->getSavedGame()->getUfos()->end())
+			if (detectXCOMBase(_game->getSavedGame(), **iBase))
 			{
 				discovered[_game->getSavedGame()->locateRegion(**iBase)] = *iBase;
 			}
@@ -1135,7 +1304,7 @@ void GeoscapeState::time30Minutes()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_REFUELLING")
+			if ((*j)->getStatus() == Craft::STATUS_REFUELLING)
 			{
 				std::string item = (*j)->getRules()->getRefuelItem();
 				if (item == "")
@@ -1159,13 +1328,22 @@ void GeoscapeState::time30Minutes()
 						ss << _game->getLanguage()->getString("STR_AT_");
 						ss << (*i)->getName();
 						popup(new CraftErrorState(_game, this, ss.str()));
-						(*j)->setStatus("STR_READY");
+						(*j)->setStatus(Craft::STATUS_READY);
 					}
 				}
 			}
 		}
 	}
 
+	// Find the UFOs each base's radars reach at all, no need to check the rest
+	std::vector<Base*> *bases = _game->getSavedGame()->getBases();
+	std::vector<std::vector<Target*> > radarContacts(bases->size());
+	for (size_t b = 0; b < bases->size(); ++b)
+	{
+		_game->getSavedGame()->getUfoGrid()->getNear(bases->at(b), bases->at(b)->getRadarRange(), &radarContacts[b]);
+		std::sort(radarContacts[b].begin(), radarContacts[b].end());
+	}
+
 	// Handle UFO detection and give aliens points
 	for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
 	{
@@ -1177,31 +1355,24 @@ void GeoscapeState::time30Minutes()
 		case Ufo::FLYING:
 			points++;
 			// Get area
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+			if (Region *region = _game->getSavedGame()->locateRegion(**u))
 			{
-				if ((*k)->getRules()->insideRegion((*u)->getLongitude(), (*u)->getLatitude()))
-				{
-					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
-				}
+				//one point per UFO in-flight per half hour
+				region->addActivityAlien(points);
 			}
 			// Get country
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+			if (Country *country = _game->getSavedGame()->locateCountry(**u))
 			{
-				if ((*k)->getRules()->insideCountry((*u)->getLongitude(), (*u)->getLatitude()))
-				{
-					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
-				}
+				//one point per UFO in-flight per half hour
+				country->addActivityAlien(points);
 			}
 			if (!(*u)->getDetected())
 			{
 				bool detected = false;
 				for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end() && !detected; ++b)
 				{
-					if ((*b)->detect(*u))
+					const std::vector<Target*> &contacts = radarContacts[b - bases->begin()];
+					if (std::binary_search(contacts.begin(), contacts.end(), *u) && (*b)->detect(*u))
 					{
 						detected = true;
 						if((*b)->getHyperDetection())
@@ -1230,7 +1401,8 @@ void GeoscapeState::time30Minutes()
 				bool detected = false;
 				for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end() && !detected; ++b)
 				{
-					detected = detected || (*b)->insideRadarRange(*u);
+					const std::vector<Target*> &contacts = radarContacts[b - bases->begin()];
+					detected = detected || std::binary_search(contacts.begin(), contacts.end(), *u);
 					if((*b)->getHyperDetection())
 					{
 						(*u)->setHyperDetected(true);
@@ -1282,11 +1454,11 @@ void GeoscapeState::time1Hour()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_REPAIRS")
+			if ((*j)->getStatus() == Craft::STATUS_REPAIRS)
 			{
 				(*j)->repair();
 			}
-			else if ((*j)->getStatus() == "STR_REARMING")
+			else if ((*j)->getStatus() == Craft::STATUS_REARMING)
 			{
 				std::string s = (*j)->rearm();
 				if (s != "")
@@ -1492,21 +1664,13 @@ void GeoscapeState::time1Day()
 	// handle regional and country points for alien bases
 	for(std::vector<AlienBase*>::const_iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 	{
-		for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+		if (Region *region = _game->getSavedGame()->locateRegion(**b))
 		{
-			if ((*k)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(5);
-				break;
-			}
+			region->addActivityAlien(5);
 		}
-		for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+		if (Country *country = _game->getSavedGame()->locateCountry(**b))
 		{
-			if ((*k)->getRules()->insideCountry((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(5);
-				break;
-			}
+			country->addActivityAlien(5);
 		}
 	}
 
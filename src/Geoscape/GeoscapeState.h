@@ -73,6 +73,8 @@ public:
 	void timeDisplay();
 	/// Advances the game timer.
 	void timeAdvance();
+	/// Skips the steps where nothing but movement happens.
+	int skipQuietSteps(int steps);
 	/// Trigger whenever 5 seconds pass.
 	void time5Seconds();
 	/// Trigger whenever 10 minutes pass.
@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include "Globe.h"
 #include <cmath>
+#include <algorithm>
 #include <fstream>
 #include "../aresame.h"
 #include "../Engine/Action.h"
@@ -64,6 +65,8 @@ const double Globe::QUAD_LONGITUDE = 0.05;
 const double Globe::QUAD_LATITUDE = 0.2;
 const double Globe::ROTATE_LONGITUDE = 0.25;
 const double Globe::ROTATE_LATITUDE = 0.15;
+const double Globe::SHADOW_REUSE = 0.002;
+const double Globe::SHADOW_DRIFT = 0.05;
 
 ///helper class for `Globe` for drawing earth globe with shadows
 class GlobeStaticData
@@ -213,6 +216,10 @@ public:
 	{
 		return *earth[zoom];
 	}
+	inline const std::vector<Cord>& getEarthData(size_t zoom)
+	{
+		return earth_data[zoom];
+	}
 	inline const ShaderRepeat<Sint16>& getNoise()
 	{
 		return *random_noise;
@@ -244,7 +251,14 @@ struct Ocean
 
 struct CreateShadow
 {
-	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	/**
+	 * Gets how deep in the night a point of the globe is.
+	 * @param earth normal of the globe at the point
+	 * @param sun direction of the sun
+	 * @param noise noise added to the terminator
+	 * @return shadow level, from 0 (daylight) to 31
+	 */
+	static inline Sint16 getShadowLevel(const Cord& earth, const Cord& sun, const Sint16& noise)
 	{
 		Cord temp = earth;
 		//diff
@@ -268,40 +282,41 @@ struct CreateShadow
 		temp.x -= noise;
 
 		if(temp.x > 0.)
+			return (temp.x> 31)? 31 : (Sint16)temp.x;
+		else
+			return 0;
+	}
+
+	/**
+	 * Darkens a pixel of the globe.
+	 * @param dest pixel
+	 * @param val shadow level, from 0 (daylight) to 31
+	 * @return shaded pixel
+	 */
+	static inline Uint8 applyShadow(const Uint8& dest, Sint16 val)
+	{
+		const int d = dest & helper::ColorGroup;
+		if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
 		{
-			const Sint16 val = (temp.x> 31)? 31 : (Sint16)temp.x;
-			const int d = dest & helper::ColorGroup;
-			if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
-			{
-				//this pixel is ocean
-				return Palette::blockOffset(12) + val;
-			}
-			else
-			{
-				//this pixel is land
-				if (dest==0) return val;
-				const int s = val / 3;
-				const int e = dest+s;
-				if(e > d + helper::ColorShade)
-					return d + helper::ColorShade;
-				return e;
-			}
+			//this pixel is ocean
+			return Palette::blockOffset(12) + val;
 		}
 		else
 		{
-			const int d = dest & helper::ColorGroup;
-			if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
-			{
-				//this pixel is ocean
-				return Palette::blockOffset(12);
-			}
-			else
-			{
-				//this pixel is land
-				return dest;
-			}
+			//this pixel is land
+			if (dest==0) return val;
+			const int s = val / 3;
+			const int e = dest+s;
+			if(e > d + helper::ColorShade)
+				return d + helper::ColorShade;
+			return e;
 		}
 	}
+
+	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		return applyShadow(dest, getShadowLevel(earth, sun, noise));
+	}
 	
 	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise, const int&)
 	{
@@ -312,6 +327,44 @@ struct CreateShadow
 	}
 };
 
+/**
+ * help class used by Globe::updateShadowMask, fills the shadow mask.
+ */
+struct ShadowMask
+{
+	enum
+	{
+		/// pixel outside of the earth shape, the shadow doesn't touch it
+		NONE = 255,
+		/// pixel outside of the globe, the shadow clears it
+		SPACE = 254
+	};
+
+	static inline void func(Uint8& mask, const Cord& earth, const Cord& sun, const Sint16& noise, const int&)
+	{
+		if(earth.z)
+			mask = CreateShadow::getShadowLevel(earth, sun, noise);
+		else
+			mask = SPACE;
+	}
+};
+
+/**
+ * help class used by Globe::drawShadow, blits the shadow mask.
+ */
+struct ApplyShadow
+{
+	static inline void func(Uint8& dest, const Uint8& mask, const int&, const int&, const int&)
+	{
+		if(mask == ShadowMask::NONE)
+			return;
+		if(dest && mask != ShadowMask::SPACE)
+			dest = CreateShadow::applyShadow(dest, mask);
+		else
+			dest = 0;
+	}
+};
+
 
 
 /**
@@ -324,10 +377,18 @@ struct CreateShadow
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-Globe::Globe(Game *game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _rotLon(0.0), _rotLat(0.0), _cenX(cenX), _cenY(cenY), _game(game), _blink(true), _hover(false), _cacheLand()
+Globe::Globe(Game *game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _rotLon(0.0), _rotLat(0.0), _cenX(cenX), _cenY(cenY), _game(game), _blink(true), _hover(false), _cacheLand(), _shadowZoom(-1)
 {
 	_texture = new SurfaceSet(*_game->getResourcePack()->getSurfaceSet("TEXTURE.DAT"));
 
+	// Land lookup
+	std::list<Polygon*> *polygons = _game->getResourcePack()->getPolygons();
+	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i)
+	{
+		_landGrid.addPolygon(_landPolygons.size(), *i);
+		_landPolygons.push_back(*i);
+	}
+
 	_countries = new Surface(width, height, x, y);
 	_markers = new Surface(width, height, x, y);
 	_radars = new Surface(width, height, x, y);
@@ -560,34 +621,35 @@ double Globe::lastVisibleLat(double lon) const
  * @param poly Pointer to the polygon.
  * @return True if it's inside, False if it's outside.
  */
-bool Globe::insidePolygon(double lon, double lat, Polygon *poly) const
+bool Globe::insidePolygon(double lon, double lat, const Polygon *poly)
 {
+	// project the polygon onto the plane touching the globe at the point,
+	// so the point itself ends up at the origin
+	const double cosLat = cos(lat), sinLat = sin(lat);
 	bool backFace = true;
 	for (int i = 0; i < poly->getPoints(); ++i)
 	{
-		backFace = backFace && pointBack(poly->getLongitude(i), poly->getLatitude(i));
+		double c = cosLat * cos(poly->getLatitude(i)) * cos(poly->getLongitude(i) - lon) + sinLat * sin(poly->getLatitude(i));
+		backFace = backFace && c < 0;
 	}
-	if (backFace != pointBack(lon, lat))
+	if (backFace)
 		return false;
 
 	bool odd = false;
-	for (int i = 0; i < poly->getPoints(); ++i)
+	const int last = poly->getPoints() - 1;
+	double x_i = cos(poly->getLatitude(last)) * sin(poly->getLongitude(last) - lon);
+	double y_i = cosLat * sin(poly->getLatitude(last)) - sinLat * cos(poly->getLatitude(last)) * cos(poly->getLongitude(last) - lon);
+	for (int j = 0; j <= last; ++j)
 	{
-		int j = (i + 1) % poly->getPoints();
-
-		/*double x = lon, y = lat,
-			   x_i = poly->getLongitude(i), y_i = poly->getLatitude(i),
-			   x_j = poly->getLongitude(j), y_j = poly->getLatitude(j);*/
+		double x_j = cos(poly->getLatitude(j)) * sin(poly->getLongitude(j) - lon);
+		double y_j = cosLat * sin(poly->getLatitude(j)) - sinLat * cos(poly->getLatitude(j)) * cos(poly->getLongitude(j) - lon);
 
-		double x, y, x_i, x_j, y_i, y_j;
-		polarToCart(poly->getLongitude(i), poly->getLatitude(i), &x_i, &y_i);
-		polarToCart(poly->getLongitude(j), poly->getLatitude(j), &x_j, &y_j);
-		polarToCart(lon, lat, &x, &y);
-
-		if (((y_i < y && y_j >= y) || (y_j < y && y_i >= y)) && (x_i <= x || x_j <= x))
+		if (((y_i < 0 && y_j >= 0) || (y_j < 0 && y_i >= 0)) && (x_i <= 0 || x_j <= 0))
 		{
-			odd ^= (x_i + (y - y_i) / (y_j - y_i) * (x_j - x_i) < x);
+			odd ^= (x_i + (0 - y_i) / (y_j - y_i) * (x_j - x_i) < 0);
 		}
+		x_i = x_j;
+		y_i = y_j;
 	}
 	return odd;
 }
@@ -762,19 +824,13 @@ void Globe::center(double lon, double lat)
  */
 bool Globe::insideLand(double lon, double lat) const
 {
-	bool inside = false;
-	// We're only temporarily changing cenLon/cenLat so the "const" is actually preserved
-	Globe* const globe = const_cast<Globe* const>(this); // WARNING: BAD CODING PRACTICE
-	double oldLon = _cenLon, oldLat = _cenLat;
-	globe->_cenLon = lon;
-	globe->_cenLat = lat;
-	for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end() && !inside; ++i)
-	{
-		inside = insidePolygon(lon, lat, *i);
-	}
-	globe->_cenLon = oldLon;
-	globe->_cenLat = oldLat;
-	return inside;
+	const std::vector<int> &polygons = _landGrid.getAreas(lon, lat);
+	for (std::vector<int>::const_iterator i = polygons.begin(); i != polygons.end(); ++i)
+	{
+		if (insidePolygon(lon, lat, _landPolygons[*i]))
+			return true;
+	}
+	return false;
 }
 
 /**
@@ -1114,16 +1170,101 @@ Cord Globe::getSunDirection(double lon, double lat) const
 }
 
 
-void Globe::drawShadow()
+/**
+ * Brings the shadow mask up to date with the position of the sun.
+ * The terminator moves slowly, so the mask is left alone while the sun
+ * moves less than SHADOW_REUSE, a fraction of a shade step. Past that, only the
+ * band of pixels around the terminator is redone: the rest of the globe is
+ * far enough in daylight or in full night that it can't change before the
+ * sun moves SHADOW_DRIFT away from where that band was found.
+ * @param sun Direction of the sun.
+ */
+void Globe::updateShadowMask(const Cord &sun)
 {
-	
+	Cord drift = sun;
+	drift -= _shadowSun;
+	if (_shadowZoom == (int)_zoom && drift.norm() < SHADOW_REUSE)
+		return;
+
+	const int width = getWidth(), height = getHeight();
+	Cord bandDrift = sun;
+	bandDrift -= _shadowBandSun;
+	bool rebuild = _shadowZoom != (int)_zoom || bandDrift.norm() >= SHADOW_DRIFT;
+	if (rebuild)
+	{
+		_shadowMask.assign(width * height, ShadowMask::NONE);
+		_shadowBands.assign(height, std::make_pair(0, 0));
+
+		// the shadow level only depends on how far a normal is from the sun,
+		// and that changes 250 times slower than the sun moves
+		const double margin = 250. * SHADOW_DRIFT;
+		const std::vector<Cord> &normals = static_data.getEarthData(_zoom);
+		const int earthWidth = static_data.earth_size.first, earthHeight = static_data.earth_size.second;
+		const int offX = getX() - _cenX + earthWidth / 2, offY = getY() - _cenY + earthHeight / 2;
+		for (int y = 0; y < height; ++y)
+		{
+			int ey = y + offY;
+			if (ey < 0 || ey >= earthHeight)
+				continue;
+			int begin = width, end = 0;
+			for (int x = 0; x < width; ++x)
+			{
+				int ex = x + offX;
+				if (ex < 0 || ex >= earthWidth)
+					continue;
+				Cord temp = normals[ey * earthWidth + ex];
+				if (!temp.z)
+					continue;
+				temp -= sun;
+				double level = (temp.x * temp.x + temp.y * temp.y + temp.z * temp.z - 2) * 125.;
+				// below -67 it's daylight, above 99 it's full night, whatever the noise
+				if (level > -67 - margin && level < 99 + margin)
+				{
+					begin = std::min(begin, x);
+					end = x + 1;
+				}
+			}
+			if (begin < end)
+			{
+				_shadowBands[y] = std::make_pair(begin, end);
+			}
+		}
+		_shadowBandSun = sun;
+		_shadowZoom = _zoom;
+	}
+
 	ShaderMove<Cord> earth(static_data.getEarthShape(_zoom));
 	earth.addMove(_cenX, _cenY);
-	
+	ShaderMove<Uint8> mask(_shadowMask, width, height, getX(), getY());
+	if (rebuild)
+	{
+		ShaderDraw<ShadowMask>(mask, earth, ShaderScalar(sun), static_data.getNoise());
+	}
+	else
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			if (_shadowBands[y].first < _shadowBands[y].second)
+			{
+				mask.setDomain(GraphSubset(_shadowBands[y], std::make_pair(y, y + 1)));
+				ShaderDraw<ShadowMask>(mask, earth, ShaderScalar(sun), static_data.getNoise());
+			}
+		}
+	}
+	_shadowSun = sun;
+}
+
+/**
+ * Renders the night side of the globe, blitting
+ * the shadow mask over it.
+ */
+void Globe::drawShadow()
+{
+	updateShadowMask(getSunDirection(_cenLon, _cenLat));
+
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), static_data.getNoise());
+	ShaderDraw<ApplyShadow>(ShaderSurface(this), ShaderMove<Uint8>(_shadowMask, getWidth(), getHeight(), getX(), getY()));
 	unlock();
-		
 }
 
 
@@ -1267,7 +1408,7 @@ void Globe::drawRadars()
 		{
 			lat=(*j)->getLatitude();
 			lon=(*j)->getLongitude();
-			if ((*j)->getStatus()!= "STR_OUT")
+			if ((*j)->getStatus() != Craft::STATUS_OUT)
 				continue;
 			polarToCart(lon, lat, &x, &y);
 			range = (*j)->getRules()->getRadarRange();
@@ -1633,7 +1774,7 @@ void Globe::drawMarkers()
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
 			// Hide crafts docked at base
-			if ((*j)->getStatus() != "STR_OUT" || pointBack((*j)->getLongitude(), (*j)->getLatitude()))
+			if ((*j)->getStatus() != Craft::STATUS_OUT || pointBack((*j)->getLongitude(), (*j)->getLatitude()))
 				continue;
 
 			polarToCart((*j)->getLongitude(), (*j)->getLatitude(), &x, &y);
@@ -1755,21 +1896,15 @@ void Globe::getPolygonTextureAndShade(double lon, double lat, int *texture, int
 	*texture = -1;
 	*shade = worldshades[ CreateShadow::getShadowValue(0, Cord(0.,0.,1.), getSunDirection(lon, lat), 0) ];
 
-	// We're only temporarily changing cenLon/cenLat so the "const" is actually preserved
-	Globe* const globe = const_cast<Globe* const>(this); // WARNING: BAD CODING PRACTICE
-	double oldLon = _cenLon, oldLat = _cenLat;
-	globe->_cenLon = lon;
-	globe->_cenLat = lat;
-	for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end(); ++i)
+	const std::vector<int> &polygons = _landGrid.getAreas(lon, lat);
+	for (std::vector<int>::const_iterator i = polygons.begin(); i != polygons.end(); ++i)
 	{
-		if (insidePolygon(lon, lat, *i))
+		if (insidePolygon(lon, lat, _landPolygons[*i]))
 		{
-			*texture = (*i)->getTexture();
+			*texture = _landPolygons[*i]->getTexture();
 			break;
 		}
 	}
-	globe->_cenLon = oldLon;
-	globe->_cenLat = oldLat;
 }
 
 /**
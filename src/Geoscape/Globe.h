@@ -24,6 +24,7 @@
 #include "../Engine/InteractiveSurface.h"
 #include "../Engine/FastLineClip.h"
 #include "Cord.h"
+#include "PolarGrid.h"
 
 namespace OpenXcom
 {
@@ -52,6 +53,8 @@ private:
 	static const double QUAD_LATITUDE;
 	static const double ROTATE_LONGITUDE;
 	static const double ROTATE_LATITUDE;
+	static const double SHADOW_REUSE;
+	static const double SHADOW_DRIFT;
 
 	double _cenLon, _cenLat, _rotLon, _rotLat, _hoverLon, _hoverLat;
 	Sint16 _cenX, _cenY;
@@ -62,22 +65,30 @@ private:
 	bool _blink, _hover;
 	Timer *_blinkTimer, *_rotTimer;
 	std::list<Polygon*> _cacheLand;
+	std::vector<Polygon*> _landPolygons;
+	PolarGrid _landGrid;
 	Surface *_mkXcomBase, *_mkAlienBase, *_mkCraft, *_mkWaypoint, *_mkCity;
 	Surface *_mkFlyingUfo, *_mkLandedUfo, *_mkCrashedUfo, *_mkAlienSite;
 	FastLineClip *_clipper;
+	std::vector<Uint8> _shadowMask;
+	std::vector<std::pair<int, int> > _shadowBands;
+	Cord _shadowSun, _shadowBandSun;
+	int _shadowZoom;
 
 	/// Checks if a point is behind the globe.
 	bool pointBack(double lon, double lat) const;
 	/// Return latitude of last visible to player point on given longitude.
 	double lastVisibleLat(double lon) const;
 	/// Checks if a point is inside a polygon.
-	bool insidePolygon(double lon, double lat, Polygon *poly) const;
+	static bool insidePolygon(double lon, double lat, const Polygon *poly);
 	/// Checks if a target is near a point.
 	bool targetNear(Target* target, int x, int y) const;
 	/// Caches a set of polygons.
 	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
+	/// Brings the shadow mask up to date with the sun.
+	void updateShadowMask(const Cord &sun);
 public:
 	/// Creates a new globe at the specified position and size.
 	Globe(Game *game, int cenX, int cenY, int width, int height, int x = 0, int y = 0);
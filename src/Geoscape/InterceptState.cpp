@@ -139,7 +139,7 @@ InterceptState::InterceptState(Game *game, Globe *globe, Base *base) : State(gam
 			}
 			_crafts.push_back(*j);
 			_lstCrafts->addRow(4, (*j)->getName(_game->getLanguage()).c_str(), _game->getLanguage()->getString((*j)->getStatus()).c_str(), (*i)->getName().c_str(), ss.str().c_str());
-			if ((*j)->getStatus() == "STR_READY")
+			if ((*j)->getStatus() == Craft::STATUS_READY)
 			{
 				_lstCrafts->setCellColor(row, 1, Palette::blockOffset(8)+10);
 			}
@@ -172,7 +172,7 @@ void InterceptState::btnCancelClick(Action *)
 void InterceptState::lstCraftsClick(Action *)
 {
 	Craft* c = _crafts[_lstCrafts->getSelectedRow()];
-	if (c->getStatus() != "STR_OUT" && (c->getStatus() == "STR_READY" || Options::getBool("craftLaunchAlways")))
+	if (c->getStatus() != Craft::STATUS_OUT && (c->getStatus() == Craft::STATUS_READY || Options::getBool("craftLaunchAlways")))
 	{
 		_game->popState();
 		_game->pushState(new SelectDestinationState(_game, c, _globe));
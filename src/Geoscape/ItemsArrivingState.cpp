@@ -117,7 +117,7 @@ ItemsArrivingState::ItemsArrivingState(Game *game, GeoscapeState *state) : State
 				{
 					for (std::vector<Craft*>::iterator c = (*i)->getCrafts()->begin(); c != (*i)->getCrafts()->end(); ++c)
 					{
-						if ((*c)->getStatus() != "STR_READY")
+						if ((*c)->getStatus() != Craft::STATUS_READY)
 							continue;
 						for (std::vector<CraftWeapon*>::iterator w = (*c)->getWeapons()->begin(); w != (*c)->getWeapons()->end(); ++w)
 						{
@@ -125,7 +125,7 @@ ItemsArrivingState::ItemsArrivingState(Game *game, GeoscapeState *state) : State
 							if ((*w) != 0 && (*w)->getAmmo() < (*w)->getRules()->getAmmoMax())
 							{
 								(*w)->setRearming(true);
-								(*c)->setStatus("STR_REARMING");
+								(*c)->setStatus(Craft::STATUS_REARMING);
 							}
 						}
 					}
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include "PolarGrid.h"
+#include "Polygon.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a grid with no areas in it.
+ */
+PolarGrid::PolarGrid() : _cells(LON_CELLS * LAT_CELLS)
+{
+}
+
+/**
+ *
+ */
+PolarGrid::~PolarGrid()
+{
+}
+
+/**
+ * Gets the column of the grid a longitude falls in.
+ * @param lon Longitude in radians, any turn.
+ * @return Column of the grid.
+ */
+int PolarGrid::getColumn(double lon) const
+{
+	lon = fmod(lon, 2 * M_PI);
+	if (lon < 0)
+		lon += 2 * M_PI;
+	int column = (int)(lon / (2 * M_PI) * LON_CELLS);
+	return std::min(std::max(column, 0), LON_CELLS - 1);
+}
+
+/**
+ * Gets the row of the grid a latitude falls in.
+ * @param lat Latitude in radians.
+ * @return Row of the grid.
+ */
+int PolarGrid::getRow(double lat) const
+{
+	int row = (int)floor((lat + M_PI_2) / M_PI * LAT_CELLS);
+	return std::min(std::max(row, 0), LAT_CELLS - 1);
+}
+
+/**
+ * Adds an area to a cell, once. Areas have to be
+ * added one after the other, with all their parts.
+ * @param cell Index of the cell.
+ * @param area Index of the area.
+ */
+void PolarGrid::addToCell(int cell, int area)
+{
+	if (_cells[cell].empty() || _cells[cell].back() != area)
+	{
+		_cells[cell].push_back(area);
+	}
+}
+
+/**
+ * Removes all the areas from the grid.
+ */
+void PolarGrid::clear()
+{
+	for (std::vector<std::vector<int> >::iterator i = _cells.begin(); i != _cells.end(); ++i)
+	{
+		i->clear();
+	}
+}
+
+/**
+ * Adds a rectangle in longitude and latitude to the grid, like the ones
+ * regions and countries are made of. It wraps around when the minimum
+ * longitude is bigger than the maximum one, and covers every column when
+ * it spans a full turn.
+ * @param area Index of the area the rectangle belongs to.
+ * @param lonMin Minimum longitude in radians.
+ * @param lonMax Maximum longitude in radians.
+ * @param latMin Minimum latitude in radians.
+ * @param latMax Maximum latitude in radians.
+ */
+void PolarGrid::addRectangle(int area, double lonMin, double lonMax, double latMin, double latMax)
+{
+	int columnMin = getColumn(lonMin), columnMax = getColumn(lonMax);
+	int rowMin = getRow(latMin), rowMax = getRow(latMax);
+	int columns = columnMax - columnMin;
+	if (lonMax - lonMin >= 2 * M_PI)
+	{
+		// a full turn, like the polar areas: lonMax wraps back to lonMin's column
+		columnMin = 0;
+		columns = LON_CELLS - 1;
+	}
+	else if (lonMin > lonMax || columns < 0)
+	{
+		columns += LON_CELLS;
+	}
+	for (int row = rowMin; row <= rowMax; ++row)
+	{
+		for (int i = 0; i <= columns; ++i)
+		{
+			addToCell(row * LON_CELLS + (columnMin + i) % LON_CELLS, area);
+		}
+	}
+}
+
+/**
+ * Adds a spherical cap (all the points closer than an angle to a center) to the grid.
+ * Every cell that might touch the cap gets it.
+ * @param area Index of the area the cap belongs to.
+ * @param lon Longitude of the center in radians.
+ * @param lat Latitude of the center in radians.
+ * @param radius Angle from the center to the edge of the cap in radians.
+ */
+void PolarGrid::addCap(int area, double lon, double lat, double radius)
+{
+	const double cellWidth = 2 * M_PI / LON_CELLS, cellHeight = M_PI / LAT_CELLS;
+	// no point of a cell is further away from its center than this
+	const double reach = radius + std::max(cellWidth, cellHeight);
+	const double sinLat = sin(lat), cosLat = cos(lat);
+	int rowMin = getRow(lat - reach), rowMax = getRow(lat + reach);
+	for (int row = rowMin; row <= rowMax; ++row)
+	{
+		double cellLat = -M_PI_2 + (row + 0.5) * cellHeight;
+		double sinCellLat = sin(cellLat), cosCellLat = cos(cellLat);
+		for (int column = 0; column < LON_CELLS; ++column)
+		{
+			double cellLon = (column + 0.5) * cellWidth;
+			double c = sinLat * sinCellLat + cosLat * cosCellLat * cos(cellLon - lon);
+			if (acos(std::min(std::max(c, -1.0), 1.0)) <= reach)
+			{
+				addToCell(row * LON_CELLS + column, area);
+			}
+		}
+	}
+}
+
+/**
+ * Adds a land polygon to the grid, as the smallest cap
+ * around its center that holds all its points.
+ * @param area Index of the polygon.
+ * @param polygon Pointer to the polygon.
+ */
+void PolarGrid::addPolygon(int area, const Polygon *polygon)
+{
+	double x = 0, y = 0, z = 0;
+	for (int i = 0; i < polygon->getPoints(); ++i)
+	{
+		double lon = polygon->getLongitude(i), lat = polygon->getLatitude(i);
+		x += cos(lat) * cos(lon);
+		y += cos(lat) * sin(lon);
+		z += sin(lat);
+	}
+	double norm = sqrt(x * x + y * y + z * z);
+	if (norm == 0)
+	{
+		// spans the whole world, goes everywhere
+		addCap(area, 0, 0, M_PI);
+		return;
+	}
+	x /= norm;
+	y /= norm;
+	z /= norm;
+
+	double radius = 0;
+	for (int i = 0; i < polygon->getPoints(); ++i)
+	{
+		double lon = polygon->getLongitude(i), lat = polygon->getLatitude(i);
+		double c = x * cos(lat) * cos(lon) + y * cos(lat) * sin(lon) + z * sin(lat);
+		radius = std::max(radius, acos(std::min(std::max(c, -1.0), 1.0)));
+	}
+	addCap(area, atan2(y, x), asin(z), radius);
+}
+
+/**
+ * Gets the areas that might contain a point, in the order they were added.
+ * The point still has to be checked against each of them.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return Indexes of the areas.
+ */
+const std::vector<int> &PolarGrid::getAreas(double lon, double lat) const
+{
+	return _cells[getRow(lat) * LON_CELLS + getColumn(lon)];
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_POLARGRID_H
+#define OPENXCOM_POLARGRID_H
+
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Polygon;
+
+/**
+ * A grid over the longitude and latitude of the world that remembers
+ * which areas (land polygons, regions, countries...) touch each of its cells,
+ * so checking what a point is inside of only has to test a couple of them.
+ * Areas are known by their index in whatever list the owner keeps.
+ * Once it's filled, it's only read, so it can be used by any thread.
+ */
+class PolarGrid
+{
+private:
+	static const int LON_CELLS = 144;
+	static const int LAT_CELLS = 72;
+	std::vector<std::vector<int> > _cells;
+	/// Gets the column of a longitude.
+	int getColumn(double lon) const;
+	/// Gets the row of a latitude.
+	int getRow(double lat) const;
+	/// Adds an area to a cell.
+	void addToCell(int cell, int area);
+public:
+	/// Creates an empty grid.
+	PolarGrid();
+	/// Cleans up the grid.
+	~PolarGrid();
+	/// Removes all the areas from the grid.
+	void clear();
+	/// Adds a longitude/latitude rectangle to the grid.
+	void addRectangle(int area, double lonMin, double lonMax, double latMin, double latMax);
+	/// Adds a spherical cap to the grid.
+	void addCap(int area, double lon, double lat, double radius);
+	/// Adds a land polygon to the grid.
+	void addPolygon(int area, const Polygon *polygon);
+	/// Gets the areas that might contain a point.
+	const std::vector<int> &getAreas(double lon, double lat) const;
+};
+
+}
+
+#endif
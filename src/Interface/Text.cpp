@@ -19,6 +19,7 @@
 #include <cctype>
 #include "Text.h"
 #include <sstream>
+#include <algorithm>
 #include "../Engine/Font.h"
 #include "../Engine/Options.h"
 #include "../Engine/Language.h"
@@ -146,8 +147,12 @@ void Text::setFonts(Font *big, Font *small)
  */
 void Text::setText(const std::wstring &text)
 {
-	_text = text;
-	processText();
+	// the same text doesn't need laying out or drawing again
+	if (text != _text)
+	{
+		_text = text;
+		processText();
+	}
 	// If big text won't fit the space, try small text
 	if (_font == _big && !_wrap && getTextWidth() > getWidth() && _text[_text.size()-1] != L'.')
 	{
@@ -370,7 +375,7 @@ void Text::processText()
 			if (*c == L'\xa0')
 				charWidth = font->getWidth() / 2;
 			else
-				charWidth = font->getChar(*c)->getCrop()->w + font->getSpacing();
+				charWidth = font->getCharRect(*c).w + font->getSpacing();
 
 			width += charWidth;
 			word += charWidth;
@@ -405,7 +410,8 @@ void Text::draw()
 	}
 
 	// Show text borders for debugging
-	if (Options::getBool("debugUi"))
+	static const bool &debugUi = Options::watchBool("debugUi");
+	if (debugUi)
 	{
 		SDL_Rect r;
 		r.w = getWidth();
@@ -471,7 +477,11 @@ void Text::draw()
 	// Invert text by inverting the font palette on index 3 (font palettes use indices 1-5)
 	int mid = _invert ? 3 : 0;
 
-	font->getSurface()->paletteShift(color, mul, mid);
+	Uint8 remap[256];
+	mapColors(remap, font, color, mul, mid);
+
+	lock();
+	font->getSurface()->lock();
 
 	// Draw each letter one by one
 	for (std::wstring::iterator c = s->begin(); c != s->end(); ++c)
@@ -498,29 +508,110 @@ void Text::draw()
 			}
 			if (*c == 2)
 			{
-				font->getSurface()->paletteRestore();
+				font->getSurface()->unlock();
 				font = _small;
-				font->getSurface()->paletteShift(color, mul, mid);
+				font->getSurface()->lock();
+				mapColors(remap, font, color, mul, mid);
 			}
 		}
 		else if (*c == 1)
 		{
-			font->getSurface()->paletteRestore();
 			color = (color == _color ? _color2 : _color);
-			font->getSurface()->paletteShift(color, mul, mid);
+			mapColors(remap, font, color, mul, mid);
 		}
 		else
 		{
-			Surface* chr = font->getChar(*c);
-			chr->setX(x);
-			chr->setY(y);
-			chr->blit(this);
-			x += chr->getCrop()->w + font->getSpacing();
+			const SDL_Rect &chr = font->getCharRect(*c);
+			drawChar(font, chr, x, y, remap);
+			x += chr.w + font->getSpacing();
+		}
+	}
+
+	font->getSurface()->unlock();
+	unlock();
+}
+
+/**
+ * Works out which color every color of a font ends up as when drawn
+ * in a certain text color, exactly like blitting the font with its palette
+ * shifted by Surface::paletteShift() would, but without touching the font.
+ * @param remap Table to fill, indexed by the font's colors.
+ * @param font Font to draw with.
+ * @param color Text color.
+ * @param mul Color multiplier for high contrast.
+ * @param mid Color to invert around, 0 for none.
+ */
+void Text::mapColors(Uint8 *remap, Font *font, int color, int mul, int mid) const
+{
+	SDL_Color *from = font->getSurface()->getPalette();
+	SDL_Color *to = getPalette();
+	int ncolors = font->getSurface()->getSurface()->format->palette->ncolors;
+	int tocolors = getSurface()->format->palette->ncolors;
+
+	SDL_Color shifted[256];
+	bool identical = (ncolors <= tocolors);
+	for (int i = 0; i < ncolors; ++i)
+	{
+		int inverseOffset = mid ? 2 * (mid - i) : 0;
+		int j = (i * mul + color + inverseOffset + ncolors) % ncolors;
+		shifted[i] = from[j];
+		identical = identical && from[j].r == to[i].r && from[j].g == to[i].g && from[j].b == to[i].b;
+	}
+
+	for (int i = 0; i < font->getColors(); ++i)
+	{
+		if (identical)
+		{
+			remap[i] = i;
+			continue;
+		}
+		// closest color, the same way SDL matches up different palettes
+		unsigned int smallest = ~0u;
+		remap[i] = 0;
+		for (int k = 0; k < tocolors; ++k)
+		{
+			int rd = to[k].r - shifted[i].r;
+			int gd = to[k].g - shifted[i].g;
+			int bd = to[k].b - shifted[i].b;
+			unsigned int distance = rd * rd + gd * gd + bd * bd;
+			if (distance < smallest)
+			{
+				remap[i] = k;
+				if (distance == 0)
+					break;
+				smallest = distance;
+			}
 		}
 	}
+}
 
-	// Revert text color
-	font->getSurface()->paletteRestore();
+/**
+ * Draws a character straight from the font's pixels onto the text,
+ * recoloring it on the way. Color 0 is see-through.
+ * @param font Font to draw with.
+ * @param chr Size and position of the character in the font's surface.
+ * @param x X position of the character in the text.
+ * @param y Y position of the character in the text.
+ * @param remap Colors to use for each of the font's colors.
+ */
+void Text::drawChar(Font *font, const SDL_Rect &chr, int x, int y, const Uint8 *remap)
+{
+	SDL_Surface *src = font->getSurface()->getSurface();
+	SDL_Surface *dst = getSurface();
+	int left = std::max(0, -x), right = std::min((int)chr.w, dst->w - x);
+	int top = std::max(0, -y), bottom = std::min((int)chr.h, dst->h - y);
+	for (int j = top; j < bottom; ++j)
+	{
+		const Uint8 *from = (const Uint8*)src->pixels + (chr.y + j) * src->pitch + chr.x;
+		Uint8 *to = (Uint8*)dst->pixels + (y + j) * dst->pitch + x;
+		for (int i = left; i < right; ++i)
+		{
+			if (from[i])
+			{
+				to[i] = remap[from[i]];
+			}
+		}
+	}
 }
 
 }
@@ -50,6 +50,10 @@ private:
 
 	/// Processes the contained text.
 	void processText();
+	/// Works out the colors a font is drawn with.
+	void mapColors(Uint8 *remap, Font *font, int color, int mul, int mid) const;
+	/// Draws a character from a font.
+	void drawChar(Font *font, const SDL_Rect &chr, int x, int y, const Uint8 *remap);
 public:
 	/// Creates a new text with the specified size and position.
 	Text(int width, int height, int x = 0, int y = 0);
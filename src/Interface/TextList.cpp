@@ -19,6 +19,7 @@
 #include "TextList.h"
 #include <cstdarg>
 #include <cmath>
+#include <algorithm>
 #include "../Engine/Action.h"
 #include "../Engine/Font.h"
 #include "../Engine/Palette.h"
@@ -34,7 +35,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _texts(), _columns(), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _color(0), _align(ALIGN_LEFT), _dot(false), _selectable(false), _condensed(false), _contrast(false),
+TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _rows(), _columnTexts(), _rowCache(), _rowCacheUses(0), _columns(), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _color(0), _align(ALIGN_LEFT), _dot(false), _selectable(false), _condensed(false), _contrast(false),
 																								   _selRow(0), _bg(0), _selector(0), _margin(0), _scrolling(true), _arrowLeft(), _arrowRight(), _arrowPos(-1), _scrollPos(4), _arrowType(ARROW_VERTICAL), _leftClick(0), _leftPress(0), _leftRelease(0), _rightClick(0), _rightPress(0), _rightRelease(0)
 {
 	_allowScrollOnArrowButtons = true;
@@ -51,13 +52,11 @@ TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(wid
  */
 TextList::~TextList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Text*>::iterator i = _columnTexts.begin(); i < _columnTexts.end(); ++i)
 	{
-		for (std::vector<Text*>::iterator v = (*u).begin(); v < (*u).end(); ++v)
-		{
-			delete *v;
-		}
+		delete *i;
 	}
+	invalidateRows(true);
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
 		delete *i;
@@ -123,7 +122,8 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(int row, int column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	_rows[row][column].color = color;
+	invalidateRow(row);
 	_redraw = true;
 }
 
@@ -134,10 +134,11 @@ void TextList::setCellColor(int row, int column, Uint8 color)
  */
 void TextList::setRowColor(int row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	for (std::vector<TextListCell>::iterator i = _rows[row].begin(); i < _rows[row].end(); ++i)
 	{
-		(*i)->setColor(color);
+		i->color = color;
 	}
+	invalidateRow(row);
 	_redraw = true;
 }
 
@@ -149,7 +150,7 @@ void TextList::setRowColor(int row, Uint8 color)
  */
 std::wstring TextList::getCellText(int row, int column) const
 {
-	return _texts[row][column]->getText();
+	return _rows[row][column].text;
 }
 
 /**
@@ -160,7 +161,12 @@ std::wstring TextList::getCellText(int row, int column) const
  */
 void TextList::setCellText(int row, int column, const std::wstring &text)
 {
-	_texts[row][column]->setText(text);
+	TextListCell &cell = _rows[row][column];
+	Text *txt = getColumnText(column, cell);
+	txt->setText(text);
+	cell.text = text;
+	cell.big = (txt->getFont() == _big);
+	invalidateRow(row);
 	_redraw = true;
 }
 
@@ -171,7 +177,7 @@ void TextList::setCellText(int row, int column, const std::wstring &text)
  */
 int TextList::getColumnX(int column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + _rows[0][column].x;
 }
 
 /**
@@ -181,7 +187,7 @@ int TextList::getColumnX(int column) const
  */
 int TextList::getRowY(int row) const
 {
-	return getY() + _texts[row][0]->getY();
+	return getY() + (row - (int)_scroll) * (_font->getHeight() + _font->getSpacing());
 }
 
 /**
@@ -194,27 +200,20 @@ void TextList::addRow(int cols, ...)
 {
 	va_list args;
 	va_start(args, cols);
-	std::vector<Text*> temp;
+	std::vector<TextListCell> temp;
 	int rowX = 0;
 
 	for (int i = 0; i < cols; ++i)
 	{
-		// Place text
-		Text* txt = new Text(_columns[i], _font->getHeight(), _margin + rowX, getY());
-		txt->setPalette(this->getPalette());
-		txt->setFonts(_big, _small);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		txt->setAlign(_align);
-		txt->setHighContrast(_contrast);
-		if (_font == _big)
-		{
-			txt->setBig();
-		}
-		else
-		{
-			txt->setSmall();
-		}
+		// Measure text, it's only drawn once the row is visible
+		TextListCell cell;
+		cell.color = _color;
+		cell.color2 = _color2;
+		cell.align = _align;
+		cell.contrast = _contrast;
+		cell.big = (_font == _big);
+		cell.x = _margin + rowX;
+		Text *txt = getColumnText(i, cell);
 		txt->setText(va_arg(args, wchar_t*));
 
 		// Places dots between text
@@ -222,15 +221,17 @@ void TextList::addRow(int cols, ...)
 		{
 			std::wstring buf = txt->getText();
 			int w = txt->getTextWidth();
-			while (w < _columns[i])
+			if (w < _columns[i])
 			{
-				w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
-				buf += '.';
+				int dot = _font->getChar('.')->getCrop()->w + _font->getSpacing();
+				buf.append((_columns[i] - w + dot - 1) / dot, L'.');
+				txt->setText(buf);
 			}
-			txt->setText(buf);
 		}
 
-		temp.push_back(txt);
+		cell.text = txt->getText();
+		cell.big = (txt->getFont() == _big);
+		temp.push_back(cell);
 		if (_condensed)
 		{
 			rowX += txt->getTextWidth();
@@ -240,10 +241,10 @@ void TextList::addRow(int cols, ...)
 			rowX += _columns[i];
 		}
 	}
-	_texts.push_back(temp);
+	_rows.push_back(temp);
 
-	// Place arrow buttons
-	if (_arrowPos != -1)
+	// Place arrow buttons, one pair per visible row is enough since they're moved along when scrolling
+	if (_arrowPos != -1 && _arrowLeft.size() < std::min((size_t)_visibleRows, _rows.size()))
 	{
 		ArrowShape shape1, shape2;
 		if (_arrowType == ARROW_VERTICAL)
@@ -309,12 +310,13 @@ void TextList::setColumns(int cols, ...)
 void TextList::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Text*>::iterator i = _columnTexts.begin(); i < _columnTexts.end(); ++i)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			(*v)->setPalette(colors, firstcolor, ncolors);
-		}
+		(*i)->setPalette(colors, firstcolor, ncolors);
+	}
+	for (std::vector<TextListRow>::iterator i = _rowCache.begin(); i < _rowCache.end(); ++i)
+	{
+		i->surface->setPalette(colors, firstcolor, ncolors);
 	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
@@ -348,6 +350,7 @@ void TextList::setFonts(Font *big, Font *small)
 	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
 	_selector->setPalette(getPalette());
 	_selector->setVisible(false);
+	invalidateRows(true);
 
 	for (int y = 0; y < getHeight(); y += _font->getHeight() + _font->getSpacing())
 	{
@@ -445,6 +448,7 @@ void TextList::setBig()
 	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
 	_selector->setPalette(getPalette());
 	_selector->setVisible(false);
+	invalidateRows(true);
 
 	for (int y = 0; y < getHeight(); y += _font->getHeight() + _font->getSpacing())
 	{
@@ -463,6 +467,7 @@ void TextList::setSmall()
 	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
 	_selector->setPalette(getPalette());
 	_selector->setVisible(false);
+	invalidateRows(true);
 
 	for (int y = 0; y < getHeight(); y += _font->getHeight() + _font->getSpacing())
 	{
@@ -624,15 +629,8 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			delete (*v);
-		}
-		u->clear();
-	}
-	_texts.clear();
+	_rows.clear();
+	invalidateRows(false);
 }
 
 /**
@@ -643,7 +641,7 @@ void TextList::scrollUp(bool toMax)
 {
 	if (!_scrolling)
 		return;
-	if (_texts.size() > _visibleRows && _scroll > 0)
+	if (_rows.size() > _visibleRows && _scroll > 0)
 	{
 		if (toMax) _scroll=0; else _scroll--;
 		_redraw = true;
@@ -659,9 +657,9 @@ void TextList::scrollDown(bool toMax)
 {
 	if (!_scrolling)
 		return;
-	if (_texts.size() > _visibleRows && _scroll < _texts.size() - _visibleRows)
+	if (_rows.size() > _visibleRows && _scroll < _rows.size() - _visibleRows)
 	{
-		if (toMax) _scroll=_texts.size()-_visibleRows; else _scroll++;
+		if (toMax) _scroll=_rows.size()-_visibleRows; else _scroll++;
 		_redraw = true;
 	}
 	updateArrows();
@@ -673,8 +671,8 @@ void TextList::scrollDown(bool toMax)
  */
 void TextList::updateArrows()
 {
-	_up->setVisible((_texts.size() > _visibleRows && _scroll > 0));
-	_down->setVisible((_texts.size() > _visibleRows && _scroll < _texts.size() - _visibleRows));
+	_up->setVisible((_rows.size() > _visibleRows && _scroll > 0));
+	_down->setVisible((_rows.size() > _visibleRows && _scroll < _rows.size() - _visibleRows));
 }
 
 /**
@@ -699,14 +697,129 @@ void TextList::setScrolling(bool scrolling, int scrollPos)
 void TextList::draw()
 {
 	Surface::draw();
-	for (unsigned int i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+	for (unsigned int i = _scroll; i < _rows.size() && i < _scroll + _visibleRows; ++i)
+	{
+		Surface *row = getRowSurface(i);
+		row->setY((i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+		row->blit(this);
+	}
+}
+
+/**
+ * Gets the Text used for a column, set up to measure or draw a cell.
+ * There's only one per column, shared by every row.
+ * @param column Column number.
+ * @param cell Cell to set it up for.
+ * @return Pointer to the column's Text.
+ */
+Text *TextList::getColumnText(int column, const TextListCell &cell)
+{
+	while ((int)_columnTexts.size() <= column)
+	{
+		int i = _columnTexts.size();
+		Text *txt = new Text(_columns[i], std::max(_big->getHeight(), _small->getHeight()), 0, 0);
+		txt->setPalette(getPalette());
+		txt->setFonts(_big, _small);
+		_columnTexts.push_back(txt);
+	}
+	Text *txt = _columnTexts[column];
+	txt->setColor(cell.color);
+	txt->setSecondaryColor(cell.color2);
+	txt->setAlign(cell.align);
+	txt->setHighContrast(cell.contrast);
+	if (cell.big)
+	{
+		txt->setBig();
+	}
+	else
+	{
+		txt->setSmall();
+	}
+	txt->setX(cell.x);
+	return txt;
+}
+
+/**
+ * Gets a row with all its cells drawn on a surface the width of the list.
+ * The most recently drawn rows are kept, so scrolling back and forth
+ * or redrawing the list doesn't draw their text all over again.
+ * @param row Row number.
+ * @return Pointer to the row's surface.
+ */
+Surface *TextList::getRowSurface(int row)
+{
+	TextListRow *slot = 0;
+	for (std::vector<TextListRow>::iterator i = _rowCache.begin(); i < _rowCache.end(); ++i)
 	{
-		for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
+		if (i->row == row)
+		{
+			i->used = ++_rowCacheUses;
+			return i->surface;
+		}
+		if (slot == 0 || i->used < slot->used)
 		{
-			(*j)->setY((i - _scroll) * (_font->getHeight() + _font->getSpacing()));
-			(*j)->blit(this);
+			slot = &(*i);
 		}
 	}
+
+	// a couple of screens worth of rows is plenty
+	if (_rowCache.size() < 2 * _visibleRows)
+	{
+		TextListRow entry;
+		entry.surface = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), 0, 0);
+		entry.surface->setPalette(getPalette());
+		_rowCache.push_back(entry);
+		slot = &_rowCache.back();
+	}
+
+	slot->row = row;
+	slot->used = ++_rowCacheUses;
+	slot->surface->clear();
+	for (size_t i = 0; i < _rows[row].size(); ++i)
+	{
+		Text *txt = getColumnText(i, _rows[row][i]);
+		txt->setText(_rows[row][i].text);
+		txt->setY(0);
+		txt->blit(slot->surface);
+	}
+	return slot->surface;
+}
+
+/**
+ * Forgets the drawn surface of a row, after its contents changed.
+ * @param row Row number.
+ */
+void TextList::invalidateRow(int row)
+{
+	for (std::vector<TextListRow>::iterator i = _rowCache.begin(); i < _rowCache.end(); ++i)
+	{
+		if (i->row == row)
+		{
+			i->row = -1;
+			i->used = 0;
+		}
+	}
+}
+
+/**
+ * Forgets the drawn surfaces of all rows.
+ * @param resize True to also free the surfaces, eg. when the row height changes.
+ */
+void TextList::invalidateRows(bool resize)
+{
+	for (std::vector<TextListRow>::iterator i = _rowCache.begin(); i < _rowCache.end(); ++i)
+	{
+		i->row = -1;
+		i->used = 0;
+		if (resize)
+		{
+			delete i->surface;
+		}
+	}
+	if (resize)
+	{
+		_rowCache.clear();
+	}
 }
 
 /**
@@ -726,11 +839,11 @@ void TextList::blit(Surface *surface)
 		_down->blit(surface);
 		if (_arrowPos != -1)
 		{
-			for (unsigned int i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+			for (unsigned int i = 0; i < _arrowLeft.size() && _scroll + i < _rows.size(); ++i)
 			{
-				_arrowLeft[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowLeft[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowLeft[i]->blit(surface);
-				_arrowRight[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowRight[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowRight[i]->blit(surface);
 			}
 		}
@@ -749,7 +862,7 @@ void TextList::handle(Action *action, State *state)
 	_down->handle(action, state);
 	if (_arrowPos != -1)
 	{
-		for (unsigned int i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+		for (unsigned int i = 0; i < _arrowLeft.size() && _scroll + i < _rows.size(); ++i)
 		{
 			_arrowLeft[i]->handle(action, state);
 			_arrowRight[i]->handle(action, state);
@@ -794,7 +907,7 @@ void TextList::mousePress(Action *action, State *state)
 	}
 	if (_selectable)
 	{
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			InteractiveSurface::mousePress(action, state);
 		}
@@ -814,7 +927,7 @@ void TextList::mouseRelease(Action *action, State *state)
 {
 	if (_selectable)
 	{
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			InteractiveSurface::mouseRelease(action, state);
 		}
@@ -834,7 +947,7 @@ void TextList::mouseClick(Action *action, State *state)
 {
 	if (_selectable)
 	{
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			InteractiveSurface::mouseClick(action, state);
 		}
@@ -857,7 +970,7 @@ void TextList::mouseOver(Action *action, State *state)
 		int h = _font->getHeight() + _font->getSpacing();
 		_selRow = _scroll + (int)floor(action->getRelativeYMouse() / (h * action->getYScale()));
 
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			_selector->setY(getY() + (_selRow - _scroll) * h);
 			_selector->copy(_bg);
@@ -31,16 +31,44 @@ enum ArrowOrientation { ARROW_VERTICAL, ARROW_HORIZONTAL };
 class Font;
 class ArrowButton;
 
+/**
+ * What a TextList keeps about one of its cells. Cells don't have
+ * a surface of their own, they're only drawn while their row is visible.
+ */
+struct TextListCell
+{
+	std::wstring text;
+	Uint8 color, color2;
+	TextHAlign align;
+	bool big, contrast;
+	int x;
+};
+
+/**
+ * A visible row of a TextList drawn on its own surface,
+ * kept for a while in case it's drawn again.
+ */
+struct TextListRow
+{
+	int row;
+	unsigned int used;
+	Surface *surface;
+};
+
 /**
  * List of Text's split into columns.
  * Contains a set of Text's that are automatically lined up by
  * rows and columns, like a big table, making it easy to manage
- * them together.
+ * them together. Only the rows in view are ever drawn, so lists
+ * can be as long as they want.
  */
 class TextList : public InteractiveSurface
 {
 private:
-	std::vector< std::vector<Text*> > _texts;
+	std::vector< std::vector<TextListCell> > _rows;
+	std::vector<Text*> _columnTexts;
+	std::vector<TextListRow> _rowCache;
+	unsigned int _rowCacheUses;
 	std::vector<int> _columns;
 	Font *_big, *_small, *_font;
 	unsigned int _scroll, _visibleRows;
@@ -61,6 +89,14 @@ private:
 
 	/// Updates the arrow buttons.
 	void updateArrows();
+	/// Gets the Text used to measure and draw a column.
+	Text *getColumnText(int column, const TextListCell &cell);
+	/// Gets a row drawn on its own surface.
+	Surface *getRowSurface(int row);
+	/// Forgets the drawn surface of a row.
+	void invalidateRow(int row);
+	/// Forgets all the drawn rows.
+	void invalidateRows(bool resize);
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
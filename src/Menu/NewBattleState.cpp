@@ -292,7 +292,7 @@ void NewBattleState::initSave()
 	// kill everything we don't want in this base
 	for (std::vector<Soldier*>::iterator d = base->getSoldiers()->begin(); d != base->getSoldiers()->end(); d = base->getSoldiers()->erase(d));
 	for (std::vector<Craft*>::iterator e = base->getCrafts()->begin(); e != base->getCrafts()->end(); e = base->getCrafts()->erase(e));
-	for (std::map<std::string, int>::iterator l = base->getItems()->getContents()->begin(); l != base->getItems()->getContents()->end();)
+	for (ItemContainer::Contents::iterator l = base->getItems()->getContents()->begin(); l != base->getItems()->getContents()->end();)
 	{
 		base->getItems()->removeItem(l->first, l->second);
 		l = base->getItems()->getContents()->begin();
@@ -135,7 +135,7 @@ void Armor::save(YAML::Emitter &out) const
 	out << YAML::Key << "movementType" << YAML::Value << _movementType;
 	out << YAML::Key << "size" << YAML::Value << _size;
 	out << YAML::Key << "damageModifier" << YAML::Value << YAML::BeginSeq;
-	for (int i=0; i < 8; i++)
+	for (int i=0; i < DAMAGE_TYPES; i++)
 		out << _damageModifier[i];
 	out << YAML::EndSeq << YAML::EndMap;
 }
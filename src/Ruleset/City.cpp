@@ -75,8 +75,8 @@ void City::save(YAML::Emitter &out) const
 {
 	out << YAML::BeginMap;
 	out << YAML::Key << "name" << YAML::Value << _name;
-	out << YAML::Key << "lon" << YAML::Value << _lon;
-	out << YAML::Key << "lat" << YAML::Value << _lat;
+	out << YAML::Key << "lon" << YAML::Value << _lon * 180 / M_PI;
+	out << YAML::Key << "lat" << YAML::Value << _lat * 180 / M_PI;
 	out << YAML::EndMap;
 }
 
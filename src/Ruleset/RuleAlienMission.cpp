@@ -98,6 +98,7 @@ void RuleAlienMission::save(YAML::Emitter &out) const
 {
 	out << YAML::BeginMap;
 	out << YAML::Key << "type" << YAML::Value <<_type;
+	out << YAML::Key << "points" << YAML::Value << _points;
 	out << YAML::Key << "raceWeights" << YAML::Value;
 	out << YAML::BeginMap;
 	for (std::vector<std::pair<unsigned, WeightedOptions*> >::const_iterator ii = _raceDistribution.begin();
@@ -108,6 +109,7 @@ void RuleAlienMission::save(YAML::Emitter &out) const
 	}
 	out << YAML::EndMap;
 	out << YAML::Key << "waves" << YAML::Value << _waves;
+	out << YAML::EndMap;
 }
 
 /**
@@ -97,12 +97,17 @@ void RuleCountry::save(YAML::Emitter &out) const
 	out << YAML::Key << "type" << YAML::Value << _type;
 	out << YAML::Key << "fundingBase" << YAML::Value << _fundingBase;
 	out << YAML::Key << "fundingCap" << YAML::Value << _fundingCap;
-	out << YAML::Key << "labelLon" << YAML::Value << _labelLon;
-	out << YAML::Key << "labelLat" << YAML::Value << _labelLat;
-	out << YAML::Key << "lonMin" << YAML::Value << _lonMin;
-	out << YAML::Key << "lonMax" << YAML::Value << _lonMax;
-	out << YAML::Key << "latMin" << YAML::Value << _latMin;
-	out << YAML::Key << "latMax" << YAML::Value << _latMax;
+	out << YAML::Key << "labelLon" << YAML::Value << _labelLon * 180 / M_PI;
+	out << YAML::Key << "labelLat" << YAML::Value << _labelLat * 180 / M_PI;
+	out << YAML::Key << "areas" << YAML::Value;
+	out << YAML::BeginSeq;
+	for (size_t i = 0; i != _lonMin.size(); ++i)
+	{
+		out << YAML::Flow << YAML::BeginSeq;
+		out << _lonMin[i] * 180 / M_PI << _lonMax[i] * 180 / M_PI << _latMin[i] * 180 / M_PI << _latMax[i] * 180 / M_PI;
+		out << YAML::EndSeq;
+	}
+	out << YAML::EndSeq;
 	out << YAML::EndMap;
 }
 
@@ -35,6 +35,12 @@ YAML::Emitter& operator << (YAML::Emitter& out, const RuleSlot& s)
 	return out;
 }
 
+const Atom RuleInventory::RIGHT_HAND("STR_RIGHT_HAND");
+const Atom RuleInventory::LEFT_HAND("STR_LEFT_HAND");
+const Atom RuleInventory::BELT("STR_BELT");
+const Atom RuleInventory::BACK_PACK("STR_BACK_PACK");
+const Atom RuleInventory::GROUND("STR_GROUND");
+
 /**
  * Creates a blank ruleset for a certain
  * type of inventory section.
@@ -61,7 +67,9 @@ void RuleInventory::load(const YAML::Node &node)
 		i.first() >> key;
 		if (key == "id")
 		{
-			i.second() >> _id;
+			std::string id;
+			i.second() >> id;
+			_id = id;
 		}
 		else if (key == "x")
 		{
@@ -94,7 +102,7 @@ void RuleInventory::load(const YAML::Node &node)
 void RuleInventory::save(YAML::Emitter &out) const
 {
 	out << YAML::BeginMap;
-	out << YAML::Key << "id" << YAML::Value << _id;
+	out << YAML::Key << "id" << YAML::Value << _id.str();
 	out << YAML::Key << "x" << YAML::Value << _x;
 	out << YAML::Key << "y" << YAML::Value << _y;
 	out << YAML::Key << "type" << YAML::Value << _type;
@@ -108,7 +116,7 @@ void RuleInventory::save(YAML::Emitter &out) const
  * this inventory section. Each section has a unique name.
  * @return Section name.
  */
-std::string RuleInventory::getId() const
+Atom RuleInventory::getId() const
 {
 	return _id;
 }
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include "../Engine/Atom.h"
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -44,7 +45,7 @@ class RuleItem;
 class RuleInventory
 {
 private:
-	std::string _id;
+	Atom _id;
 	int _x, _y;
 	InventoryType _type;
 	std::vector<struct RuleSlot> _slots;
@@ -54,6 +55,8 @@ public:
 	static const int SLOT_H = 16;
 	static const int HAND_W = 2;
 	static const int HAND_H = 3;
+	/// Sections the game itself needs to know about.
+	static const Atom RIGHT_HAND, LEFT_HAND, BELT, BACK_PACK, GROUND;
 	/// Creates a blank inventory ruleset.
 	RuleInventory(const std::string &id);
 	/// Cleans up the inventory ruleset.
@@ -63,7 +66,7 @@ public:
 	/// Saves the inventory data to YAML.
 	void save(YAML::Emitter& out) const;
 	/// Gets the inventory's id.
-	std::string getId() const;
+	Atom getId() const;
 	/// Gets the X position of the inventory.
 	int getX() const;
 	/// Gets the Y position of the inventory.
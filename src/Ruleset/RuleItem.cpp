@@ -57,7 +57,9 @@ void RuleItem::load(const YAML::Node &node)
 		i.first() >> key;
 		if (key == "type")
 		{
-			i.second() >> _type;
+			std::string type;
+			i.second() >> type;
+			_type = type;
 		}
 		else if (key == "name")
 		{
@@ -160,7 +162,7 @@ void RuleItem::load(const YAML::Node &node)
 		{
 			i.second() >> _clipSize;
 		}
-		else if (key == "accuracyMeee")
+		else if (key == "accuracyMelee")
 		{
 			i.second() >> _accuracyMelee;
 		}
@@ -271,7 +273,7 @@ void RuleItem::load(const YAML::Node &node)
 void RuleItem::save(YAML::Emitter &out) const
 {
 	out << YAML::BeginMap;
-	out << YAML::Key << "type" << YAML::Value << _type;
+	out << YAML::Key << "type" << YAML::Value << _type.str();
 	out << YAML::Key << "name" << YAML::Value << _name;
 	out << YAML::Key << "requires" << YAML::Value << _requires;
 	out << YAML::Key << "size" << YAML::Value << _size;
@@ -329,7 +331,7 @@ void RuleItem::save(YAML::Emitter &out) const
  * Returns the item type. Each item has a unique type.
  * @return Item name.
  */
-std::string RuleItem::getType() const
+Atom RuleItem::getType() const
 {
 	return _type;
 }
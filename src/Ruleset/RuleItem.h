@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include "../Engine/Atom.h"
 #include <yaml-cpp/yaml.h>
 
 enum ItemDamageType { DT_NONE, DT_AP, DT_IN, DT_HE, DT_LASER, DT_PLASMA, DT_STUN, DT_MELEE, DT_ACID, DT_SMOKE };
@@ -42,7 +43,8 @@ class RuleManufacture;
 class RuleItem
 {
 private:
-	std::string _type, _name; // two types of objects can have the same name
+	Atom _type;
+	std::string _name; // two types of objects can have the same name
 	std::vector<std::string> _requires;
 	float _size;
 	int _costBuy, _costSell, _transferTime, _weight;
@@ -76,7 +78,7 @@ public:
 	/// Saves the item data to YAML.
 	void save(YAML::Emitter& out) const;
 	/// Gets the item's type.
-	std::string getType() const;
+	Atom getType() const;
 	/// Gets the item's name.
 	std::string getName() const;
 	/// Gets the item's requirements.
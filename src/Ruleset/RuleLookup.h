@@ -0,0 +1,92 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_RULELOOKUP_H
+#define OPENXCOM_RULELOOKUP_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include "../Engine/Atom.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Finds the rules of one kind by name, built once the ruleset is loaded.
+ * Every rule name is turned into an atom, and the atom's ID is used as
+ * the rule's handle in a flat table, so looking up a rule is one hash
+ * lookup for the name and one array access, or just the array access
+ * for callers that already have the atom.
+ */
+template <typename T>
+class RuleLookup
+{
+private:
+	std::vector<T*> _rules;
+public:
+	/// Creates an empty lookup table.
+	RuleLookup() {}
+
+	/**
+	 * Fills the table with every rule in a list.
+	 * @param rules List of rules by name.
+	 */
+	void build(const std::map<std::string, T*> &rules)
+	{
+		std::vector<std::pair<int, T*> > handles;
+		for (typename std::map<std::string, T*>::const_iterator i = rules.begin(); i != rules.end(); ++i)
+		{
+			handles.push_back(std::make_pair(Atom(i->first).getId(), i->second));
+		}
+		_rules.assign(Atom::getCount(), (T*)0);
+		for (typename std::vector<std::pair<int, T*> >::const_iterator i = handles.begin(); i != handles.end(); ++i)
+		{
+			_rules[i->first] = i->second;
+		}
+	}
+
+	/**
+	 * Gets a rule by handle.
+	 * @param id Atom of the rule's name.
+	 * @return Pointer to the rule, or 0 if there's none.
+	 */
+	T *get(Atom id) const
+	{
+		if ((size_t)id.getId() < _rules.size())
+			return _rules[id.getId()];
+		return 0;
+	}
+
+	/**
+	 * Gets a rule by name.
+	 * @param id Name of the rule.
+	 * @return Pointer to the rule, or 0 if there's none.
+	 */
+	T *get(const std::string &id) const
+	{
+		Atom atom;
+		if (Atom::find(id, &atom))
+			return get(atom);
+		return 0;
+	}
+};
+
+}
+
+#endif
@@ -163,10 +163,15 @@ void RuleRegion::save(YAML::Emitter &out) const
 	out << YAML::BeginMap;
 	out << YAML::Key << "type" << YAML::Value << _type;
 	out << YAML::Key << "cost" << YAML::Value << _cost;
-	out << YAML::Key << "lonMin" << YAML::Value << _lonMin;
-	out << YAML::Key << "lonMax" << YAML::Value << _lonMax;
-	out << YAML::Key << "latMin" << YAML::Value << _latMin;
-	out << YAML::Key << "latMax" << YAML::Value << _latMax;
+	out << YAML::Key << "areas" << YAML::Value;
+	out << YAML::BeginSeq;
+	for (size_t i = 0; i != _lonMin.size(); ++i)
+	{
+		out << YAML::Flow << YAML::BeginSeq;
+		out << _lonMin[i] * 180 / M_PI << _lonMax[i] * 180 / M_PI << _latMin[i] * 180 / M_PI << _latMax[i] * 180 / M_PI;
+		out << YAML::EndSeq;
+	}
+	out << YAML::EndSeq;
 	out << YAML::Key << "cities" << YAML::Value;
 	out << YAML::BeginSeq;
 	for (std::vector<City*>::const_iterator i = _cities.begin(); i != _cities.end(); ++i)
@@ -177,8 +182,8 @@ void RuleRegion::save(YAML::Emitter &out) const
 	out << YAML::Key << "regionWeight" << YAML::Value << _regionWeight;
 	out << YAML::Key << "missionWeights" << YAML::Value;
 	_missionWeights.save(out);
-	out << YAML::EndMap;
 	out << YAML::Key << "missionZones" << YAML::Value << _missionZones;
+	out << YAML::EndMap;
 }
 
 /**
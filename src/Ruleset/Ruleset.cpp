@@ -18,7 +18,10 @@
  */
 #include "Ruleset.h"
 #include <fstream>
+#include <sstream>
+#include <iterator>
 #include "../aresame.h"
+#include "../version.h"
 #include "../Engine/Options.h"
 #include "../Engine/Exception.h"
 #include "../Engine/CrossPlatform.h"
@@ -58,6 +61,8 @@
 namespace OpenXcom
 {
 
+const char *Ruleset::CACHE_MAGIC = "OXRC";
+
 /**
  * Creates a ruleset with blank sets of rules.
  */
@@ -174,11 +179,37 @@ Ruleset::~Ruleset()
  */
 void Ruleset::load(const std::string &source)
 {
+	std::vector<std::string> files = getSourceFiles(source);
+	for (std::vector<std::string>::iterator i = files.begin(); i != files.end(); ++i)
+	{
+		loadFile(*i);
+	}
+	buildLookups();
+}
+
+/**
+ * Gets the files a ruleset is loaded from: all the rule
+ * files in its directory, or a single file if there's no directory.
+ * @param source The source to use.
+ * @return List of filenames.
+ */
+std::vector<std::string> Ruleset::getSourceFiles(const std::string &source)
+{
+	std::vector<std::string> files;
 	std::string dirname = CrossPlatform::getDataFolder("Ruleset/" + source + '/');
 	if (!CrossPlatform::folderExists(dirname))
-		loadFile(CrossPlatform::getDataFile("Ruleset/" + source + ".rul"));
+	{
+		files.push_back(CrossPlatform::getDataFile("Ruleset/" + source + ".rul"));
+	}
 	else
-		loadFiles(dirname);
+	{
+		std::vector<std::string> names = CrossPlatform::getFolderContents(dirname, "rul");
+		for (std::vector<std::string>::iterator i = names.begin(); i != names.end(); ++i)
+		{
+			files.push_back(dirname + *i);
+		}
+	}
+	return files;
 }
 
 /**
@@ -193,7 +224,18 @@ void Ruleset::loadFile(const std::string &filename)
 	{
 		throw Exception(filename + " not found");
 	}
-	YAML::Parser parser(fin);
+	loadStream(fin);
+	fin.close();
+}
+
+/**
+ * Loads a ruleset's contents from a YAML document.
+ * Rules that match pre-existing rules overwrite them.
+ * @param in Stream holding the document.
+ */
+void Ruleset::loadStream(std::istream &in)
+{
+	YAML::Parser parser(in);
 	YAML::Node doc;
 
 	parser.GetNextDocument(doc);
@@ -619,22 +661,34 @@ void Ruleset::loadFile(const std::string &filename)
 			}
 		}
 	}
-
-	fin.close();
 }
 
 /**
- * Load the contents of all rule files in the given directory.
- * @param dirname The name of an existing directory containing rule files.
+ * Builds the tables for looking up rules by name,
+ * once all the rules are loaded. Map data sets are
+ * left out, they keep getting added as they're used.
  */
-void Ruleset::loadFiles(const std::string &dirname)
+void Ruleset::buildLookups()
 {
-	std::vector<std::string> names = CrossPlatform::getFolderContents(dirname, "rul");
-
-	for (std::vector<std::string>::iterator i = names.begin(); i != names.end(); ++i)
-	{
-		loadFile(dirname + *i);
-	}
+	_countriesLookup.build(_countries);
+	_regionsLookup.build(_regions);
+	_facilitiesLookup.build(_facilities);
+	_craftsLookup.build(_crafts);
+	_craftWeaponsLookup.build(_craftWeapons);
+	_itemsLookup.build(_items);
+	_ufosLookup.build(_ufos);
+	_terrainsLookup.build(_terrains);
+	_soldiersLookup.build(_soldiers);
+	_unitsLookup.build(_units);
+	_alienRacesLookup.build(_alienRaces);
+	_alienDeploymentsLookup.build(_alienDeployments);
+	_armorsLookup.build(_armors);
+	_ufopaediaArticlesLookup.build(_ufopaediaArticles);
+	_invsLookup.build(_invs);
+	_researchLookup.build(_research);
+	_manufactureLookup.build(_manufacture);
+	_ufoTrajectoriesLookup.build(_ufoTrajectories);
+	_alienMissionsLookup.build(_alienMissions);
 }
 
 /**
@@ -651,55 +705,66 @@ void Ruleset::save(const std::string &filename) const
 	}
 
 	YAML::Emitter out;
+	save(out);
+	sav << out.c_str();
+	sav.close();
+}
 
+/**
+ * Saves a ruleset's contents to a YAML document, with
+ * every list of rules in the same order it was loaded in.
+ * @param out YAML emitter.
+ */
+void Ruleset::save(YAML::Emitter &out) const
+{
 	out << YAML::BeginMap;
 	out << YAML::Key << "countries" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleCountry*>::const_iterator i = _countries.begin(); i != _countries.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _countriesIndex.begin(); i != _countriesIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_countries.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "regions" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleRegion*>::const_iterator i = _regions.begin(); i != _regions.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _regionsIndex.begin(); i != _regionsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_regions.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "facilities" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleBaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _facilitiesIndex.begin(); i != _facilitiesIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_facilities.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "crafts" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleCraft*>::const_iterator i = _crafts.begin(); i != _crafts.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _craftsIndex.begin(); i != _craftsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_crafts.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "craftWeapons" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleCraftWeapon*>::const_iterator i = _craftWeapons.begin(); i != _craftWeapons.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _craftWeaponsIndex.begin(); i != _craftWeaponsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_craftWeapons.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "items" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleItem*>::const_iterator i = _items.begin(); i != _items.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _itemsIndex.begin(); i != _itemsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_items.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "ufos" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleUfo*>::const_iterator i = _ufos.begin(); i != _ufos.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _ufosIndex.begin(); i != _ufosIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_ufos.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "invs" << YAML::Value;
@@ -718,9 +783,9 @@ void Ruleset::save(const std::string &filename) const
 	out << YAML::EndSeq;
 	out << YAML::Key << "armors" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, Armor*>::const_iterator i = _armors.begin(); i != _armors.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _armorsIndex.begin(); i != _armorsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_armors.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "soldiers" << YAML::Value;
@@ -739,37 +804,37 @@ void Ruleset::save(const std::string &filename) const
 	out << YAML::EndSeq;
 	out << YAML::Key << "alienRaces" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, AlienRace*>::const_iterator i = _alienRaces.begin(); i != _alienRaces.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _aliensIndex.begin(); i != _aliensIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_alienRaces.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "alienDeployments" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, AlienDeployment*>::const_iterator i = _alienDeployments.begin(); i != _alienDeployments.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _deploymentsIndex.begin(); i != _deploymentsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_alienDeployments.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "research" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleResearch*>::const_iterator i = _research.begin(); i != _research.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _researchIndex.begin(); i != _researchIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_research.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "manufacture" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleManufacture*>::const_iterator i = _manufacture.begin(); i != _manufacture.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _manufactureIndex.begin(); i != _manufactureIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_manufacture.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "ufopaedia" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, ArticleDefinition*>::const_iterator i = _ufopaediaArticles.begin(); i != _ufopaediaArticles.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _ufopaediaIndex.begin(); i != _ufopaediaIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_ufopaediaArticles.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "ufoTrajectories" << YAML::Value;
@@ -781,9 +846,9 @@ void Ruleset::save(const std::string &filename) const
 	out << YAML::EndSeq;
 	out << YAML::Key << "alienMissions" << YAML::Value;
 	out << YAML::BeginSeq;
-	for (std::map<std::string, RuleAlienMission*>::const_iterator i = _alienMissions.begin(); i != _alienMissions.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = _alienMissionsIndex.begin(); i != _alienMissionsIndex.end(); ++i)
 	{
-		i->second->save(out);
+		_alienMissions.find(*i)->second->save(out);
 	}
 	out << YAML::EndSeq;
 	out << YAML::Key << "alienItemLevels" << YAML::Value;
@@ -793,15 +858,197 @@ void Ruleset::save(const std::string &filename) const
 		out << *i;
 	}
 	out << YAML::EndSeq;
-	/*out << YAML::Key << "startingBase" << YAML::Value;
-	_startingBase->save(out);*/
+	if (_startingBase.get() != 0)
+	{
+		out << YAML::Key << "startingBase" << YAML::Value << *_startingBase;
+	}
 	out << YAML::Key << "costSoldier" << YAML::Value << _costSoldier;
 	out << YAML::Key << "costEngineer" << YAML::Value << _costEngineer;
 	out << YAML::Key << "costScientist" << YAML::Value << _costScientist;
 	out << YAML::Key << "timePersonnel" << YAML::Value << _timePersonnel;
 	out << YAML::EndMap;
-	sav << out.c_str();
+}
+
+/**
+ * Adds some bytes to an FNV-1a hash.
+ * @param hash Hash so far.
+ * @param data Bytes to add.
+ * @param size Number of bytes.
+ * @return New hash.
+ */
+static unsigned int hashCacheBytes(unsigned int hash, const char *data, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Hashes the contents of all the files the given rulesets
+ * are loaded from, to tell if a ruleset cache is still good.
+ * The game version and CACHE_VERSION go in too, since another
+ * version may load and save the rules differently.
+ * @param sources List of ruleset sources, in loading order.
+ * @return Hash of the sources.
+ */
+unsigned int Ruleset::hashSources(const std::vector<std::string> &sources)
+{
+	// FNV-1a over the version and the names and contents of every file.
+	unsigned int hash = 2166136261u;
+	hash = (hash ^ CACHE_VERSION) * 16777619u;
+	std::string version = std::string(OPENXCOM_VERSION_LONG) + OPENXCOM_VERSION_GIT + '\0';
+	hash = hashCacheBytes(hash, version.c_str(), version.size());
+	for (std::vector<std::string>::const_iterator i = sources.begin(); i != sources.end(); ++i)
+	{
+		std::vector<std::string> files = getSourceFiles(*i);
+		for (std::vector<std::string>::const_iterator j = files.begin(); j != files.end(); ++j)
+		{
+			hash = hashCacheBytes(hash, j->c_str(), j->size() + 1);
+			std::ifstream fin(j->c_str(), std::ios::in | std::ios::binary);
+			char buffer[4096];
+			while (fin)
+			{
+				fin.read(buffer, sizeof(buffer));
+				hash = hashCacheBytes(hash, buffer, fin.gcount());
+			}
+		}
+	}
+	return hash;
+}
+
+/**
+ * Writes a 32-bit number to a cache file, lowest byte first.
+ * @param out Output stream.
+ * @param value The number.
+ */
+static void writeCacheWord(std::ostream &out, unsigned int value)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		out.put((char)((value >> (i * 8)) & 0xFF));
+	}
+}
+
+/**
+ * Reads a 32-bit number from the start of a cache file's data.
+ * @param data Cache file data.
+ * @param offset Offset of the number.
+ * @return The number.
+ */
+static unsigned int readCacheWord(const std::string &data, size_t offset)
+{
+	unsigned int value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		value |= (unsigned int)(unsigned char)data[offset + i] << (i * 8);
+	}
+	return value;
+}
+
+/**
+ * Loads the whole merged ruleset from a cache file made by saveCache(),
+ * instead of going through every source file and its overrides.
+ * The cache is only used if it was made from the same sources
+ * by the same build and version of the cache format, and it's complete.
+ * @param filename Cache filename.
+ * @param key Hash of the sources, from hashSources().
+ * @return True if the ruleset was loaded from the cache.
+ */
+bool Ruleset::loadCache(const std::string &filename, unsigned int key)
+{
+	std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!fin)
+	{
+		return false;
+	}
+	std::string data((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	fin.close();
+	if (data.size() < CACHE_HEADER || data.compare(0, 4, CACHE_MAGIC) != 0 || readCacheWord(data, 4) != CACHE_VERSION || readCacheWord(data, 8) != key
+		|| readCacheWord(data, 12) != data.size() - CACHE_HEADER)
+	{
+		return false;
+	}
+
+	std::istringstream in(data.substr(CACHE_HEADER));
+	loadStream(in);
+	buildLookups();
+	return true;
+}
+
+/**
+ * Checks that a ruleset document made by save() is stable: the
+ * rules loaded from it have to save into the very same document
+ * again. This catches a rule that saves something its loader
+ * reads differently, but not a field that load() reads and save()
+ * never writes, since that field is missing from both documents.
+ * @param document The saved ruleset.
+ * @return True if the document loads back into the same rules.
+ */
+bool Ruleset::checkCache(const std::string &document) const
+{
+	Ruleset copy;
+	try
+	{
+		std::istringstream in(document);
+		copy.loadStream(in);
+	}
+	catch (std::exception &e)
+	{
+		Log(LOG_WARNING) << "Ruleset cache doesn't load back: " << e.what();
+		return false;
+	}
+	YAML::Emitter out;
+	copy.save(out);
+	std::string reloaded = out.c_str();
+	if (!out.good() || reloaded != document)
+	{
+		size_t diff = std::mismatch(document.begin(), document.begin() + std::min(document.size(), reloaded.size()), reloaded.begin()).first - document.begin();
+		Log(LOG_WARNING) << "Ruleset cache doesn't load back into the same rules, first difference on line " << std::count(document.begin(), document.begin() + diff, '\n') + 1;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Saves the whole merged ruleset to a cache file, so the
+ * next launch can load it in one go with loadCache().
+ * Nothing is saved unless the cache loads back into the same rules.
+ * @param filename Cache filename.
+ * @param key Hash of the sources, from hashSources().
+ */
+void Ruleset::saveCache(const std::string &filename, unsigned int key) const
+{
+	YAML::Emitter out;
+	save(out);
+	if (!out.good())
+	{
+		Log(LOG_WARNING) << "Failed to save ruleset cache: " << out.GetLastError();
+		return;
+	}
+	std::string document = out.c_str();
+	if (!checkCache(document))
+	{
+		return;
+	}
+
+	std::ofstream sav(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!sav)
+	{
+		Log(LOG_WARNING) << "Failed to save ruleset cache " << filename;
+		return;
+	}
+	sav.write(CACHE_MAGIC, 4);
+	writeCacheWord(sav, CACHE_VERSION);
+	writeCacheWord(sav, key);
+	writeCacheWord(sav, document.size());
+	sav << document;
 	sav.close();
+	if (!sav)
+	{
+		Log(LOG_WARNING) << "Failed to save ruleset cache " << filename;
+	}
 }
 
 /**
@@ -830,6 +1077,7 @@ SavedGame *Ruleset::newSave() const
 	{
 		save->getRegions()->push_back(new Region(getRegion(*i)));
 	}
+	save->indexAreas();
 
 	// Set up IDs
 	std::map<std::string, int> ids;
@@ -891,8 +1139,7 @@ const std::vector<SoldierNamePool*> &Ruleset::getPools() const
  */
 RuleCountry *Ruleset::getCountry(const std::string &id) const
 {
-	std::map<std::string, RuleCountry*>::const_iterator i = _countries.find(id);
-	if (_countries.end() != i) return i->second; else return 0;
+	return _countriesLookup.get(id);
 }
 
 /**
@@ -912,8 +1159,7 @@ const std::vector<std::string> &Ruleset::getCountriesList() const
  */
 RuleRegion *Ruleset::getRegion(const std::string &id) const
 {
-	std::map<std::string, RuleRegion*>::const_iterator i = _regions.find(id);
-	if (_regions.end() != i) return i->second; else return 0;
+	return _regionsLookup.get(id);
 }
 
 /**
@@ -933,8 +1179,7 @@ const std::vector<std::string> &Ruleset::getRegionsList() const
  */
 RuleBaseFacility *Ruleset::getBaseFacility(const std::string &id) const
 {
-	std::map<std::string, RuleBaseFacility*>::const_iterator i = _facilities.find(id);
-	if (_facilities.end() != i) return i->second; else return 0;
+	return _facilitiesLookup.get(id);
 }
 
 /**
@@ -954,8 +1199,7 @@ const std::vector<std::string> &Ruleset::getBaseFacilitiesList() const
  */
 RuleCraft *Ruleset::getCraft(const std::string &id) const
 {
-	std::map<std::string, RuleCraft*>::const_iterator i = _crafts.find(id);
-	if (_crafts.end() != i) return i->second; else return 0;
+	return _craftsLookup.get(id);
 }
 
 /**
@@ -975,8 +1219,7 @@ const std::vector<std::string> &Ruleset::getCraftsList() const
  */
 RuleCraftWeapon *Ruleset::getCraftWeapon(const std::string &id) const
 {
-	std::map<std::string, RuleCraftWeapon*>::const_iterator i = _craftWeapons.find(id);
-	if (_craftWeapons.end() != i) return i->second; else return 0;
+	return _craftWeaponsLookup.get(id);
 }
 
 /**
@@ -996,10 +1239,18 @@ const std::vector<std::string> &Ruleset::getCraftWeaponsList() const
  */
 RuleItem *Ruleset::getItem(const std::string &id) const
 {
-	if (_items.find(id) != _items.end())
-		return _items.find(id)->second;
-	else
-		return 0;
+	return _itemsLookup.get(id);
+}
+
+/**
+ * Returns the rules for the specified item,
+ * straight from the item type's atom.
+ * @param id Item type.
+ * @return Rules for the item.
+ */
+RuleItem *Ruleset::getItem(Atom id) const
+{
+	return _itemsLookup.get(id);
 }
 
 /**
@@ -1019,8 +1270,7 @@ const std::vector<std::string> &Ruleset::getItemsList() const
  */
 RuleUfo *Ruleset::getUfo(const std::string &id) const
 {
-	std::map<std::string, RuleUfo*>::const_iterator i = _ufos.find(id);
-	if (_ufos.end() != i) return i->second; else return 0;
+	return _ufosLookup.get(id);
 }
 
 /**
@@ -1040,8 +1290,7 @@ const std::vector<std::string> &Ruleset::getUfosList() const
  */
 RuleTerrain *Ruleset::getTerrain(const std::string &name) const
 {
-	std::map<std::string, RuleTerrain*>::const_iterator i = _terrains.find(name);
-	if (_terrains.end() != i) return i->second; else return 0;
+	return _terrainsLookup.get(name);
 }
 
 /**
@@ -1071,8 +1320,7 @@ MapDataSet *Ruleset::getMapDataSet(const std::string &name)
  */
 RuleSoldier *Ruleset::getSoldier(const std::string &name) const
 {
-	std::map<std::string, RuleSoldier*>::const_iterator i = _soldiers.find(name);
-	if (_soldiers.end() != i) return i->second; else return 0;
+	return _soldiersLookup.get(name);
 }
 
 /**
@@ -1082,8 +1330,7 @@ RuleSoldier *Ruleset::getSoldier(const std::string &name) const
  */
 Unit *Ruleset::getUnit(const std::string &name) const
 {
-	std::map<std::string, Unit*>::const_iterator i = _units.find(name);
-	if (_units.end() != i) return i->second; else return 0;
+	return _unitsLookup.get(name);
 }
 
 /**
@@ -1093,8 +1340,7 @@ Unit *Ruleset::getUnit(const std::string &name) const
  */
 AlienRace *Ruleset::getAlienRace(const std::string &name) const
 {
-	std::map<std::string, AlienRace*>::const_iterator i = _alienRaces.find(name);
-	if (_alienRaces.end() != i) return i->second; else return 0;
+	return _alienRacesLookup.get(name);
 }
 
 /**
@@ -1114,8 +1360,7 @@ const std::vector<std::string> &Ruleset::getAlienRacesList() const
  */
 AlienDeployment *Ruleset::getDeployment(const std::string &name) const
 {
-	std::map<std::string, AlienDeployment*>::const_iterator i = _alienDeployments.find(name);
-	if (_alienDeployments.end() != i) return i->second; else return 0;
+	return _alienDeploymentsLookup.get(name);
 }
 
 /**
@@ -1135,8 +1380,7 @@ const std::vector<std::string> &Ruleset::getDeploymentsList() const
  */
 Armor *Ruleset::getArmor(const std::string &name) const
 {
-	std::map<std::string, Armor*>::const_iterator i = _armors.find(name);
-	if (_armors.end() != i) return i->second; else return 0;
+	return _armorsLookup.get(name);
 }
 
 /**
@@ -1196,8 +1440,7 @@ int Ruleset::getPersonnelTime() const
  */
 ArticleDefinition *Ruleset::getUfopaediaArticle(const std::string &name) const
 {
-	std::map<std::string, ArticleDefinition*>::const_iterator i = _ufopaediaArticles.find(name);
-	if (_ufopaediaArticles.end() != i) return i->second; else return 0;
+	return _ufopaediaArticlesLookup.get(name);
 }
 
 /**
@@ -1226,8 +1469,7 @@ std::map<std::string, RuleInventory*> *Ruleset::getInventories()
  */
 RuleInventory *Ruleset::getInventory(const std::string &id) const
 {
-	std::map<std::string, RuleInventory*>::const_iterator i = _invs.find(id);
-	if (_invs.end() != i) return i->second; else return 0;
+	return _invsLookup.get(id);
 }
 
 /**
@@ -1237,8 +1479,7 @@ RuleInventory *Ruleset::getInventory(const std::string &id) const
  */
 RuleResearch *Ruleset::getResearch (const std::string &id) const
 {
-	std::map<std::string, RuleResearch *>::const_iterator i = _research.find(id);
-	if (_research.end() != i) return i->second; else return 0;
+	return _researchLookup.get(id);
 }
 
 /**
@@ -1257,8 +1498,7 @@ const std::vector<std::string> &Ruleset::getResearchList () const
  */
 RuleManufacture *Ruleset::getManufacture (const std::string &id) const
 {
-	std::map<std::string, RuleManufacture *>::const_iterator i = _manufacture.find(id);
-	if (_manufacture.end() != i) return i->second; else return 0;
+	return _manufactureLookup.get(id);
 }
 
 /**
@@ -1300,8 +1540,7 @@ std::vector<OpenXcom::RuleBaseFacility*> Ruleset::getCustomBaseFacilities() cons
  */
 const UfoTrajectory *Ruleset::getUfoTrajectory(const std::string &id) const
 {
-	std::map<std::string, UfoTrajectory *>::const_iterator i = _ufoTrajectories.find(id);
-	if (_ufoTrajectories.end() != i) return i->second; else return 0;
+	return _ufoTrajectoriesLookup.get(id);
 }
 
 /**
@@ -1311,8 +1550,7 @@ const UfoTrajectory *Ruleset::getUfoTrajectory(const std::string &id) const
  */
 const RuleAlienMission *Ruleset::getAlienMission(const std::string &id) const
 {
-	std::map<std::string, RuleAlienMission *>::const_iterator i = _alienMissions.find(id);
-	if (_alienMissions.end() != i) return i->second; else return 0;
+	return _alienMissionsLookup.get(id);
 }
 
 /**
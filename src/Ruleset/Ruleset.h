@@ -22,7 +22,9 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <iosfwd>
 #include <yaml-cpp/yaml.h>
+#include "RuleLookup.h"
 
 namespace OpenXcom
 {
@@ -89,11 +91,41 @@ protected:
 	std::vector<std::string> _aliensIndex, _deploymentsIndex, _armorsIndex, _ufopaediaIndex, _researchIndex, _manufactureIndex;
 	std::vector<std::string> _alienMissionsIndex;
 	std::vector<std::vector<int> > _alienItemLevels;
+	RuleLookup<RuleCountry> _countriesLookup;
+	RuleLookup<RuleRegion> _regionsLookup;
+	RuleLookup<RuleBaseFacility> _facilitiesLookup;
+	RuleLookup<RuleCraft> _craftsLookup;
+	RuleLookup<RuleCraftWeapon> _craftWeaponsLookup;
+	RuleLookup<RuleItem> _itemsLookup;
+	RuleLookup<RuleUfo> _ufosLookup;
+	RuleLookup<RuleTerrain> _terrainsLookup;
+	RuleLookup<RuleSoldier> _soldiersLookup;
+	RuleLookup<Unit> _unitsLookup;
+	RuleLookup<AlienRace> _alienRacesLookup;
+	RuleLookup<AlienDeployment> _alienDeploymentsLookup;
+	RuleLookup<Armor> _armorsLookup;
+	RuleLookup<ArticleDefinition> _ufopaediaArticlesLookup;
+	RuleLookup<RuleInventory> _invsLookup;
+	RuleLookup<RuleResearch> _researchLookup;
+	RuleLookup<RuleManufacture> _manufactureLookup;
+	RuleLookup<UfoTrajectory> _ufoTrajectoriesLookup;
+	RuleLookup<RuleAlienMission> _alienMissionsLookup;
 
+	static const char *CACHE_MAGIC;
+	/// Bump whenever any rule's load() or save() changes.
+	static const unsigned int CACHE_VERSION = 3;
+	static const size_t CACHE_HEADER = 16;
+
+	/// Gets the files a ruleset is loaded from.
+	static std::vector<std::string> getSourceFiles(const std::string &source);
 	/// Loads a ruleset from a YAML file.
 	void loadFile(const std::string &filename);
-	/// Loads all ruleset files from a directory.
-	void loadFiles(const std::string &dirname);
+	/// Loads a ruleset from a YAML document.
+	void loadStream(std::istream &in);
+	/// Builds the tables for looking up rules by name.
+	void buildLookups();
+	/// Checks that a saved ruleset saves again unchanged.
+	bool checkCache(const std::string &document) const;
 public:
 	/// Creates a blank ruleset.
 	Ruleset();
@@ -103,6 +135,14 @@ public:
 	void load(const std::string &source);
 	/// Saves a ruleset to a YAML file.
 	void save(const std::string &filename) const;
+	/// Saves a ruleset to a YAML document.
+	void save(YAML::Emitter &out) const;
+	/// Hashes the files of a list of rulesets.
+	static unsigned int hashSources(const std::vector<std::string> &sources);
+	/// Loads the merged ruleset from a cache file.
+	bool loadCache(const std::string &filename, unsigned int key);
+	/// Saves the merged ruleset to a cache file.
+	void saveCache(const std::string &filename, unsigned int key) const;
 	/// Generates the starting saved game.
 	virtual SavedGame *newSave() const;
 	/// Gets the pool list for soldier names.
@@ -129,6 +169,8 @@ public:
 	const std::vector<std::string> &getCraftWeaponsList() const;
 	/// Gets the ruleset for an item type.
 	RuleItem *getItem(const std::string &id) const;
+	/// Gets the ruleset for an item type.
+	RuleItem *getItem(Atom id) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
 	/// Gets the ruleset for a UFO type.
@@ -190,6 +190,7 @@ void AlienMission::think(Game &engine, const Globe &globe)
 	{
 		//Some missions may not spawn a UFO!
 		game.getUfos()->push_back(ufo);
+		game.getUfoGrid()->insert(ufo);
 	}
 	++_nextUfoCounter;
 	if (_nextUfoCounter == wave.ufoCount)
@@ -151,7 +151,7 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 
 	_items->load(node["items"]);
 	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
+	for (ItemContainer::Contents::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
 	{
 		if (std::find(_rule->getItemsList().begin(), _rule->getItemsList().end(), i->first) == _rule->getItemsList().end())
 		{
@@ -415,6 +415,16 @@ bool Base::detect(Target *target) const
  * @return True if it's inside, False otherwise.
  */
 bool Base::insideRadarRange(Target *target) const
+{
+	return (getDistance(target) <= getRadarRange());
+}
+
+/**
+ * Returns the range of the longest reaching finished
+ * radar in the base. Nothing further away is ever detected.
+ * @return Range in radians.
+ */
+double Base::getRadarRange() const
 {
 	double range = 0;
 	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
@@ -424,8 +434,7 @@ bool Base::insideRadarRange(Target *target) const
 			range = std::max(range, (*i)->getRules()->getRadarRange() * (1 / 60.0) * (M_PI / 180));
 		}
 	}
-	
-	return (getDistance(target) <= range);
+	return range;
 }
 
 /**
@@ -443,7 +452,7 @@ int Base::getAvailableSoldiers(bool checkCombatReadiness) const
 		{
 			total++;
 		}
-		else if (checkCombatReadiness && (((*i)->getCraft() != 0 && (*i)->getCraft()->getStatus() != "STR_OUT") || 
+		else if (checkCombatReadiness && (((*i)->getCraft() != 0 && (*i)->getCraft()->getStatus() != Craft::STATUS_OUT) || 
 			((*i)->getCraft() == 0 && (*i)->getWoundRecovery() == 0)))
 		{
 			total++;
@@ -1026,7 +1035,7 @@ int Base::getUsedPsiLabs() const
 int Base::getUsedContainment() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
+	for (ItemContainer::Contents::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
 	{
 		if (_rule->getItem((i)->first)->getAlien())
 		{
@@ -1182,7 +1191,7 @@ void Base::setupDefenses()
 	// add vehicles that are in the crafts of the base, if it's not out
 	for (std::vector<Craft*>::iterator c = getCrafts()->begin(); c != getCrafts()->end(); ++c)
 	{
-		if ((*c)->getStatus() != "STR_OUT")
+		if ((*c)->getStatus() != Craft::STATUS_OUT)
 		{
 			for (std::vector<Vehicle*>::iterator i = (*c)->getVehicles()->begin(); i != (*c)->getVehicles()->end(); ++i)
 			{
@@ -1192,10 +1201,11 @@ void Base::setupDefenses()
 	}
 
 	// add vehicles left on the base
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); )
+	std::vector<Atom> items = _items->getSortedItems();
+	for (std::vector<Atom>::iterator i = items.begin(); i != items.end(); ++i)
 	{
-		std::string itemId=(i)->first;
-		int iqty=(i)->second;
+		Atom itemId = *i;
+		int iqty = _items->getItem(itemId);
 		RuleItem *rule = _rule->getItem(itemId);
 		if (rule->isFixed())
 		{
@@ -1208,7 +1218,7 @@ void Base::setupDefenses()
 			{
 				RuleItem *ammo = _rule->getItem(rule->getCompatibleAmmo()->front());
 				int baqty = _items->getItem(ammo->getType()); // Ammo Quantity for this vehicle-type on the base
-				if (0 >= baqty || 0 >= iqty) { ++i; continue; }
+				if (0 >= baqty || 0 >= iqty) continue;
 				int canBeAdded = std::min(iqty, baqty);
 				int newAmmoPerVehicle = std::min(baqty / canBeAdded, ammo->getClipSize());;
 				int remainder = 0;
@@ -1223,10 +1233,7 @@ void Base::setupDefenses()
 				}
 				_items->removeItem(itemId, canBeAdded);
 			}
-
-			i = _items->getContents()->begin(); // we have to start over because iterator is broken because of the removeItem
 		}
-		else ++i;
 	}
 }
 
@@ -98,6 +98,8 @@ public:
 	bool detect(Target *target) const;
 	/// Checks if a target is inside the base's radar range.
 	bool insideRadarRange(Target *target) const;
+	/// Gets the range of the base's radars.
+	double getRadarRange() const;
 	/// Gets the base's available soldiers.
 	int getAvailableSoldiers(bool checkCombatReadiness = false) const;
 	/// Gets the base's total soldiers.
@@ -95,7 +95,7 @@ BattleUnit::BattleUnit(Soldier *soldier, UnitFaction faction) : _faction(faction
 	for (int i = 0; i < 5; ++i)
 		_cache[i] = 0;
 
-	_activeHand = "STR_RIGHT_HAND";
+	_activeHand = RuleInventory::RIGHT_HAND;
 
 	lastCover = Position(-1, -1, -1);
 }
@@ -142,7 +142,7 @@ BattleUnit::BattleUnit(Unit *unit, UnitFaction faction, int id, Armor *armor) :
 	for (int i = 0; i < 5; ++i)
 		_cache[i] = 0;
 
-	_activeHand = "STR_RIGHT_HAND";
+	_activeHand = RuleInventory::RIGHT_HAND;
 	
 	lastCover = Position(-1, -1, -1);
 	
@@ -1312,7 +1312,7 @@ double BattleUnit::getFiringAccuracy(BattleActionType actionType, BattleItem *it
 	if (item->getRules()->isTwoHanded())
 	{
 		// two handed weapon, means one hand should be empty
-		if (getItem("STR_RIGHT_HAND") != 0 && getItem("STR_LEFT_HAND") != 0)
+		if (getItem(RuleInventory::RIGHT_HAND) != 0 && getItem(RuleInventory::LEFT_HAND) != 0)
 		{
 			result *= 0.80;
 		}
@@ -1675,10 +1675,10 @@ BattleItem *BattleUnit::getItem(RuleInventory *slot, int x, int y) const
  * @param y Y position in slot.
  * @return Item in the slot, or NULL if none.
  */
-BattleItem *BattleUnit::getItem(const std::string &slot, int x, int y) const
+BattleItem *BattleUnit::getItem(Atom slot, int x, int y) const
 {
 	// Soldier items
-	if (slot != "STR_GROUND")
+	if (slot != RuleInventory::GROUND)
 	{
 		for (std::vector<BattleItem*>::const_iterator i = _inventory.begin(); i != _inventory.end(); ++i)
 		{
@@ -1709,8 +1709,8 @@ BattleItem *BattleUnit::getItem(const std::string &slot, int x, int y) const
 */
 BattleItem *BattleUnit::getMainHandWeapon(bool quickest) const
 {
-	BattleItem *weaponRightHand = getItem("STR_RIGHT_HAND");
-	BattleItem *weaponLeftHand = getItem("STR_LEFT_HAND");
+	BattleItem *weaponRightHand = getItem(RuleInventory::RIGHT_HAND);
+	BattleItem *weaponLeftHand = getItem(RuleInventory::LEFT_HAND);
 
 	// if there is only one weapon, or only one weapon loaded (rules out grenades) it's easy:
 	if (!weaponRightHand || !weaponRightHand->getAmmoItem() || !weaponRightHand->getAmmoItem()->getAmmoQuantity())
@@ -1752,10 +1752,10 @@ BattleItem *BattleUnit::getGrenadeFromBelt() const
  */
 bool BattleUnit::checkAmmo()
 {
-	BattleItem *weapon = getItem("STR_RIGHT_HAND");
+	BattleItem *weapon = getItem(RuleInventory::RIGHT_HAND);
 	if (!weapon || weapon->getAmmoItem() != 0 || weapon->getRules()->getBattleType() == BT_MELEE || getTimeUnits() < 15)
 	{
-		weapon = getItem("STR_LEFT_HAND");
+		weapon = getItem(RuleInventory::LEFT_HAND);
 		if (!weapon || weapon->getAmmoItem() != 0 || weapon->getRules()->getBattleType() == BT_MELEE || getTimeUnits() < 15)
 		{
 			return false;
@@ -2272,7 +2272,7 @@ std::string BattleUnit::getType() const
 /**
 /// Set unit's active hand.
  */
-void BattleUnit::setActiveHand(const std::string &hand)
+void BattleUnit::setActiveHand(Atom hand)
 {
 	if (_activeHand != hand) _cacheInvalid = true;
 	_activeHand = hand;
@@ -2280,11 +2280,11 @@ void BattleUnit::setActiveHand(const std::string &hand)
 /**
  * Get unit's active hand.
  */
-std::string BattleUnit::getActiveHand() const
+Atom BattleUnit::getActiveHand() const
 {
 	if (getItem(_activeHand)) return _activeHand;
-	if (getItem("STR_LEFT_HAND")) return "STR_LEFT_HAND";
-	return "STR_RIGHT_HAND";
+	if (getItem(RuleInventory::LEFT_HAND)) return RuleInventory::LEFT_HAND;
+	return RuleInventory::RIGHT_HAND;
 }
 
 /**
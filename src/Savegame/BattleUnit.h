@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <string>
+#include "../Engine/Atom.h"
 #include "../Battlescape/Position.h"
 #include "../Battlescape/BattlescapeGame.h"
 #include "../Ruleset/RuleItem.h"
@@ -104,7 +105,7 @@ private:
 	std::string _zombieUnit, _spawnUnit;
 	Armor *_armor;
 	SoldierGender _gender;
-	std::string _activeHand;
+	Atom _activeHand;
 	Soldier *_geoscapeSoldier;
 	BattleUnit *_charging;
 	int _turnsExposed;
@@ -270,7 +271,7 @@ public:
 	/// Gets the item in the specified slot.
 	BattleItem *getItem(RuleInventory *slot, int x = 0, int y = 0) const;
 	/// Gets the item in the specified slot.
-	BattleItem *getItem(const std::string &slot, int x = 0, int y = 0) const;
+	BattleItem *getItem(Atom slot, int x = 0, int y = 0) const;
 	/// Gets the item in the main hand.
 	BattleItem *getMainHandWeapon(bool quickest = true) const;
 	/// Gets a grenade from the belt, if any.
@@ -350,9 +351,9 @@ public:
 	/// Get unit type.
 	std::string getType() const;
 	/// Set the hand this unit is using;
-	void setActiveHand(const std::string &slot);
+	void setActiveHand(Atom slot);
 	/// Get unit's active hand.
-	std::string getActiveHand() const;
+	Atom getActiveHand() const;
 	/// Convert's unit to a faction
 	void convertToFaction(UnitFaction f);
 	/// Set health to 0 and set status dead
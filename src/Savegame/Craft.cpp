@@ -39,6 +39,12 @@
 namespace OpenXcom
 {
 
+const Atom Craft::STATUS_READY("STR_READY");
+const Atom Craft::STATUS_OUT("STR_OUT");
+const Atom Craft::STATUS_REFUELLING("STR_REFUELLING");
+const Atom Craft::STATUS_REARMING("STR_REARMING");
+const Atom Craft::STATUS_REPAIRS("STR_REPAIRS");
+
 /**
  * Initializes a craft of the specified type and
  * assigns it the latest craft ID available.
@@ -46,7 +52,7 @@ namespace OpenXcom
  * @param base Pointer to base of origin.
  * @param ids List of craft IDs (Leave NULL for no ID).
  */
-Craft::Craft(RuleCraft *rules, Base *base, int id) : MovingTarget(), _rules(rules), _base(base), _id(0), _fuel(0), _damage(0), _interceptionOrder(0), _weapons(), _status("STR_READY"), _lowFuel(false), _inBattlescape(false), _inDogfight(false), _name(L"")
+Craft::Craft(RuleCraft *rules, Base *base, int id) : MovingTarget(), _rules(rules), _base(base), _id(0), _fuel(0), _damage(0), _interceptionOrder(0), _weapons(), _status(STATUS_READY), _lowFuel(false), _inBattlescape(false), _inDogfight(false), _name(L"")
 {
 	_items = new ItemContainer();
 	if (id != 0)
@@ -166,7 +172,9 @@ void Craft::load(const YAML::Node &node, const Ruleset *rule, SavedGame *save)
 		v->load(*i);
 		_vehicles.push_back(v);
 	}
-	node["status"] >> _status;
+	std::string status;
+	node["status"] >> status;
+	_status = status;
 	node["lowFuel"] >> _lowFuel;
 	node["inBattlescape"] >> _inBattlescape;
 	node["inDogfight"] >> _inDogfight;
@@ -217,7 +225,7 @@ void Craft::save(YAML::Emitter &out) const
 		(*i)->save(out);
 	}
 	out << YAML::EndSeq;
-	out << YAML::Key << "status" << YAML::Value << _status;
+	out << YAML::Key << "status" << YAML::Value << _status.str();
 	out << YAML::Key << "lowFuel" << YAML::Value << _lowFuel;
 	out << YAML::Key << "inBattlescape" << YAML::Value << _inBattlescape;
 	out << YAML::Key << "inDogfight" << YAML::Value << false;
@@ -329,18 +337,18 @@ void Craft::setBaseOnly(Base *base)
 
 /**
  * Returns the current status of the craft.
- * @return Status string.
+ * @return Status.
  */
-std::string Craft::getStatus() const
+Atom Craft::getStatus() const
 {
 	return _status;
 }
 
 /**
  * Changes the current status of the craft.
- * @param status Status string.
+ * @param status Status.
  */
-void Craft::setStatus(const std::string &status)
+void Craft::setStatus(Atom status)
 {
 	_status = status;
 }
@@ -651,15 +659,15 @@ void Craft::checkup()
 
 	if (_damage > 0)
 	{
-		_status = "STR_REPAIRS";
+		_status = STATUS_REPAIRS;
 	}
 	else if (available != full)
 	{
-		_status = "STR_REARMING";
+		_status = STATUS_REARMING;
 	}
 	else
 	{
-		_status = "STR_REFUELLING";
+		_status = STATUS_REFUELLING;
 	}
 }
 
@@ -695,7 +703,7 @@ void Craft::repair()
 	setDamage(_damage - _rules->getRepairRate());
 	if (_damage <= 0)
 	{
-		_status = "STR_REARMING";
+		_status = STATUS_REARMING;
 	}
 }
 
@@ -708,12 +716,12 @@ void Craft::refuel()
 	setFuel(_fuel + _rules->getRefuelRate());
 	if (_fuel >= _rules->getMaxFuel())
 	{
-		_status = "STR_READY";
+		_status = STATUS_READY;
 		for (std::vector<CraftWeapon*>::iterator i = _weapons.begin(); i != _weapons.end(); ++i)
 		{
 			if (*i && (*i)->isRearming())
 			{
-				_status = "STR_REARMING";
+				_status = STATUS_REARMING;
 				break;
 			}
 		}
@@ -732,7 +740,7 @@ std::string Craft::rearm()
 	{
 		if (i == _weapons.end())
 		{
-			_status = "STR_REFUELLING";
+			_status = STATUS_REFUELLING;
 			break;
 		}
 		if (*i != 0 && (*i)->isRearming())
@@ -22,6 +22,7 @@
 #include "MovingTarget.h"
 #include <vector>
 #include <string>
+#include "../Engine/Atom.h"
 
 namespace OpenXcom
 {
@@ -50,12 +51,14 @@ private:
 	std::vector<CraftWeapon*> _weapons;
 	ItemContainer *_items;
 	std::vector<Vehicle*> _vehicles;
-	std::string _status;
+	Atom _status;
 	bool _lowFuel;
 	bool _inBattlescape;
 	bool _inDogfight;
 	std::wstring _name;
 public:
+	/// Statuses a craft can be in.
+	static const Atom STATUS_READY, STATUS_OUT, STATUS_REFUELLING, STATUS_REARMING, STATUS_REPAIRS;
 	/// Creates a craft of the specified type.
 	Craft(RuleCraft *rules, Base *base, int id = 0);
 	/// Cleans up the craft.
@@ -83,9 +86,9 @@ public:
 	/// Sets the craft's base. (without setting the craft's coordinates)
 	void setBaseOnly(Base *base);
 	/// Gets the craft's status.
-	std::string getStatus() const;
+	Atom getStatus() const;
 	/// Sets the craft's status.
-	void setStatus(const std::string &status);
+	void setStatus(Atom status);
 	/// Gets the craft's altitude.
 	std::string getAltitude() const;
 	/// Sets the craft's destination.
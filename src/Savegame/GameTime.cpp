@@ -136,6 +136,31 @@ TimeTrigger GameTime::advance()
 	return trigger;
 }
 
+/**
+ * Returns how many 5 second steps are left until
+ * advance() returns something other than TIME_5SEC.
+ * Hours, days and months only roll over on a 10 minute mark,
+ * so every step before that one only moves the seconds and minutes.
+ * @return Number of steps, including the one that sets off the trigger.
+ */
+int GameTime::getStepsToTrigger() const
+{
+	return ((10 - _minute % 10) * 60 - _second) / 5;
+}
+
+/**
+ * Advances the ingame time by several 5 second steps at once,
+ * same as calling advance() for each of them. Must stay
+ * below getStepsToTrigger(), so no trigger is ever skipped.
+ * @param steps Number of 5 second steps.
+ */
+void GameTime::skip(int steps)
+{
+	int seconds = _second + steps * 5;
+	_minute += seconds / 60;
+	_second = seconds % 60;
+}
+
 /**
  * Returns the current ingame second.
  * @return Second (0-59).
@@ -50,6 +50,10 @@ public:
 	void save(YAML::Emitter& out) const;
 	/// Advances the time by 5 seconds.
 	TimeTrigger advance();
+	/// Gets the number of 5 second steps until the next 10 minutes trigger.
+	int getStepsToTrigger() const;
+	/// Advances the time by several 5 second steps without triggers.
+	void skip(int steps);
 	/// Gets the ingame second.
 	int getSecond() const;
 	/// Gets the ingame minute.
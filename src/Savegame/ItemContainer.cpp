@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ItemContainer.h"
+#include <algorithm>
 #include "../Ruleset/Ruleset.h"
 #include "../Ruleset/RuleItem.h"
 
@@ -43,7 +44,13 @@ ItemContainer::~ItemContainer()
  */
 void ItemContainer::load(const YAML::Node &node)
 {
-	node >> _qty;
+	std::map<std::string, int> qty;
+	node >> qty;
+	_qty.clear();
+	for (std::map<std::string, int>::const_iterator i = qty.begin(); i != qty.end(); ++i)
+	{
+		_qty[i->first] = i->second;
+	}
 }
 
 /**
@@ -52,7 +59,13 @@ void ItemContainer::load(const YAML::Node &node)
  */
 void ItemContainer::save(YAML::Emitter &out) const
 {
-	out << _qty;
+	out << YAML::BeginMap;
+	std::vector<Atom> items = getSortedItems();
+	for (std::vector<Atom>::const_iterator i = items.begin(); i != items.end(); ++i)
+	{
+		out << YAML::Key << i->str() << YAML::Value << _qty.find(*i)->second;
+	}
+	out << YAML::EndMap;
 }
 
 /**
@@ -60,9 +73,9 @@ void ItemContainer::save(YAML::Emitter &out) const
  * @param id Item ID.
  * @param qty Item quantity.
  */
-void ItemContainer::addItem(const std::string &id, int qty)
+void ItemContainer::addItem(Atom id, int qty)
 {
-	if (id.empty())
+	if (id == Atom())
 	{
 		return;
 	}
@@ -78,9 +91,9 @@ void ItemContainer::addItem(const std::string &id, int qty)
  * @param id Item ID.
  * @param qty Item quantity.
  */
-void ItemContainer::removeItem(const std::string &id, int qty)
+void ItemContainer::removeItem(Atom id, int qty)
 {
-	if (id.empty() || _qty.find(id) == _qty.end())
+	if (id == Atom() || _qty.find(id) == _qty.end())
 	{
 		return;
 	}
@@ -99,14 +112,14 @@ void ItemContainer::removeItem(const std::string &id, int qty)
  * @param id Item ID.
  * @return Item quantity.
  */
-int ItemContainer::getItem(const std::string &id) const
+int ItemContainer::getItem(Atom id) const
 {
-	if (id.empty())
+	if (id == Atom())
 	{
 		return 0;
 	}
 
-	std::map<std::string, int>::const_iterator it = _qty.find(id);
+	Contents::const_iterator it = _qty.find(id);
 	if (it == _qty.end())
 	{
 		return 0;
@@ -124,7 +137,7 @@ int ItemContainer::getItem(const std::string &id) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (Contents::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
 		total += i->second;
 	}
@@ -139,7 +152,7 @@ int ItemContainer::getTotalQuantity() const
 double ItemContainer::getTotalSize(const Ruleset *rule) const
 {
 	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (Contents::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
 		total += rule->getItem(i->first)->getSize() * i->second;
 	}
@@ -150,9 +163,28 @@ double ItemContainer::getTotalSize(const Ruleset *rule) const
  * Returns all the items currently contained within.
  * @return List of contents.
  */
-std::map<std::string, int> *ItemContainer::getContents()
+ItemContainer::Contents *ItemContainer::getContents()
 {
 	return &_qty;
 }
 
+/**
+ * Returns the types of all the items currently contained within,
+ * sorted by name. The contents themselves are kept in atom order,
+ * which depends on how the rules were loaded, so anything where
+ * the order shows (saves, lists, handing out items) uses this.
+ * @return List of item types.
+ */
+std::vector<Atom> ItemContainer::getSortedItems() const
+{
+	std::vector<Atom> items;
+	items.reserve(_qty.size());
+	for (Contents::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	{
+		items.push_back(i->first);
+	}
+	std::sort(items.begin(), items.end(), AtomStringLess());
+	return items;
+}
+
 }
@@ -21,6 +21,8 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include "../Engine/Atom.h"
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -35,8 +37,11 @@ class Ruleset;
  */
 class ItemContainer
 {
+public:
+	/// Item quantities, keyed by item type in atom order.
+	typedef std::map<Atom, int> Contents;
 private:
-	std::map<std::string, int> _qty;
+	Contents _qty;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -47,17 +52,19 @@ public:
 	/// Saves the item container to YAML.
 	void save(YAML::Emitter& out) const;
 	/// Adds an item to the container.
-	void addItem(const std::string &id, int qty = 1);
+	void addItem(Atom id, int qty = 1);
 	/// Removes an item from the container.
-	void removeItem(const std::string &id, int qty = 1);
+	void removeItem(Atom id, int qty = 1);
 	/// Gets an item in the container.
-	int getItem(const std::string &id) const;
+	int getItem(Atom id) const;
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
 	double getTotalSize(const Ruleset *rule) const;
 	/// Gets all the items in the container.
-	std::map<std::string, int> *getContents();
+	Contents *getContents();
+	/// Gets the item types in the container in alphabetical order.
+	std::vector<Atom> getSortedItems() const;
 };
 
 }
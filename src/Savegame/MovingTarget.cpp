@@ -140,6 +140,16 @@ void MovingTarget::setSpeed(int speed)
 	calculateSpeed();
 }
 
+/**
+ * Returns the distance the moving target covers
+ * on every movement cycle.
+ * @return Speed in radians per 5 in-game seconds.
+ */
+double MovingTarget::getSpeedRadian() const
+{
+	return _speedRadian;
+}
+
 /**
  * Calculates the speed vector based on the
  * great circle distance to destination and
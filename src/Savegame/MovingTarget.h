@@ -56,6 +56,8 @@ public:
 	int getSpeed() const;
 	/// Sets the moving target's speed.
 	void setSpeed(int speed);
+	/// Gets the distance covered in 5 seconds.
+	double getSpeedRadian() const;
 	/// Has the moving target reached its destination?
 	bool reachedDestination() const;
 	/// Move towards the destination.
@@ -91,7 +91,7 @@ productionProgress_e Production::step(Base * b, SavedGame * g, const Ruleset *r)
 			if (_rules->getCategory() == "STR_CRAFT")
 			{
 				Craft *craft = new Craft(r->getCraft(_rules->getName()), b, g->getId(_rules->getName()));
-				craft->setStatus("STR_REFUELLING");
+				craft->setStatus(Craft::STATUS_REFUELLING);
 				b->getCrafts()->push_back(craft);
 			}
 			else
@@ -66,10 +66,6 @@ SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(
  */
 SavedBattleGame::~SavedBattleGame()
 {
-	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
-	{
-		delete _tiles[i];
-	}
 	delete[] _tiles;
 
 	for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
@@ -433,6 +429,16 @@ Tile **SavedBattleGame::getTiles() const
 	return _tiles;
 }
 
+/**
+ * Gets a pointer to the per tile data that is kept in dense arrays,
+ * for passes over the whole map.
+ * @return A pointer to the tile layers.
+ */
+TileLayers *SavedBattleGame::getTileLayers()
+{
+	return &_tileLayers;
+}
+
 /**
  * Initializes the array of tiles + creates a pathfinding object.
  * @param mapsize_x
@@ -443,10 +449,6 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z)
 {
 	if (!_nodes.empty())
 	{
-		for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
-		{
-			delete _tiles[i];
-		}
 		delete[] _tiles;
 
 		for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
@@ -461,14 +463,30 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z)
 	_mapsize_y = mapsize_y;
 	_mapsize_z = mapsize_z;
 	_tiles = new Tile*[_mapsize_z * _mapsize_y * _mapsize_x];
-	/* create tile objects */
+	_tileLayers.resize(_mapsize_z * _mapsize_y * _mapsize_x);
+	/* create tile objects, all in one block */
+	_tileStorage.clear();
+	_tileStorage.reserve(_mapsize_z * _mapsize_y * _mapsize_x);
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		Position pos;
 		getTileCoords(i, &pos.x, &pos.y, &pos.z);
-		_tiles[i] = new Tile(pos);
+		_tileStorage.push_back(Tile(pos, &_tileLayers, i));
+	}
+	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
+	{
+		_tiles[i] = &_tileStorage[i];
 	}
 
+	// the old map is gone, so is anything the tile engine knew about it
+	if (_tileEngine)
+	{
+		_tileEngine->resetTerrainCache();
+	}
+	if (_pathfinding)
+	{
+		_pathfinding->resetClusters();
+	}
 }
 
 /**
@@ -799,6 +817,9 @@ int SavedBattleGame::getTurn() const
  */
 void SavedBattleGame::endTurn()
 {
+	Log(LOG_DEBUG) << "Turn " << _turn << " side " << _side << ": " << _tileEngine->getRaysCast() << " FOV rays cast, " << _tileEngine->getRaysReused() << " reused";
+	_tileEngine->resetFOVStatistics();
+
 	if (_side == FACTION_PLAYER)
 	{
 		if (_selectedUnit && _selectedUnit->getOriginalFaction() == FACTION_PLAYER)
@@ -1093,7 +1114,7 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 	
 	if (fromNode == 0)
 	{
-		if (Options::getBool("traceAI")) { Log(LOG_INFO) << "This alien got lost. :("; }
+		if (_traceAI) { Log(LOG_INFO) << "This alien got lost. :("; }
 		fromNode = getNodes()->at(RNG::generate(0, getNodes()->size() - 1));
 	}
 
@@ -1125,7 +1146,7 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 
 	if (compliantNodes.empty())
 	{ 
-		if (Options::getBool("traceAI")) { Log(LOG_INFO) << (scout ? "Scout " : "Guard ") << "found no patrol node! XXX XXX XXX"; }
+		if (_traceAI) { Log(LOG_INFO) << (scout ? "Scout " : "Guard ") << "found no patrol node! XXX XXX XXX"; }
 		if (unit->getArmor()->getSize() > 1 && !scout) 
 		{
 			return getPatrolNode(true, unit, fromNode); // move dammit
@@ -1140,7 +1161,7 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 	{
 		if (!preferred) return 0;
 		// non-scout patrols to highest value unoccupied node that's not fromNode
-		if (Options::getBool("traceAI")) { Log(LOG_INFO) << "Choosing node flagged " << preferred->getFlags(); }
+		if (_traceAI) { Log(LOG_INFO) << "Choosing node flagged " << preferred->getFlags(); }
 		return preferred;
 	}
 }
@@ -1157,13 +1178,13 @@ void SavedBattleGame::prepareNewTurn()
 	// prepare a list of tiles on fire/smoke
 	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
 	{
-		if (getTiles()[i]->getFire() > 0)
+		if (_tileLayers.fire[i] > 0)
 		{
-			tilesOnFire.push_back(getTiles()[i]);
+			tilesOnFire.push_back(_tiles[i]);
 		}
-		if (getTiles()[i]->getSmoke() > 0)
+		if (_tileLayers.smoke[i] > 0)
 		{
-			tilesOnSmoke.push_back(getTiles()[i]);
+			tilesOnSmoke.push_back(_tiles[i]);
 		}
 	}
 
@@ -1200,7 +1221,7 @@ void SavedBattleGame::prepareNewTurn()
 			t->addSmoke((*i)->getSmoke()/2);
 		}
 
-		(*i)->prepareNewTurn();
+		prepareTile(*i);
 	}
 
 	for (std::vector<Tile*>::iterator i = tilesOnFire.begin(); i != tilesOnFire.end(); ++i)
@@ -1246,7 +1267,7 @@ void SavedBattleGame::prepareNewTurn()
 			}
 		}
 		if (!_objectiveDestroyed)
-			_objectiveDestroyed = (*i)->prepareNewTurn();
+			_objectiveDestroyed = prepareTile(*i);
 	}
 
 	if (!tilesOnFire.empty())
@@ -1258,6 +1279,33 @@ void SavedBattleGame::prepareNewTurn()
 
 }
 
+/**
+ * Lets the smoke and fire on a tile burn down for the new turn.
+ * Only when the fire destroyed some of the tile's terrain is the cached
+ * terrain data around it updated, since most turns nothing burns down.
+ * @param tile The tile.
+ * @return True when the objective was destroyed.
+ */
+bool SavedBattleGame::prepareTile(Tile *tile)
+{
+	MapData *parts[4];
+	for (int part = 0; part < 4; ++part)
+	{
+		parts[part] = tile->getMapData(part);
+	}
+	bool objective = tile->prepareNewTurn();
+	for (int part = 0; part < 4; ++part)
+	{
+		if (tile->getMapData(part) != parts[part])
+		{
+			// burnt terrain may have opened up new lines of sight
+			getTileEngine()->terrainChanged(tile->getPosition());
+			break;
+		}
+	}
+	return objective;
+}
+
 /**
  * Units that are unconscious but shouldn't are revived, they need a tile to stand on. The unit's current position could be occupied.
  * We will search in all directions for a free tile, if not found, the unit stays unconscious...
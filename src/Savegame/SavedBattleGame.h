@@ -26,11 +26,11 @@
 #include <yaml-cpp/yaml.h>
 #include "BattleItem.h"
 #include "BattleUnit.h"
+#include "Tile.h"
 
 namespace OpenXcom
 {
 
-class Tile;
 class SavedGame;
 class MapDataSet;
 class RuleUnit;
@@ -59,6 +59,8 @@ private:
 	int _mapsize_x, _mapsize_y, _mapsize_z;
 	std::vector<MapDataSet*> _mapDataSets;
 	Tile **_tiles;
+	std::vector<Tile> _tileStorage;
+	TileLayers _tileLayers;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
 	std::vector<BattleUnit*> _units;
@@ -80,6 +82,8 @@ private:
 	std::vector<BattleUnit*> _exposedUnits;
 	std::vector<BattleUnit*> _fallingUnits;
 	bool _unitsFalling, _strafeEnabled, _sneaky, _traceAI;
+	/// Burns down the smoke and fire on a tile for the new turn.
+	bool prepareTile(Tile *tile);
 public:
 	/// Creates a new battle save, based on current generic save.
 	SavedBattleGame();
@@ -107,6 +111,8 @@ public:
 	int getGlobalShade() const;
 	/// Gets pointer to the tiles, a tile is the smallest component of battlescape.
 	Tile **getTiles() const;
+	/// Gets pointer to the dense per tile data layers.
+	TileLayers *getTileLayers();
 	/// Get pointer to the list of nodes.
 	std::vector<Node*> *getNodes();
 	/// Get pointer to the list of items.
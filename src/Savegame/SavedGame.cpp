@@ -50,6 +50,7 @@
 #include "AlienStrategy.h"
 #include "AlienMission.h"
 #include "../Ruleset/RuleRegion.h"
+#include "../Ruleset/RuleCountry.h"
 
 namespace OpenXcom
 {
@@ -277,6 +278,7 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 		r->load(*i);
 		_regions.push_back(r);
 	}
+	indexAreas();
 
 	// Alien bases must be loaded before alien missions
 	for (YAML::Iterator i = doc["alienBases"].begin(); i != doc["alienBases"].end(); ++i)
@@ -305,6 +307,7 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 		Ufo *u = new Ufo(rule->getUfo(type));
 		u->load(*i, *rule, *this);
 		_ufos.push_back(u);
+		_ufoGrid.insert(u);
 	}
 
 	for (YAML::Iterator i = doc["waypoints"].begin(); i != doc["waypoints"].end(); ++i)
@@ -705,6 +708,17 @@ std::vector<Ufo*> *SavedGame::getUfos()
 	return &_ufos;
 }
 
+/**
+ * Returns the spatial hash of the alien UFOs, for finding
+ * the ones around a position. New UFOs have to be added to
+ * it in the same order as to the list of UFOs.
+ * @return Pointer to UFO grid.
+ */
+TargetGrid *SavedGame::getUfoGrid()
+{
+	return &_ufoGrid;
+}
+
 /**
  * Returns the list of craft waypoints.
  * @return Pointer to waypoint list.
@@ -1307,20 +1321,6 @@ void SavedGame::setWarned(bool warned)
 	_warned = warned;
 }
 
-/** @brief Check if a point is contained in a region.
- * This function object checks if a point is contained inside a region.
- */
-class ContainsPoint: public std::unary_function<const Region *, bool>
-{
-public:
-	/// Remember the coordinates.
-	ContainsPoint(double lon, double lat) : _lon(lon), _lat(lat) { /* Empty by design. */ }
-	/// Check is the region contains the stored point.
-	bool operator()(const Region *region) const { return region->getRules()->insideRegion(_lon, _lat); }
-private:
-	double _lon, _lat;
-};
-
 /**
  * Find the region containing this location.
  * @param lon The longtitude.
@@ -1329,10 +1329,13 @@ private:
  */
 Region *SavedGame::locateRegion(double lon, double lat) const
 {
-	std::vector<Region *>::const_iterator found = std::find_if(_regions.begin(), _regions.end(), ContainsPoint(lon, lat));
-	if (found != _regions.end())
+	const std::vector<int> &regions = _regionGrid.getAreas(lon, lat);
+	for (std::vector<int>::const_iterator i = regions.begin(); i != regions.end(); ++i)
 	{
-		return *found;
+		if (_regions[*i]->getRules()->insideRegion(lon, lat))
+		{
+			return _regions[*i];
+		}
 	}
 	return 0;
 }
@@ -1347,6 +1350,61 @@ Region *SavedGame::locateRegion(const Target &target) const
 	return locateRegion(target.getLongitude(), target.getLatitude());
 }
 
+/**
+ * Find the country containing this location.
+ * @param lon The longtitude.
+ * @param lat The latitude.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(double lon, double lat) const
+{
+	const std::vector<int> &countries = _countryGrid.getAreas(lon, lat);
+	for (std::vector<int>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	{
+		if (_countries[*i]->getRules()->insideCountry(lon, lat))
+		{
+			return _countries[*i];
+		}
+	}
+	return 0;
+}
+
+/**
+ * Find the country containing this target.
+ * @param target The target to locate.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(const Target &target) const
+{
+	return locateCountry(target.getLongitude(), target.getLatitude());
+}
+
+/**
+ * Puts the areas of all the countries and regions in the grids used to
+ * locate them. Has to be called after the lists of countries and regions change.
+ */
+void SavedGame::indexAreas()
+{
+	_countryGrid.clear();
+	for (size_t i = 0; i < _countries.size(); ++i)
+	{
+		const RuleCountry *rule = _countries[i]->getRules();
+		for (size_t j = 0; j < rule->getLonMin().size(); ++j)
+		{
+			_countryGrid.addRectangle(i, rule->getLonMin()[j], rule->getLonMax()[j], rule->getLatMin()[j], rule->getLatMax()[j]);
+		}
+	}
+	_regionGrid.clear();
+	for (size_t i = 0; i < _regions.size(); ++i)
+	{
+		const RuleRegion *rule = _regions[i]->getRules();
+		for (size_t j = 0; j < rule->getLonMin().size(); ++j)
+		{
+			_regionGrid.addRectangle(i, rule->getLonMin()[j], rule->getLonMax()[j], rule->getLatMin()[j], rule->getLatMax()[j]);
+		}
+	}
+}
+
 /*
  * @return the month counter.
  */
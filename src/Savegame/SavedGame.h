@@ -22,6 +22,8 @@
 #include <map>
 #include <vector>
 #include <string>
+#include "../Geoscape/PolarGrid.h"
+#include "TargetGrid.h"
 
 namespace OpenXcom
 {
@@ -67,8 +69,10 @@ private:
 	std::map<std::string, int> _ids;
 	std::vector<Country*> _countries;
 	std::vector<Region*> _regions;
+	PolarGrid _countryGrid, _regionGrid;
 	std::vector<Base*> _bases;
 	std::vector<Ufo*> _ufos;
+	TargetGrid _ufoGrid;
 	std::vector<Waypoint*> _waypoints;
 	std::vector<TerrorSite*> _terrorSites;
 	std::vector<AlienBase*> _alienBases;
@@ -139,6 +143,8 @@ public:
 	int getBaseMaintenance() const;
 	/// Gets the list of UFOs.
 	std::vector<Ufo*> *getUfos();
+	/// Gets the spatial hash of the UFOs.
+	TargetGrid *getUfoGrid();
 	/// Gets the list of waypoints.
 	std::vector<Waypoint*> *getWaypoints();
 	/// Gets the list of terror sites.
@@ -201,6 +207,12 @@ public:
 	Region *locateRegion(double lon, double lat) const;
 	/// Locate a region containing a Target.
 	Region *locateRegion(const Target &target) const;
+	/// Locate a country containing a position.
+	Country *locateCountry(double lon, double lat) const;
+	/// Locate a country containing a Target.
+	Country *locateCountry(const Target &target) const;
+	/// Index the areas of the countries and regions for locating.
+	void indexAreas();
 	/// Return the month counter.
 	int getMonthsPassed() const;
 	/// Return the GraphRegionToggles.
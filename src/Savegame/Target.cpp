@@ -21,6 +21,7 @@
 #include <cmath>
 #include "../Engine/Language.h"
 #include "Craft.h"
+#include "TargetGrid.h"
 
 namespace OpenXcom
 {
@@ -28,15 +29,20 @@ namespace OpenXcom
 /**
  * Initializes a target with blank coordinates.
  */
-Target::Target() : _lon(0.0), _lat(0.0), _followers()
+Target::Target() : _grid(0), _gridCell(0), _lon(0.0), _lat(0.0), _followers()
 {
 }
 
 /**
- * Make sure no crafts are chasing this target.
+ * Make sure no crafts are chasing this target,
+ * and no grid is holding on to it.
  */
 Target::~Target()
 {
+	if (_grid)
+	{
+		_grid->remove(this);
+	}
 	for (size_t i = 0; i < _followers.size(); ++i)
 	{
 		Craft *craft = dynamic_cast<Craft*>(_followers[i]);
@@ -101,6 +107,11 @@ void Target::setLongitude(double lon)
 		_lon += 2 * M_PI;
 	while (_lon >= 2 * M_PI)
 		_lon -= 2 * M_PI;
+
+	if (_grid)
+	{
+		_grid->move(this);
+	}
 }
 
 /**
@@ -130,6 +141,10 @@ void Target::setLatitude(double lat)
 		_lat = -M_PI + _lat;
 		setLongitude(_lon - M_PI);
 	}
+	else if (_grid)
+	{
+		_grid->move(this);
+	}
 }
 
 /**
@@ -27,6 +27,7 @@ namespace OpenXcom
 {
 
 class Language;
+class TargetGrid;
 
 /**
  * Base class for targets on the globe
@@ -34,6 +35,10 @@ class Language;
  */
 class Target
 {
+private:
+	friend class TargetGrid;
+	TargetGrid *_grid;
+	int _gridCell;
 protected:
 	double _lon, _lat;
 	std::vector<Target*> _followers;
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include "TargetGrid.h"
+#include "Target.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Sorts the targets found in the grid by the order they were added in.
+ */
+struct FoundOrder
+{
+	bool operator()(const std::pair<unsigned int, Target*> &a, const std::pair<unsigned int, Target*> &b) const
+	{
+		return a.first < b.first;
+	}
+};
+
+}
+
+/**
+ * Creates a grid with no targets in it.
+ */
+TargetGrid::TargetGrid() : _cells(LON_CELLS * LAT_CELLS), _next(0)
+{
+}
+
+/**
+ * Lets the targets still in the grid know they're not anymore.
+ */
+TargetGrid::~TargetGrid()
+{
+	clear();
+}
+
+/**
+ * Gets the cell of the grid holding a position. Works from
+ * the point on the sphere, like Target::getDistance does,
+ * so coordinates past the poles still end up in the right cell.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return Index of the cell.
+ */
+int TargetGrid::getCell(double lon, double lat) const
+{
+	double x = cos(lat) * cos(lon), y = cos(lat) * sin(lon), z = sin(lat);
+	double cellLon = atan2(y, x);
+	if (cellLon < 0)
+		cellLon += 2 * M_PI;
+	double cellLat = asin(std::min(std::max(z, -1.0), 1.0));
+	int column = std::min((int)(cellLon / (2 * M_PI) * LON_CELLS), LON_CELLS - 1);
+	int row = std::min((int)((cellLat + M_PI_2) / M_PI * LAT_CELLS), LAT_CELLS - 1);
+	return row * LON_CELLS + std::max(column, 0);
+}
+
+/**
+ * Takes a target out of the cell it's in.
+ * @param target Pointer to the target.
+ * @return The target's entry.
+ */
+TargetGrid::Entry TargetGrid::take(Target *target)
+{
+	std::vector<Entry> &cell = _cells[target->_gridCell];
+	for (std::vector<Entry>::iterator i = cell.begin(); i != cell.end(); ++i)
+	{
+		if (i->target == target)
+		{
+			Entry entry = *i;
+			cell.erase(i);
+			return entry;
+		}
+	}
+	Entry entry = { target, 0 };
+	return entry;
+}
+
+/**
+ * Adds a target to the grid, after all the ones already in it.
+ * A target can only be in one grid at a time.
+ * @param target Pointer to the target.
+ */
+void TargetGrid::insert(Target *target)
+{
+	if (target->_grid != 0)
+	{
+		target->_grid->remove(target);
+	}
+	Entry entry = { target, _next++ };
+	target->_grid = this;
+	target->_gridCell = getCell(target->getLongitude(), target->getLatitude());
+	_cells[target->_gridCell].push_back(entry);
+}
+
+/**
+ * Removes a target from the grid.
+ * @param target Pointer to the target.
+ */
+void TargetGrid::remove(Target *target)
+{
+	if (target->_grid != this)
+		return;
+	take(target);
+	target->_grid = 0;
+}
+
+/**
+ * Moves a target to the cell of its new position, if that changed.
+ * Called by the target itself when it moves.
+ * @param target Pointer to the target.
+ */
+void TargetGrid::move(Target *target)
+{
+	int cell = getCell(target->getLongitude(), target->getLatitude());
+	if (cell != target->_gridCell)
+	{
+		Entry entry = take(target);
+		target->_gridCell = cell;
+		_cells[cell].push_back(entry);
+	}
+}
+
+/**
+ * Removes all the targets from the grid.
+ */
+void TargetGrid::clear()
+{
+	for (std::vector<std::vector<Entry> >::iterator i = _cells.begin(); i != _cells.end(); ++i)
+	{
+		for (std::vector<Entry>::iterator j = i->begin(); j != i->end(); ++j)
+		{
+			j->target->_grid = 0;
+		}
+		i->clear();
+	}
+	_next = 0;
+}
+
+/**
+ * Finds all the targets in the grid within a distance
+ * of another target, in the order they were added to the grid.
+ * @param center Pointer to the target in the middle.
+ * @param radius Distance in radians, as given by Target::getDistance.
+ * @param found Pointer to the list to put the targets in.
+ */
+void TargetGrid::getNear(const Target *center, double radius, std::vector<Target*> *found) const
+{
+	found->clear();
+	const double cellWidth = 2 * M_PI / LON_CELLS, cellHeight = M_PI / LAT_CELLS;
+	int centerCell = getCell(center->getLongitude(), center->getLatitude());
+	int centerColumn = centerCell % LON_CELLS, centerRow = centerCell / LON_CELLS;
+	double lat = -M_PI_2 + (centerRow + 0.5) * cellHeight;
+
+	// the center is somewhere in its cell, so give it a cell of room
+	int rows = (int)ceil(radius / cellHeight) + 1;
+	int rowMin = std::max(centerRow - rows, 0), rowMax = std::min(centerRow + rows, LAT_CELLS - 1);
+	int columns = LON_CELLS;
+	double farLat = std::fabs(lat) + cellHeight;
+	if (farLat + radius < M_PI_2)
+	{
+		// the widest a cap gets in longitude, if it doesn't reach a pole
+		columns = std::min((int)ceil(asin(sin(radius) / cos(farLat)) / cellWidth) + 1, LON_CELLS);
+	}
+
+	std::vector<std::pair<unsigned int, Target*> > near;
+	for (int row = rowMin; row <= rowMax; ++row)
+	{
+		for (int i = -columns; i <= columns && i < LON_CELLS - columns; ++i)
+		{
+			const std::vector<Entry> &cell = _cells[row * LON_CELLS + (centerColumn + i + LON_CELLS) % LON_CELLS];
+			for (std::vector<Entry>::const_iterator j = cell.begin(); j != cell.end(); ++j)
+			{
+				if (center->getDistance(j->target) <= radius)
+				{
+					near.push_back(std::make_pair(j->order, j->target));
+				}
+			}
+		}
+	}
+	std::sort(near.begin(), near.end(), FoundOrder());
+	for (std::vector<std::pair<unsigned int, Target*> >::iterator i = near.begin(); i != near.end(); ++i)
+	{
+		found->push_back(i->second);
+	}
+}
+
+}
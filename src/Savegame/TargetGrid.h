@@ -0,0 +1,73 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_TARGETGRID_H
+#define OPENXCOM_TARGETGRID_H
+
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Target;
+
+/**
+ * A spatial hash of targets on the globe, splitting the world into cells
+ * of longitude and latitude, so finding the targets around a point
+ * doesn't have to look at all of them.
+ * Targets in the grid tell it themselves when they move or get deleted.
+ * Targets are found in the order they were added to the grid,
+ * so anything using them in turn (like rolling for detection) does it
+ * in the same order as walking the list they came from.
+ */
+class TargetGrid
+{
+private:
+	static const int LON_CELLS = 72;
+	static const int LAT_CELLS = 36;
+	struct Entry
+	{
+		Target *target;
+		unsigned int order;
+	};
+	std::vector<std::vector<Entry> > _cells;
+	unsigned int _next;
+	/// Gets the cell holding a position.
+	int getCell(double lon, double lat) const;
+	/// Takes a target out of its cell.
+	Entry take(Target *target);
+public:
+	/// Creates an empty grid.
+	TargetGrid();
+	/// Cleans up the grid.
+	~TargetGrid();
+	/// Adds a target to the grid.
+	void insert(Target *target);
+	/// Removes a target from the grid.
+	void remove(Target *target);
+	/// Moves a target to the cell of its new position.
+	void move(Target *target);
+	/// Removes all the targets from the grid.
+	void clear();
+	/// Finds the targets within a distance of another one.
+	void getNear(const Target *center, double radius, std::vector<Target*> *found) const;
+};
+
+}
+
+#endif
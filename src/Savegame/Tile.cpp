@@ -28,10 +28,51 @@
 #include "../Ruleset/RuleItem.h"
 #include "../Ruleset/Armor.h"
 #include "SerializationHelper.h"
+#include <algorithm>
 
 namespace OpenXcom
 {
 
+/**
+ * Resizes all the layers to hold a map of the given size and clears them.
+ * @param size Number of tiles on the map.
+ */
+void TileLayers::resize(int size)
+{
+	for (int layer = 0; layer < LIGHTLAYERS; ++layer)
+	{
+		light[layer].assign(size, 0);
+	}
+	smoke.assign(size, 0);
+	fire.assign(size, 0);
+	discovered.assign(size, 0);
+	visible.assign(size, 0);
+	TileThreat empty = {0, Position(), 0, 0, 0, 0};
+	threat.assign(size, empty);
+}
+
+/**
+ * Resets the light amount of a layer on the whole map. This is done before a light level recalculation.
+ * @param layer Light is separated in 3 layers: Ambient, Static and Dynamic.
+ */
+void TileLayers::resetLight(int layer)
+{
+	std::fill(light[layer].begin(), light[layer].end(), 0);
+}
+
+/**
+ * Marks the AI scratch data of the whole map as not calculated,
+ * actual calculations will take place as needed.
+ */
+void TileLayers::resetThreat()
+{
+	for (std::vector<TileThreat>::iterator i = threat.begin(); i != threat.end(); ++i)
+	{
+		i->soldiersVisible = Tile::NOT_CALCULATED;
+		i->closestSoldierDSqr = Tile::NOT_CALCULATED;
+	}
+}
+
 /// How many bytes various fields use in a serialized tile. See header.
 Tile::SerializationKey Tile::serializationKey = 
 {4, // index
@@ -46,8 +87,10 @@ Tile::SerializationKey Tile::serializationKey =
 /**
 * constructor
 * @param pos Position.
+* @param layers The layers holding the rest of the tile data.
+* @param index Index of the tile in the layers.
 */
-Tile::Tile(const Position& pos): _smoke(0), _fire(0),  _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false)
+Tile::Tile(const Position& pos, TileLayers *layers, int index): _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _layers(layers), _index(index)
 {
 	for (int i = 0; i < 4; ++i)
 	{
@@ -56,15 +99,6 @@ Tile::Tile(const Position& pos): _smoke(0), _fire(0),  _explosive(0), _pos(pos),
 		_mapDataSetID[i] = -1;
 		_currentFrame[i] = 0;
 	}
-	for (int layer = 0; layer < LIGHTLAYERS; layer++)
-	{
-		_light[layer] = 0;
-		_lastLight[layer] = -1;
-	}
-	for (int i = 0; i < 3; ++i)
-	{
-		_discovered[i] = false;
-	}
 }
 
 /**
@@ -84,30 +118,30 @@ void Tile::load(const YAML::Node &node)
 	//node["position"] >> _pos;
 	for (int i =0; i < 4; i++)
 	{
-		node["mapDataID"][i] >> _mapDataID[i];
-		node["mapDataSetID"][i] >> _mapDataSetID[i];
+		int id, setId;
+		node["mapDataID"][i] >> id;
+		node["mapDataSetID"][i] >> setId;
+		_mapDataID[i] = id;
+		_mapDataSetID[i] = setId;
 	}
+	int fire = 0, smoke = 0;
 	if(const YAML::Node *pName = node.FindValue("fire"))
 	{
-		*pName >> _fire;
-	}
-	else
-	{
-		_fire = 0;
+		*pName >> fire;
 	}
+	_layers->fire[_index] = fire;
 	if(const YAML::Node *pName = node.FindValue("smoke"))
 	{
-		*pName >> _smoke;
-	}
-	else
-	{
-		_smoke = 0;
+		*pName >> smoke;
 	}
+	_layers->smoke[_index] = smoke;
 	if(const YAML::Node *pName = node.FindValue("discovered"))
 	{
-		(*pName)[0] >> _discovered[0];
-		(*pName)[1] >> _discovered[1];
-		(*pName)[2] >> _discovered[2];
+		bool discovered[3];
+		(*pName)[0] >> discovered[0];
+		(*pName)[1] >> discovered[1];
+		(*pName)[2] >> discovered[2];
+		_layers->discovered[_index] = (discovered[0] ? 1 : 0) | (discovered[1] ? 2 : 0) | (discovered[2] ? 4 : 0);
 	}
 	if (const YAML::Node *pName = node.FindValue("openDoorWest"))
 	{
@@ -134,13 +168,11 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_mapDataSetID[2] = unserializeInt(&buffer, serKey._mapDataSetID);
 	_mapDataSetID[3] = unserializeInt(&buffer, serKey._mapDataSetID);
 
-	_smoke = unserializeInt(&buffer, serKey._smoke);
-	_fire = unserializeInt(&buffer, serKey._fire);
+	_layers->smoke[_index] = unserializeInt(&buffer, serKey._smoke);
+	_layers->fire[_index] = unserializeInt(&buffer, serKey._fire);
 
     Uint8 boolFields = unserializeInt(&buffer, serKey.boolFields);
-	_discovered[0] = (boolFields & 1) ? true : false;
-	_discovered[1] = (boolFields & 2) ? true : false;
-	_discovered[2] = (boolFields & 4) ? true : false;
+	_layers->discovered[_index] = boolFields & 7;
 	_currentFrame[1] = (boolFields & 8) ? 7 : 0;
 	_currentFrame[2] = (boolFields & 0x10) ? 7 : 0;
 }
@@ -158,14 +190,14 @@ void Tile::save(YAML::Emitter &out) const
 	out << YAML::BeginSeq << _mapDataID[0] << _mapDataID[1] << _mapDataID[2] << _mapDataID[3] << YAML::EndSeq;
 	out << YAML::Key << "mapDataSetID" << YAML::Value << YAML::Flow;
 	out << YAML::BeginSeq << _mapDataSetID[0] << _mapDataSetID[1] << _mapDataSetID[2] << _mapDataSetID[3] << YAML::EndSeq;
-	if (_smoke)
-		out << YAML::Key << "smoke" << YAML::Value << _smoke;
-	if (_fire)
-		out << YAML::Key << "fire" << YAML::Value << _fire;
-	if (_discovered[0] || _discovered[1] || _discovered[2])
+	if (getSmoke())
+		out << YAML::Key << "smoke" << YAML::Value << getSmoke();
+	if (getFire())
+		out << YAML::Key << "fire" << YAML::Value << getFire();
+	if (isDiscovered(0) || isDiscovered(1) || isDiscovered(2))
 	{
 		out << YAML::Key << "discovered" << YAML::Value << YAML::Flow;
-		out << YAML::BeginSeq << _discovered[0] << _discovered[1] << _discovered[2] << YAML::EndSeq;
+		out << YAML::BeginSeq << isDiscovered(0) << isDiscovered(1) << isDiscovered(2) << YAML::EndSeq;
 	}
 	if (isUfoDoorOpen(1))
 	{
@@ -192,10 +224,10 @@ void Tile::saveBinary(Uint8** buffer) const
 	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[2]);
 	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[3]);
 
-	serializeInt(buffer, serializationKey._smoke, _smoke);
-	serializeInt(buffer, serializationKey._fire, _fire);
+	serializeInt(buffer, serializationKey._smoke, getSmoke());
+	serializeInt(buffer, serializationKey._fire, getFire());
 
-	Uint8 boolFields = (_discovered[0]?1:0) + (_discovered[1]?2:0) + (_discovered[2]?4:0);
+	Uint8 boolFields = _layers->discovered[_index];
 	boolFields |= isUfoDoorOpen(1) ? 8 : 0; // west
 	boolFields |= isUfoDoorOpen(2) ? 0x10 : 0; // north?
 	serializeInt(buffer, serializationKey.boolFields, boolFields);
@@ -245,7 +277,7 @@ void Tile::getMapData(int *mapDataID, int *mapDataSetID, int part) const
  */
 bool Tile::isVoid() const
 {
-	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && _smoke == 0 && _inventory.size() == 0;
+	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && getSmoke() == 0 && _inventory.size() == 0;
 }
 
 /**
@@ -407,13 +439,16 @@ int Tile::closeUfoDoor()
  */
 void Tile::setDiscovered(bool flag, int part)
 {
-	if (_discovered[part] != flag)
+	Uint8 &discovered = _layers->discovered[_index];
+	if (isDiscovered(part) != flag)
 	{
-		_discovered[part] = flag;
+		if (flag)
+			discovered |= (1 << part);
+		else
+			discovered &= ~(1 << part);
 		if (part == 2 && flag == true)
 		{
-			_discovered[0] = true;
-			_discovered[1] = true;
+			discovered |= 1 | 2;
 		}
 		// if light on tile changes, units and objects on it change light too
 		if (_unit != 0)
@@ -430,7 +465,7 @@ void Tile::setDiscovered(bool flag, int part)
  */
 bool Tile::isDiscovered(int part) const
 {
-	return _discovered[part];
+	return (_layers->discovered[_index] & (1 << part)) != 0;
 }
 
 
@@ -440,8 +475,7 @@ bool Tile::isDiscovered(int part) const
  */
 void Tile::resetLight(int layer)
 {
-	_light[layer] = 0;
-	_lastLight[layer] = _light[layer];
+	_layers->light[layer][_index] = 0;
 }
 
 /**
@@ -451,8 +485,10 @@ void Tile::resetLight(int layer)
  */
 void Tile::addLight(int light, int layer)
 {
-	if (_light[layer] < light)
-		_light[layer] = light;
+	if (light > 255)
+		light = 255;
+	if (_layers->light[layer][_index] < light)
+		_layers->light[layer][_index] = light;
 }
 
 /**
@@ -464,10 +500,10 @@ int Tile::getShade() const
 {
 	int light = 0;
 
-	for (int layer = 0; layer < LIGHTLAYERS; layer++)
+	for (int layer = 0; layer < TileLayers::LIGHTLAYERS; layer++)
 	{
-		if (_light[layer] > light)
-			light = _light[layer];
+		if (_layers->light[layer][_index] > light)
+			light = _layers->light[layer][_index];
 	}
 
 	return 15 - light;
@@ -676,6 +712,20 @@ Surface *Tile::getSprite(int part) const
 	return _objects[part]->getDataset()->getSurfaceset()->getFrame(_objects[part]->getSprite(_currentFrame[part]));
 }
 
+/**
+ * Get the frame number of the sprite of a certain part of the tile,
+ * in the surface set of the part's terrain.
+ * @param part
+ * @return Frame number, or -1 if there is no such part.
+ */
+int Tile::getSpriteFrame(int part) const
+{
+	if (_objects[part] == 0)
+		return -1;
+
+	return _objects[part]->getSprite(_currentFrame[part]);
+}
+
 /**
  * Set a unit on this tile.
  * @param unit
@@ -704,7 +754,7 @@ BattleUnit *Tile::getUnit() const
  */
 void Tile::setFire(int fire)
 {
-	_fire = fire;
+	_layers->fire[_index] = fire;
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -714,7 +764,7 @@ void Tile::setFire(int fire)
  */
 int Tile::getFire() const
 {
-	return _fire;
+	return _layers->fire[_index];
 }
 
 /**
@@ -723,8 +773,9 @@ int Tile::getFire() const
  */
 void Tile::addSmoke(int smoke)
 {
-	_smoke += smoke;
-	if (_smoke > 40) _smoke = 40;
+	smoke += _layers->smoke[_index];
+	if (smoke > 40) smoke = 40;
+	_layers->smoke[_index] = smoke;
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -734,7 +785,7 @@ void Tile::addSmoke(int smoke)
  */
 int Tile::getSmoke() const
 {
-	return _smoke;
+	return _layers->smoke[_index];
 }
 
 /**
@@ -802,11 +853,12 @@ int Tile::getTopItemSprite()
 bool Tile::prepareNewTurn()
 {
 	bool objective = false;
+	Uint8 &smoke = _layers->smoke[_index];
+	Uint16 &fire = _layers->fire[_index];
 
-	_smoke--;
-	if (_smoke < 0) _smoke = 0;
+	if (smoke > 0) smoke--;
 
-	if (_fire == 1)
+	if (fire == 1)
 	{
 		// fire will be finished in this turn
 		// destroy all objects that burned, and try to ignite again
@@ -826,13 +878,12 @@ bool Tile::prepareNewTurn()
 		}
 		else
 		{
-			_fire = 0;
+			fire = 0;
 		}
 	}
-	else
+	else if (fire > 0)
 	{
-		_fire--;
-		if (_fire < 0) _fire = 0;
+		fire--;
 	}
 
 	return objective;
@@ -871,7 +922,7 @@ int Tile::getMarkerColor()
  */
 void Tile::setVisible(int visibility)
 {
-	_visible += visibility;
+	_layers->visible[_index] += visibility;
 }
 
 /**
@@ -879,7 +930,16 @@ void Tile::setVisible(int visibility)
  */
 int Tile::getVisible()
 {
-	return _visible;
+	return _layers->visible[_index];
+}
+
+/**
+ * Get the AI scratch data of this tile.
+ * @return Pointer to the scratch data.
+ */
+TileThreat *Tile::getThreat()
+{
+	return &_layers->threat[_index];
 }
 
 }
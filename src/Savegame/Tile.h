@@ -36,8 +36,44 @@ class BattleUnit;
 class BattleItem;
 class RuleInventory;
 
+/**
+ * Scratch variables for AI, regarding how many soldiers are visible from a square and how close is the closest one.
+ */
+struct TileThreat
+{
+	int closestSoldierDSqr;
+	Position closestSoldierPos;
+	int meanSoldierDSqr;
+	int soldiersVisible;
+	int closestAlienDSqr;
+	int totalExposure;
+};
+
+/**
+ * The per tile data that full map passes sweep over (lighting, smoke and fire,
+ * fog of war, visibility and AI scratch data), kept in dense arrays indexed
+ * like the tiles instead of inside each tile, so those passes are linear scans.
+ */
+struct TileLayers
+{
+	static const int LIGHTLAYERS = 3;
+	std::vector<Uint8> light[LIGHTLAYERS];
+	std::vector<Uint8> smoke;
+	std::vector<Uint16> fire;
+	std::vector<Uint8> discovered;
+	std::vector<int> visible;
+	std::vector<TileThreat> threat;
+	/// Resizes the layers for a new map and clears them.
+	void resize(int size);
+	/// Resets a light layer on the whole map.
+	void resetLight(int layer);
+	/// Resets the AI scratch data on the whole map.
+	void resetThreat();
+};
+
 /**
  * Basic element of which a battle map is build.
+ * The tile itself only holds its terrain, contents and a view into the TileLayers.
  * @sa http://www.ufopaedia.org/index.php?title=MAPS
  */
 class Tile
@@ -55,36 +91,24 @@ public:
 		Uint32 totalBytes; // per structure, including any data not mentioned here and accounting for all array members!
 	} serializationKey;
 
-    // scratch variables for AI, regarding how many soldiers are visible from a square and how close is the closest one:
-	int closestSoldierDSqr;
-	Position closestSoldierPos;
-	int meanSoldierDSqr;
-	int soldiersVisible;
-	int closestAlienDSqr;
-	int totalExposure;
-
 	static const int NOT_CALCULATED = -1;
 
 protected:
-	static const int LIGHTLAYERS = 3;
 	MapData *_objects[4];
-	int _mapDataID[4];
-	int _mapDataSetID[4];
-	int _currentFrame[4];
-	bool _discovered[3];
-	int _light[LIGHTLAYERS], _lastLight[LIGHTLAYERS];
-	int _smoke;
-	int _fire;
+	Sint16 _mapDataID[4];
+	Sint16 _mapDataSetID[4];
+	Uint8 _currentFrame[4];
 	int _explosive;
 	Position _pos;
 	BattleUnit *_unit;
 	std::vector<BattleItem *> _inventory;
 	int _animationOffset;
 	int _markerColor;
-	int _visible;
+	TileLayers *_layers;
+	int _index;
 public:
 	/// Creates a tile.
-	Tile(const Position& pos);
+	Tile(const Position& pos, TileLayers *layers, int index);
 	/// Cleans up a tile.
 	~Tile();
 	/// Load the tile from yaml
@@ -145,6 +169,8 @@ public:
 	void animate();
 	/// Get object sprites.
 	Surface *getSprite(int part) const;
+	/// Get the frame number of an object sprite.
+	int getSpriteFrame(int part) const;
 	/// Set a unit on this tile.
 	void setUnit(BattleUnit *unit, Tile *tileBelow = 0);
 	/// Get the (alive) unit on this tile.
@@ -181,6 +207,8 @@ public:
 	void setVisible(int visibility);
 	/// Get the tile visible flag.
 	int getVisible();
+	/// Get the AI scratch data of this tile.
+	TileThreat *getThreat();
 
 };
 